@@ -164,7 +164,21 @@ SOURCES += src/main.cpp\
     src/print/printdialog.cpp \
     src/route/routestring.cpp \
     src/route/routestringdialog.cpp \
-    src/route/flightplanentrybuilder.cpp
+    src/route/flightplanentrybuilder.cpp \
+    src/mapgui/maplabelplacer.cpp \
+    src/route/routetablemodel.cpp \
+    src/mapgui/mapscreengrid.cpp \
+    src/profile/elevationtilestore.cpp \
+    src/profile/rangemaxindex.cpp \
+    src/search/sqlmodelworker.cpp \
+    src/db/textindex.cpp \
+    src/export/exportformat.cpp \
+    src/export/exportjob.cpp \
+    src/export/geojsonwriter.cpp \
+    src/export/geoexporter.cpp \
+    src/common/htmlinfoloader.cpp \
+    src/common/htmlinfoworker.cpp \
+    src/info/textdocumentfields.cpp
 
 HEADERS  += src/gui/mainwindow.h \
     src/search/columnlist.h \
@@ -232,7 +246,21 @@ HEADERS  += src/gui/mainwindow.h \
     src/print/printdialog.h \
     src/route/routestring.h \
     src/route/routestringdialog.h \
-    src/route/flightplanentrybuilder.h
+    src/route/flightplanentrybuilder.h \
+    src/mapgui/maplabelplacer.h \
+    src/route/routetablemodel.h \
+    src/mapgui/mapscreengrid.h \
+    src/profile/elevationtilestore.h \
+    src/profile/rangemaxindex.h \
+    src/search/sqlmodelworker.h \
+    src/db/textindex.h \
+    src/export/exportformat.h \
+    src/export/exportjob.h \
+    src/export/geojsonwriter.h \
+    src/export/geoexporter.h \
+    src/common/htmlinfoloader.h \
+    src/common/htmlinfoworker.h \
+    src/info/textdocumentfields.h
 
 FORMS    += src/gui/mainwindow.ui \
     src/db/databasedialog.ui \
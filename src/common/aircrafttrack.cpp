@@ -21,15 +21,61 @@
 
 #include <QDataStream>
 #include <QFile>
+#include <QPointF>
 
-AircraftTrack::AircraftTrack()
+#include <cmath>
+
+/* Simplification tolerance in meter for levels 1 and up */
+static const float LEVEL_TOLERANCE_METER[at::TRACK_NUM_LEVELS - 1] = {25.f, 100.f, 500.f, 2500.f};
+
+/* Flags in the first byte of a track file record */
+static const quint8 RECORD_ON_GROUND = 0x01;
+static const quint8 RECORD_ABSOLUTE = 0x02;
+
+/* Append zigzag encoded variable length integer */
+static void writeVarint(QByteArray& buffer, qint64 value)
 {
+  quint64 zigzag = (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+  while(zigzag >= 0x80)
+  {
+    buffer.append(static_cast<char>((zigzag & 0x7f) | 0x80));
+    zigzag >>= 7;
+  }
+  buffer.append(static_cast<char>(zigzag));
+}
 
+/* Read zigzag encoded variable length integer. Returns false if data ends before the value is complete. */
+static bool readVarint(const QByteArray& data, int& offset, qint64& value)
+{
+  quint64 zigzag = 0;
+  int shift = 0;
+  while(offset < data.size() && shift < 64)
+  {
+    quint8 byte = static_cast<quint8>(data.at(offset++));
+    zigzag |= static_cast<quint64>(byte & 0x7f) << shift;
+    if((byte & 0x80) == 0)
+    {
+      value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+      return true;
+    }
+    shift += 7;
+  }
+  return false;
 }
 
-AircraftTrack::~AircraftTrack()
+AircraftTrack::AircraftTrack()
 {
+  // Write buffered records even if no more positions arrive, e.g. when the simulator is paused
+  flushTimer.setInterval(static_cast<int>(FLUSH_INTERVAL_MS));
+  QObject::connect(&flushTimer, &QTimer::timeout, [ = ]()
+  {
+    flushTrackFile();
+  });
+}
 
+AircraftTrack::~AircraftTrack()
+{
+  closeTrackFile();
 }
 
 namespace at {
@@ -50,32 +96,23 @@ QDataStream& operator<<(QDataStream& dataStream, const at::AircraftTrackPos& obj
 
 void AircraftTrack::saveState()
 {
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
-
-  if(trackFile.open(QIODevice::WriteOnly))
-  {
-    QDataStream out(&trackFile);
-    out.setVersion(QDataStream::Qt_5_5);
-
-    out << FILE_MAGIC_NUMBER << FILE_VERSION << *this;
-    trackFile.close();
-  }
-  else
-    qWarning() << "Cannot write track" << trackFile.fileName() << ":" << trackFile.errorString();
+  flushTrackFile();
 }
 
 void AircraftTrack::restoreState()
 {
-  clear();
+  closeTrackFile();
+  chunks.clear();
 
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
-  if(trackFile.exists())
+  bool convert = false;
+  QFile file(atools::settings::Settings::getConfigFilename(".track"));
+  if(file.exists())
   {
-    if(trackFile.open(QIODevice::ReadOnly))
+    if(file.open(QIODevice::ReadOnly))
     {
       quint32 magic;
       quint16 version;
-      QDataStream in(&trackFile);
+      QDataStream in(&file);
       in.setVersion(QDataStream::Qt_5_5);
       in >> magic;
 
@@ -83,36 +120,302 @@ void AircraftTrack::restoreState()
       {
         in >> version;
         if(version == FILE_VERSION)
-          in >> *this;
+        {
+          QByteArray data = file.readAll();
+          int end = readTrackRecords(data, 0);
+          if(end < data.size())
+          {
+            // Remove incomplete record from a crash to allow appending
+            qWarning() << "Track" << file.fileName() << "has incomplete record at" << end + FILE_HEADER_SIZE;
+            file.close();
+            file.resize(end + FILE_HEADER_SIZE);
+          }
+        }
+        else if(version == FILE_VERSION_V1)
+        {
+          readTrackV1(in);
+          convert = true;
+        }
         else
-          qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid version number:" << version;
+          qWarning() << "Cannot read track" << file.fileName() << ". Invalid version number:" << version;
       }
       else
-        qWarning() << "Cannot read track" << trackFile.fileName() << ". Invalid magic number:" << magic;
+        qWarning() << "Cannot read track" << file.fileName() << ". Invalid magic number:" << magic;
 
-      trackFile.close();
+      file.close();
     }
     else
-      qWarning() << "Cannot read track" << trackFile.fileName() << ":" << trackFile.errorString();
+      qWarning() << "Cannot read track" << file.fileName() << ":" << file.errorString();
+  }
+
+  // Open for appending and write all loaded positions if the old format was read
+  openTrackFile(convert || chunks.isEmpty());
+  if(convert)
+  {
+    for(const at::AircraftTrackChunk& chunk : chunks)
+      for(const at::AircraftTrackPos& trackPos : chunk.positions)
+        writeTrackPos(trackPos);
+    flushTrackFile();
   }
 }
 
-bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, bool onGround)
+void AircraftTrack::readTrackV1(QDataStream& in)
+{
+  quint32 num;
+  in >> num;
+  for(quint32 i = 0; i < num && in.status() == QDataStream::Ok; i++)
+  {
+    at::AircraftTrackPos trackPos;
+    in >> trackPos;
+    addTrackPos(trackPos);
+  }
+}
+
+int AircraftTrack::readTrackRecords(const QByteArray& data, int offset)
+{
+  qint64 lonX = 0, latY = 0, altitude = 0;
+  while(offset < data.size())
+  {
+    int recordOffset = offset;
+    quint8 flags = static_cast<quint8>(data.at(offset++));
+
+    qint64 lonXVal, latYVal, altitudeVal;
+    if(!readVarint(data, offset, lonXVal) || !readVarint(data, offset, latYVal) ||
+       !readVarint(data, offset, altitudeVal))
+      // Incomplete record
+      return recordOffset;
+
+    if(flags & RECORD_ABSOLUTE)
+    {
+      lonX = lonXVal;
+      latY = latYVal;
+      altitude = altitudeVal;
+    }
+    else
+    {
+      lonX += lonXVal;
+      latY += latYVal;
+      altitude += altitudeVal;
+    }
+
+    addTrackPos({atools::geo::Pos(static_cast<float>(lonX / COORD_FACTOR),
+                                  static_cast<float>(latY / COORD_FACTOR),
+                                  static_cast<float>(altitude)),
+                 static_cast<bool>(flags & RECORD_ON_GROUND)});
+  }
+  return offset;
+}
+
+void AircraftTrack::openTrackFile(bool truncate)
+{
+  closeTrackFile();
+
+  trackFile = new QFile(atools::settings::Settings::getConfigFilename(".track"));
+  if(trackFile->open(truncate ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::Append))
+  {
+    if(truncate)
+    {
+      QDataStream out(trackFile);
+      out.setVersion(QDataStream::Qt_5_5);
+      out << FILE_MAGIC_NUMBER << FILE_VERSION;
+      trackFile->flush();
+    }
+  }
+  else
+  {
+    qWarning() << "Cannot write track" << trackFile->fileName() << ":" << trackFile->errorString();
+    delete trackFile;
+    trackFile = nullptr;
+  }
+
+  // Start with an absolute position
+  recordsSinceCheckpoint = CHECKPOINT_RECORDS;
+  writeBuffer.clear();
+  if(trackFile != nullptr)
+    flushTimer.start();
+}
+
+void AircraftTrack::closeTrackFile()
+{
+  flushTimer.stop();
+  if(trackFile != nullptr)
+  {
+    flushTrackFile();
+    trackFile->close();
+    delete trackFile;
+    trackFile = nullptr;
+  }
+}
+
+void AircraftTrack::writeTrackPos(const at::AircraftTrackPos& trackPos)
+{
+  if(trackFile == nullptr)
+    return;
+
+  qint32 lonX = static_cast<qint32>(std::round(trackPos.pos.getLonX() * COORD_FACTOR));
+  qint32 latY = static_cast<qint32>(std::round(trackPos.pos.getLatY() * COORD_FACTOR));
+  qint32 altitude = static_cast<qint32>(std::round(trackPos.pos.getAltitude()));
+
+  quint8 flags = trackPos.onGround ? RECORD_ON_GROUND : 0;
+  if(recordsSinceCheckpoint >= CHECKPOINT_RECORDS)
+  {
+    // Write absolute values
+    flags |= RECORD_ABSOLUTE;
+    writeBuffer.append(static_cast<char>(flags));
+    writeVarint(writeBuffer, lonX);
+    writeVarint(writeBuffer, latY);
+    writeVarint(writeBuffer, altitude);
+    recordsSinceCheckpoint = 0;
+  }
+  else
+  {
+    // Write difference to last record
+    writeBuffer.append(static_cast<char>(flags));
+    writeVarint(writeBuffer, static_cast<qint64>(lonX) - lastLonX);
+    writeVarint(writeBuffer, static_cast<qint64>(latY) - lastLatY);
+    writeVarint(writeBuffer, static_cast<qint64>(altitude) - lastAltitude);
+    recordsSinceCheckpoint++;
+  }
+
+  lastLonX = lonX;
+  lastLatY = latY;
+  lastAltitude = altitude;
+}
+
+void AircraftTrack::flushTrackFile()
+{
+  if(trackFile != nullptr && !writeBuffer.isEmpty())
+  {
+    if(trackFile->write(writeBuffer) != writeBuffer.size())
+      qWarning() << "Cannot write track" << trackFile->fileName() << ":" << trackFile->errorString();
+    trackFile->flush();
+    writeBuffer.clear();
+  }
+}
+
+void AircraftTrack::clearTrack()
+{
+  chunks.clear();
+  openTrackFile(true);
+}
+
+void AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, bool onGround)
 {
-  bool pruned = false;
   // Use a larger distance on ground before storing position
   float epsilon = onGround ? atools::geo::Pos::POS_EPSILON_1M : atools::geo::Pos::POS_EPSILON_100M;
 
   if(isEmpty() || !pos.almostEqual(last().pos, epsilon))
   {
-    if(size() > MAX_TRACK_ENTRIES)
+    addTrackPos({pos, onGround});
+    writeTrackPos({pos, onGround});
+  }
+}
+
+void AircraftTrack::addTrackPos(const at::AircraftTrackPos& trackPos)
+{
+  if(chunks.isEmpty() || chunks.last().positions.size() >= CHUNK_SIZE)
+  {
+    if(!chunks.isEmpty())
+    {
+      // Connect the completed chunk with the new one
+      chunks.last().bounding.extend(trackPos.pos);
+      finishChunk(chunks.last());
+    }
+
+    at::AircraftTrackChunk chunk;
+    chunk.positions.reserve(CHUNK_SIZE);
+    chunk.bounding = atools::geo::Rect(trackPos.pos);
+    chunks.append(chunk);
+  }
+  else
+    chunks.last().bounding.extend(trackPos.pos);
+
+  chunks.last().positions.append(trackPos);
+}
+
+void AircraftTrack::finishChunk(at::AircraftTrackChunk& chunk)
+{
+  chunk.simplified.clear();
+  for(int level = 1; level < at::TRACK_NUM_LEVELS; level++)
+    chunk.simplified.append(simplify(chunk.positions, LEVEL_TOLERANCE_METER[level - 1]));
+}
+
+int AircraftTrack::levelForResolution(float meterPerPixel)
+{
+  // Use the coarsest level where the error is still below one pixel
+  int level = 0;
+  for(int i = 0; i < at::TRACK_NUM_LEVELS - 1; i++)
+  {
+    if(LEVEL_TOLERANCE_METER[i] <= meterPerPixel)
+      level = i + 1;
+  }
+  return level;
+}
+
+QVector<int> AircraftTrack::simplify(const QVector<at::AircraftTrackPos>& positions, float toleranceMeter) const
+{
+  QVector<int> retval;
+  if(positions.size() < 3)
+  {
+    for(int i = 0; i < positions.size(); i++)
+      retval.append(i);
+    return retval;
+  }
+
+  // Project positions to a local plane in meter which is accurate enough for short track chunks
+  const float METER_PER_DEG = 111320.f;
+  float lonFactor = METER_PER_DEG *
+                    std::cos(positions.first().pos.getLatY() * static_cast<float>(M_PI) / 180.f);
+  QVector<QPointF> points;
+  points.reserve(positions.size());
+  for(const at::AircraftTrackPos& trackPos : positions)
+    points.append(QPointF(trackPos.pos.getLonX() * lonFactor, trackPos.pos.getLatY() * METER_PER_DEG));
+
+  QVector<bool> keep(positions.size(), false);
+  keep[0] = true;
+  keep[positions.size() - 1] = true;
+
+  // Use a stack of index ranges instead of recursion
+  QVector<std::pair<int, int> > stack;
+  stack.append(std::make_pair(0, positions.size() - 1));
+
+  while(!stack.isEmpty())
+  {
+    std::pair<int, int> range = stack.takeLast();
+    const QPointF& p1 = points.at(range.first);
+    const QPointF& p2 = points.at(range.second);
+    QPointF dir = p2 - p1;
+    double length = std::sqrt(dir.x() * dir.x() + dir.y() * dir.y());
+
+    // Find point with the largest distance to the line between range ends
+    double maxDist = 0.;
+    int maxIndex = -1;
+    for(int i = range.first + 1; i < range.second; i++)
     {
-      for(int i = 0; i < PRUNE_TRACK_ENTRIES; i++)
-        removeFirst();
-      pruned = true;
+      QPointF v = points.at(i) - p1;
+      double dist;
+      if(length > 0.)
+        dist = std::abs(dir.x() * v.y() - dir.y() * v.x()) / length;
+      else
+        dist = std::sqrt(v.x() * v.x() + v.y() * v.y());
+
+      if(dist > maxDist)
+      {
+        maxDist = dist;
+        maxIndex = i;
+      }
     }
 
-    append({pos, onGround});
+    if(maxIndex != -1 && maxDist > toleranceMeter)
+    {
+      keep[maxIndex] = true;
+      stack.append(std::make_pair(range.first, maxIndex));
+      stack.append(std::make_pair(maxIndex, range.second));
+    }
   }
-  return pruned;
+
+  for(int i = 0; i < keep.size(); i++)
+    if(keep.at(i))
+      retval.append(i);
+  return retval;
 }
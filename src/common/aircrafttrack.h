@@ -19,6 +19,12 @@
 #define LITTLENAVMAP_AIRCRAFTTRACK_H
 
 #include "geo/pos.h"
+#include "geo/rect.h"
+
+#include <QTimer>
+#include <QVector>
+
+class QFile;
 
 namespace at {
 /* Track position. Can be converted to QVariant and thus be saved to settings */
@@ -31,52 +37,164 @@ struct AircraftTrackPos
 QDataStream& operator>>(QDataStream& dataStream, at::AircraftTrackPos& obj);
 QDataStream& operator<<(QDataStream& dataStream, const at::AircraftTrackPos& obj);
 
+/* Number of simplification levels including the full resolution level 0 */
+static Q_DECL_CONSTEXPR int TRACK_NUM_LEVELS = 5;
+
+/*
+ * A part of the track with a fixed number of positions. Completed chunks keep simplified
+ * versions of the positions for lower zoom levels.
+ */
+struct AircraftTrackChunk
+{
+  QVector<AircraftTrackPos> positions;
+
+  /* Bounding rectangle of all positions including the first position of the next chunk */
+  atools::geo::Rect bounding;
+
+  /* Indexes into positions for levels 1 and up. Empty if chunk is not completed yet. */
+  QVector<QVector<int> > simplified;
+
+  /* Number of positions for a simplification level */
+  int size(int level) const
+  {
+    return level == 0 || simplified.isEmpty() ? positions.size() : simplified.at(level - 1).size();
+  }
+
+  /* Get position for a simplification level */
+  const AircraftTrackPos& at(int level, int index) const
+  {
+    return level == 0 || simplified.isEmpty() ? positions.at(index) :
+           positions.at(simplified.at(level - 1).at(index));
+  }
+
+};
+
 }
 
 Q_DECLARE_TYPEINFO(at::AircraftTrackPos, Q_PRIMITIVE_TYPE);
 Q_DECLARE_METATYPE(at::AircraftTrackPos);
+Q_DECLARE_TYPEINFO(at::AircraftTrackChunk, Q_MOVABLE_TYPE);
 
 /*
- * Stores the track of the flight simulator aircraft
+ * Stores the track of the flight simulator aircraft.
+ *
+ * Positions are kept in chunks of fixed size without any limit on the total number. Completed chunks
+ * get a bounding rectangle and Douglas-Peucker simplified versions for several tolerances which allows
+ * painters to skip invisible chunks and to select the level matching the current zoom.
+ *
+ * The track file is append only and written while positions arrive. Each record contains a flag byte
+ * and zigzag varint encoded deltas of longitude, latitude (1/100000 degree) and altitude (feet) to the
+ * previous record. Absolute checkpoint records are written periodically. Pending records are flushed
+ * after a few seconds.
  */
-class AircraftTrack :
-  private QList<at::AircraftTrackPos>
+class AircraftTrack
 {
 public:
   AircraftTrack();
   ~AircraftTrack();
 
-  /* Saves and restores track into a separate file (little_navmap.track) */
+  /* Flushes pending positions to the track file (little_navmap.track) */
   void saveState();
+
+  /* Reads the track file and opens it for appending. Files of the old format are converted. */
   void restoreState();
 
-  void clearTrack()
-  {
-    clear();
-  }
+  void clearTrack();
 
   /*
    * Add a track position. Accurracy depends on the ground flag which will cause more
    * or less points skipped.
-   * @return true if the track was pruned
    */
-  bool appendTrackPos(const atools::geo::Pos& pos, bool onGround);
+  void appendTrackPos(const atools::geo::Pos& pos, bool onGround);
+
+  bool isEmpty() const
+  {
+    return chunks.isEmpty();
+  }
+
+  /* Total number of positions */
+  int size() const
+  {
+    return chunks.isEmpty() ? 0 : (chunks.size() - 1) * CHUNK_SIZE + chunks.last().positions.size();
+  }
 
-  /* Pull only needed methods into public space */
-  using QList::isEmpty;
-  using QList::first;
-  using QList::last;
-  using QList::size;
-  using QList::at;
+  /* Get position by index for the full resolution track */
+  const at::AircraftTrackPos& at(int index) const
+  {
+    return chunks.at(index / CHUNK_SIZE).positions.at(index % CHUNK_SIZE);
+  }
+
+  const at::AircraftTrackPos& first() const
+  {
+    return chunks.first().positions.first();
+  }
+
+  const at::AircraftTrackPos& last() const
+  {
+    return chunks.last().positions.last();
+  }
+
+  const QVector<at::AircraftTrackChunk>& getChunks() const
+  {
+    return chunks;
+  }
+
+  /* Get the simplification level that fits the given map resolution */
+  static int levelForResolution(float meterPerPixel);
 
 private:
-  /* Maximum number of track points. If exceeded entries will be removed from beginning of the list */
-  static Q_DECL_CONSTEXPR int MAX_TRACK_ENTRIES = 10000;
-  /* Number of entries to remove at once */
-  static Q_DECL_CONSTEXPR int PRUNE_TRACK_ENTRIES = 200;
+  Q_DISABLE_COPY(AircraftTrack)
+
+  /* Append position without any checks and start a new chunk if needed */
+  void addTrackPos(const at::AircraftTrackPos& trackPos);
+
+  /* Read old format version 1 file which is a serialized QList */
+  void readTrackV1(QDataStream& in);
+
+  /* Read records. Returns offset of the end of the last valid record in data. */
+  int readTrackRecords(const QByteArray& data, int offset);
+
+  /* Open file for appending. Truncates the file and writes a header if truncate is true. */
+  void openTrackFile(bool truncate);
+  void closeTrackFile();
+
+  /* Encode position into the write buffer. Buffer is flushed by the timer. */
+  void writeTrackPos(const at::AircraftTrackPos& trackPos);
+  void flushTrackFile();
+
+  /* Calculate simplified levels for a completed chunk */
+  void finishChunk(at::AircraftTrackChunk& chunk);
+
+  /* Douglas-Peucker simplification. Returns indexes of the positions to keep. */
+  QVector<int> simplify(const QVector<at::AircraftTrackPos>& positions, float toleranceMeter) const;
+
+  /* Number of positions in each chunk */
+  static Q_DECL_CONSTEXPR int CHUNK_SIZE = 512;
+
+  static Q_DECL_CONSTEXPR quint32 FILE_MAGIC_NUMBER = 0x5B6C1A2B;
+  static Q_DECL_CONSTEXPR quint16 FILE_VERSION_V1 = 1;
+  static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 2;
+
+  /* Size of magic number and version */
+  static Q_DECL_CONSTEXPR int FILE_HEADER_SIZE = 6;
+
+  /* Write an absolute position record after this number of delta records */
+  static Q_DECL_CONSTEXPR int CHECKPOINT_RECORDS = 256;
+
+  /* Flush written records periodically with this interval */
+  static Q_DECL_CONSTEXPR qint64 FLUSH_INTERVAL_MS = 3000;
+
+  /* Coordinate resolution of file records */
+  static Q_DECL_CONSTEXPR double COORD_FACTOR = 100000.;
+
+  QVector<at::AircraftTrackChunk> chunks;
 
-  static Q_DECL_CONSTEXPR quint32 FILE_MAGIC_NUMBER= 0x5B6C1A2B;
-  static Q_DECL_CONSTEXPR quint16 FILE_VERSION= 1;
+  /* Track file state */
+  QFile *trackFile = nullptr;
+  QByteArray writeBuffer;
+  QTimer flushTimer;
+  qint32 lastLonX = 0, lastLatY = 0, lastAltitude = 0;
+  int recordsSinceCheckpoint = CHECKPOINT_RECORDS;
 };
 
 #endif // LITTLENAVMAP_AIRCRAFTTRACK_H
@@ -77,6 +77,7 @@ const QString SEARCHTAB_NAV_VIEW_DIST_WIDGET = "SearchPaneNav/WidgetDistView";
 const QString OPTIONS_DIALOG_WIDGET = "OptionsDialog/Widget";
 const QString OPTIONS_DIALOG_AS_FILE_DLG = "OptionsDialog/WeatherFileDialogAsn";
 const QString OPTIONS_DIALOG_DB_FILE_DLG = "OptionsDialog/DatabaseFileDialog";
+const QString OPTIONS_DIALOG_ELEVATION_DIR_DLG = "OptionsDialog/ElevationDirectoryDialog";
 const QString OPTIONS_DIALOG_DB_EXCLUDE = "OptionsDialog/DatabaseExclude";
 const QString OPTIONS_DIALOG_DB_ADDON_EXCLUDE = "OptionsDialog/DatabaseAddonExclude";
 
@@ -98,6 +99,8 @@ const QString FILE_PATTERN_KML = "(*.kml *.KML *.kmz *.KMZ)";
 const QString FILE_PATTERN_AS_SNAPSHOT = "(current_wx_snapshot.txt)";
 
 const QString FILE_PATTERN_IMAGE = "(*.jpg *.jpeg *.png *.bmp)";
+const QString FILE_PATTERN_GEOJSON = "(*.geojson *.json)";
+const QString FILE_PATTERN_BINARY_EXPORT = "(*.lnmb)";
 
 /* Sqlite database names */
 const QString DATABASE_DIR = "little_navmap_db";
@@ -33,6 +33,7 @@
 #include "util/htmlbuilder.h"
 #include "util/morsecode.h"
 
+#include <QHash>
 #include <QSize>
 
 using namespace maptypes;
@@ -53,6 +54,141 @@ const int SYMBOL_SIZE = 20;
 Q_DECLARE_FLAGS(RunwayMarkingFlags, atools::fs::bgl::rw::RunwayMarkings);
 Q_DECLARE_OPERATORS_FOR_FLAGS(RunwayMarkingFlags);
 
+const QString InfoFields::BOLD_CHARACTERS = QString::fromUtf8("▲▼◄►");
+
+/*
+ * Receives the aircraft texts. Writes HTML if a builder is given or appends layout and values to the
+ * fields otherwise.
+ */
+class InfoOutput
+{
+public:
+  InfoOutput(HtmlBuilder *htmlBuilder, InfoFields *infoFields)
+    : html(htmlBuilder), fields(infoFields)
+  {
+  }
+
+  /* Table row. Arrows in value are shown in bold. */
+  void row2(const QString& name, const QString& value)
+  {
+    if(html != nullptr)
+      html->row2(name, boldCharacters(value));
+    else
+    {
+      fields->layout.append(name);
+      fields->values.append(value);
+    }
+  }
+
+  void a(const QString& text, const QString& href)
+  {
+    if(html != nullptr)
+      html->a(text, href);
+    else
+    {
+      fields->layout.append(text);
+      fields->links.append(href);
+    }
+  }
+
+  void img(const QString& src, const QString& alt, const QSize& size)
+  {
+    if(html != nullptr)
+      html->img(src, alt, QString(), size);
+    else
+      // Icon data is too long for the layout - the hash is sufficient to detect changes
+      layout("img", alt + QString::number(qHash(src)));
+  }
+
+  void text(const QString& text, Flags flags = Flags())
+  {
+    if(html != nullptr)
+      html->text(text, flags);
+    else
+      layout("text", text);
+  }
+
+  void b(const QString& text)
+  {
+    if(html != nullptr)
+      html->b(text);
+    else
+      layout("b", text);
+  }
+
+  void h4(const QString& text, Flags flags = Flags())
+  {
+    if(html != nullptr)
+      html->h4(text, flags);
+    else
+      layout("h4", text);
+  }
+
+  void nbsp()
+  {
+    if(html != nullptr)
+      html->nbsp();
+    else
+      layout("nbsp");
+  }
+
+  void p()
+  {
+    if(html != nullptr)
+      html->p();
+    else
+      layout("p");
+  }
+
+  void pEnd()
+  {
+    if(html != nullptr)
+      html->pEnd();
+    else
+      layout("/p");
+  }
+
+  void table()
+  {
+    if(html != nullptr)
+      html->table();
+    else
+      layout("table");
+  }
+
+  void tableEnd()
+  {
+    if(html != nullptr)
+      html->tableEnd();
+    else
+      layout("/table");
+  }
+
+private:
+  void layout(const QString& tag, const QString& text = QString())
+  {
+    fields->layout.append(tag);
+    if(!text.isEmpty())
+      fields->layout.append(text);
+  }
+
+  static QString boldCharacters(const QString& value)
+  {
+    QString retval;
+    for(QChar c : value)
+    {
+      if(InfoFields::BOLD_CHARACTERS.contains(c))
+        retval += QString("<b>") + c + "</b>";
+      else
+        retval += c;
+    }
+    return retval;
+  }
+
+  HtmlBuilder *html;
+  InfoFields *fields;
+};
+
 HtmlInfoBuilder::HtmlInfoBuilder(MapQuery *mapDbQuery, InfoQuery *infoDbQuery, bool formatInfo,
                                  bool formatPrint)
   : mapQuery(mapDbQuery), infoQuery(infoDbQuery), info(formatInfo), print(formatPrint)
@@ -114,7 +250,8 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, HtmlBuilder& html,
   html.br();
 
   QString city, state, country;
-  mapQuery->getAirportAdminNamesById(airport.id, city, state, country);
+  if(mapQuery != nullptr)
+    mapQuery->getAirportAdminNamesById(airport.id, city, state, country);
 
   html.table();
   if(routeMapObjects != nullptr && !routeMapObjects->isEmpty() && airport.routeIndex != -1)
@@ -129,10 +266,13 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, HtmlBuilder& html,
   }
 
   // Administrative information
-  html.row2(tr("City:"), city);
-  if(!state.isEmpty())
-    html.row2(tr("State or Province:"), state);
-  html.row2(tr("Country:"), country);
+  if(mapQuery != nullptr)
+  {
+    html.row2(tr("City:"), city);
+    if(!state.isEmpty())
+      html.row2(tr("State or Province:"), state);
+    html.row2(tr("Country:"), country);
+  }
   html.row2(tr("Altitude:"), locale.toString(airport.getPosition().getAltitude(), 'f', 0) + tr(" ft"));
   html.row2(tr("Magvar:"), maptypes::magvarText(airport.magvar));
   if(rec != nullptr)
@@ -358,6 +498,12 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, HtmlBuilder& html,
     addScenery(rec, html);
 }
 
+void HtmlInfoBuilder::loadingText(const MapAirport& airport, HtmlBuilder& html, QColor background) const
+{
+  airportTitle(airport, html, background);
+  html.p(tr("Loading ..."));
+}
+
 void HtmlInfoBuilder::comText(const MapAirport& airport, HtmlBuilder& html, QColor background) const
 {
   if(info && infoQuery != nullptr)
@@ -741,7 +887,8 @@ void HtmlInfoBuilder::waypointText(const MapWaypoint& waypoint, HtmlBuilder& htm
   html.tableEnd();
 
   QList<MapAirway> airways;
-  mapQuery->getAirwaysForWaypoint(airways, waypoint.id);
+  if(mapQuery != nullptr)
+    mapQuery->getAirwaysForWaypoint(airways, waypoint.id);
 
   if(!airways.isEmpty())
   {
@@ -860,9 +1007,54 @@ void HtmlInfoBuilder::userpointText(const MapUserpoint& userpoint, HtmlBuilder&
 void HtmlInfoBuilder::aircraftText(const atools::fs::sc::SimConnectAircraft& aircraft,
                                    HtmlBuilder& html, int num, int total) const
 {
-  aircraftTitle(aircraft, html);
+  InfoOutput out(&html, nullptr);
+  aircraftTextInternal(aircraft, out, num, total);
+}
 
-  html.nbsp().nbsp();
+void HtmlInfoBuilder::aircraftText(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                   InfoFields& fields, int num, int total) const
+{
+  InfoOutput out(nullptr, &fields);
+  aircraftTextInternal(aircraft, out, num, total);
+}
+
+void HtmlInfoBuilder::aircraftTextWeightAndFuel(const atools::fs::sc::SimConnectUserAircraft& userAircraft,
+                                                HtmlBuilder& html) const
+{
+  InfoOutput out(&html, nullptr);
+  aircraftTextWeightAndFuelInternal(userAircraft, out);
+}
+
+void HtmlInfoBuilder::aircraftTextWeightAndFuel(const atools::fs::sc::SimConnectUserAircraft& userAircraft,
+                                                InfoFields& fields) const
+{
+  InfoOutput out(nullptr, &fields);
+  aircraftTextWeightAndFuelInternal(userAircraft, out);
+}
+
+void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                           HtmlBuilder& html,
+                                           const RouteMapObjectList& rmoList) const
+{
+  InfoOutput out(&html, nullptr);
+  aircraftProgressTextInternal(aircraft, out, rmoList);
+}
+
+void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                           InfoFields& fields,
+                                           const RouteMapObjectList& rmoList) const
+{
+  InfoOutput out(nullptr, &fields);
+  aircraftProgressTextInternal(aircraft, out, rmoList);
+}
+
+void HtmlInfoBuilder::aircraftTextInternal(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                           InfoOutput& out, int num, int total) const
+{
+  aircraftTitle(aircraft, out);
+
+  out.nbsp();
+  out.nbsp();
   QString aircraftText;
   if(aircraft.isUser())
     aircraftText = tr("User Aircraft");
@@ -874,68 +1066,68 @@ void HtmlInfoBuilder::aircraftText(const atools::fs::sc::SimConnectAircraft& air
       aircraftText = tr("AI / Multiplayer Aircraft");
   }
 
-  head(html, aircraftText);
+  head(out, aircraftText);
 
-  html.table();
+  out.table();
   if(!aircraft.getAirplaneTitle().isEmpty())
-    html.row2(tr("Title:"), aircraft.getAirplaneTitle());
+    out.row2(tr("Title:"), aircraft.getAirplaneTitle());
 
   if(!aircraft.getAirplaneAirline().isEmpty())
-    html.row2(tr("Airline:"), aircraft.getAirplaneAirline());
+    out.row2(tr("Airline:"), aircraft.getAirplaneAirline());
 
   if(!aircraft.getAirplaneFlightnumber().isEmpty())
-    html.row2(tr("Flight Number:"), aircraft.getAirplaneFlightnumber());
+    out.row2(tr("Flight Number:"), aircraft.getAirplaneFlightnumber());
 
   if(!aircraft.getAirplaneModel().isEmpty())
-    html.row2(tr("Model:"), aircraft.getAirplaneModel());
+    out.row2(tr("Model:"), aircraft.getAirplaneModel());
 
   if(!aircraft.getAirplaneRegistration().isEmpty())
-    html.row2(tr("Registration:"), aircraft.getAirplaneRegistration());
+    out.row2(tr("Registration:"), aircraft.getAirplaneRegistration());
 
   if(!aircraft.getAirplaneType().isEmpty())
-    html.row2(tr("Type:"), aircraft.getAirplaneType());
+    out.row2(tr("Type:"), aircraft.getAirplaneType());
 
   if(info && aircraft.getWingSpan() > 0)
-    html.row2(tr("Wingspan:"), locale.toString(aircraft.getWingSpan()) + tr(" ft"));
-  html.tableEnd();
+    out.row2(tr("Wingspan:"), locale.toString(aircraft.getWingSpan()) + tr(" ft"));
+  out.tableEnd();
 }
 
-void HtmlInfoBuilder::aircraftTextWeightAndFuel(const atools::fs::sc::SimConnectUserAircraft& userAircraft,
-                                                HtmlBuilder& html) const
+void HtmlInfoBuilder::aircraftTextWeightAndFuelInternal(
+  const atools::fs::sc::SimConnectUserAircraft& userAircraft, InfoOutput& out) const
 {
   if(info)
   {
-    head(html, tr("Weight and Fuel"));
-    html.table();
-    html.row2(tr("Max Gross Weight:"), locale.toString(
-                userAircraft.getAirplaneMaxGrossWeightLbs(), 'f', 0) + tr(" lbs"));
-    html.row2(tr("Gross Weight:"),
-              locale.toString(userAircraft.getAirplaneTotalWeightLbs(), 'f', 0) + tr(" lbs"));
-    html.row2(tr("Empty Weight:"),
-              locale.toString(userAircraft.getAirplaneEmptyWeightLbs(), 'f', 0) + tr(" lbs"));
-
-    html.row2(tr("Fuel:"), locale.toString(userAircraft.getFuelTotalWeightLbs(), 'f', 0) + tr(" lbs, ") +
-              locale.toString(userAircraft.getFuelTotalQuantityGallons(), 'f', 0) + tr(" gallons"));
-    html.tableEnd();
+    head(out, tr("Weight and Fuel"));
+    out.table();
+    out.row2(tr("Max Gross Weight:"), locale.toString(
+               userAircraft.getAirplaneMaxGrossWeightLbs(), 'f', 0) + tr(" lbs"));
+    out.row2(tr("Gross Weight:"),
+             locale.toString(userAircraft.getAirplaneTotalWeightLbs(), 'f', 0) + tr(" lbs"));
+    out.row2(tr("Empty Weight:"),
+             locale.toString(userAircraft.getAirplaneEmptyWeightLbs(), 'f', 0) + tr(" lbs"));
+
+    out.row2(tr("Fuel:"), locale.toString(userAircraft.getFuelTotalWeightLbs(), 'f', 0) + tr(" lbs, ") +
+             locale.toString(userAircraft.getFuelTotalQuantityGallons(), 'f', 0) + tr(" gallons"));
+    out.tableEnd();
   }
 }
 
-void HtmlInfoBuilder::timeAndDate(const SimConnectUserAircraft *userAircaft, HtmlBuilder& html) const
+void HtmlInfoBuilder::timeAndDate(const SimConnectUserAircraft *userAircaft, InfoOutput& out) const
 {
-  html.row2(tr("Time and Date:"), locale.toString(userAircaft->getLocalTime(), QLocale::ShortFormat) +
-            tr(" ") + userAircaft->getLocalTime().timeZoneAbbreviation() + tr(", ") +
-            locale.toString(userAircaft->getZuluTime().time(), QLocale::ShortFormat) +
-            " " + userAircaft->getZuluTime().timeZoneAbbreviation());
+  out.row2(tr("Time and Date:"), locale.toString(userAircaft->getLocalTime(), QLocale::ShortFormat) +
+           tr(" ") + userAircaft->getLocalTime().timeZoneAbbreviation() + tr(", ") +
+           locale.toString(userAircaft->getZuluTime().time(), QLocale::ShortFormat) +
+           " " + userAircaft->getZuluTime().timeZoneAbbreviation());
 }
 
-void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircraft& aircraft,
-                                           HtmlBuilder& html,
-                                           const RouteMapObjectList& rmoList) const
+void HtmlInfoBuilder::aircraftProgressTextInternal(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                                   InfoOutput& out,
+                                                   const RouteMapObjectList& rmoList) const
 {
   const SimConnectUserAircraft *userAircaft = dynamic_cast<const SimConnectUserAircraft *>(&aircraft);
 
   if(info && userAircaft != nullptr)
-    aircraftTitle(aircraft, html);
+    aircraftTitle(aircraft, out);
 
   float distFromStartNm = 0.f, distToDestNm = 0.f, nearestLegDistance = 0.f, crossTrackDistance = 0.f;
   int nearestLegIndex;
@@ -946,43 +1138,43 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
                                  &distFromStartNm, &distToDestNm, &nearestLegDistance, &crossTrackDistance,
                                  &nearestLegIndex))
     {
-      head(html, tr("Flight Plan Progress"));
-      html.table();
-      // html.row2("Distance from Start:", locale.toString(distFromStartNm, 'f', 0) + tr(" nm"));
-      html.row2(tr("To Destination:"), locale.toString(distToDestNm, 'f', 0) + tr(" nm"));
+      head(out, tr("Flight Plan Progress"));
+      out.table();
+      // out.row2("Distance from Start:", locale.toString(distFromStartNm, 'f', 0) + tr(" nm"));
+      out.row2(tr("To Destination:"), locale.toString(distToDestNm, 'f', 0) + tr(" nm"));
 
-      timeAndDate(userAircaft, html);
+      timeAndDate(userAircaft, out);
 
       if(aircraft.getGroundSpeedKts() > 20.f)
       {
         float timeToDestination = distToDestNm / aircraft.getGroundSpeedKts();
         QDateTime arrival = userAircaft->getZuluTime().addSecs(static_cast<int>(timeToDestination * 3600.f));
-        html.row2(tr("Arrival Time:"), locale.toString(arrival.time(), QLocale::ShortFormat) + " " +
-                  arrival.timeZoneAbbreviation());
-        html.row2(tr("En route Time:"), formatter::formatMinutesHoursLong(timeToDestination));
+        out.row2(tr("Arrival Time:"), locale.toString(arrival.time(), QLocale::ShortFormat) + " " +
+                 arrival.timeZoneAbbreviation());
+        out.row2(tr("En route Time:"), formatter::formatMinutesHoursLong(timeToDestination));
       }
-      html.tableEnd();
+      out.tableEnd();
 
-      head(html, tr("Next Waypoint"));
-      html.table();
+      head(out, tr("Next Waypoint"));
+      out.table();
 
       if(nearestLegIndex >= 0 && nearestLegIndex < rmoList.size())
       {
         const RouteMapObject& rmo = rmoList.at(nearestLegIndex);
         float crs = normalizeCourse(aircraft.getPosition().angleDegToRhumb(rmo.getPosition()) - rmo.getMagvar());
-        html.row2(tr("Name and Type:"), rmo.getIdent() +
-                  (rmo.getMapObjectTypeName().isEmpty() ? QString() : tr(", ") + rmo.getMapObjectTypeName()));
+        out.row2(tr("Name and Type:"), rmo.getIdent() +
+                 (rmo.getMapObjectTypeName().isEmpty() ? QString() : tr(", ") + rmo.getMapObjectTypeName()));
 
         QString timeStr;
         if(aircraft.getGroundSpeedKts() > 20.f)
           timeStr = tr(", ") + formatter::formatMinutesHoursLong(
             nearestLegDistance / aircraft.getGroundSpeedKts());
 
-        html.row2(tr("Distance, Course and Time:"), locale.toString(nearestLegDistance, 'f', 0) + tr(
-                    " nm, ") +
-                  locale.toString(crs, 'f', 0) +
-                  tr("°M") + timeStr);
-        html.row2(tr("Leg Course:"), locale.toString(rmo.getCourseToRhumb(), 'f', 0) + tr("°M"));
+        out.row2(tr("Distance, Course and Time:"), locale.toString(nearestLegDistance, 'f', 0) + tr(
+                   " nm, ") +
+                 locale.toString(crs, 'f', 0) +
+                 tr("°M") + timeStr);
+        out.row2(tr("Leg Course:"), locale.toString(rmo.getCourseToRhumb(), 'f', 0) + tr("°M"));
       }
       else
         qWarning() << "Invalid route leg index" << nearestLegIndex;
@@ -992,84 +1184,84 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
         int ctd = atools::roundToPrecision(crossTrackDistance * 10.f);
         QString crossDirection;
         if(ctd >= 1)
-          crossDirection = tr("<b>►</b>");
+          crossDirection = tr("►");
         else if(ctd <= -1)
-          crossDirection = tr("<b>◄</b>");
+          crossDirection = tr("◄");
 
-        html.row2(tr("Cross Track Distance:"),
-                  locale.toString(std::abs(ctd / 10.f), 'f', 1) + tr(" nm ") + crossDirection);
+        out.row2(tr("Cross Track Distance:"),
+                 locale.toString(std::abs(ctd / 10.f), 'f', 1) + tr(" nm ") + crossDirection);
       }
       else
-        html.row2(tr("Cross Track Distance:"), tr("Not along Track"));
-      html.tableEnd();
+        out.row2(tr("Cross Track Distance:"), tr("Not along Track"));
+      out.tableEnd();
     }
     else
-      html.h4(tr("No Active Flight Plan Leg found."), atools::util::html::BOLD);
+      out.h4(tr("No Active Flight Plan Leg found."), atools::util::html::BOLD);
   }
   else if(info && userAircaft != nullptr)
   {
-    head(html, tr("No Flight Plan loaded."));
-    html.table();
-    timeAndDate(userAircaft, html);
-    html.tableEnd();
+    head(out, tr("No Flight Plan loaded."));
+    out.table();
+    timeAndDate(userAircaft, out);
+    out.tableEnd();
   }
 
   if(userAircaft == nullptr && (!aircraft.getFromIdent().isEmpty() || !aircraft.getToIdent().isEmpty()))
   {
     // Add departure and destination for AI
     if(info && userAircaft != nullptr)
-      head(html, tr("Flight Plan"));
+      head(out, tr("Flight Plan"));
 
     if(!aircraft.getFromIdent().isEmpty())
     {
-      html.p();
-      html.b(tr("Departure: "));
+      out.p();
+      out.b(tr("Departure: "));
       if(info)
-        html.a(aircraft.getFromIdent(), QString("lnm://show?airport=%1").arg(aircraft.getFromIdent()));
+        out.a(aircraft.getFromIdent(), QString("lnm://show?airport=%1").arg(aircraft.getFromIdent()));
       else
-        html.text(aircraft.getFromIdent());
-      html.text(tr(". "));
+        out.text(aircraft.getFromIdent());
+      out.text(tr(". "));
     }
 
     if(!aircraft.getToIdent().isEmpty())
     {
-      html.b(tr("Destination: "));
+      out.b(tr("Destination: "));
       if(info)
-        html.a(aircraft.getToIdent(), QString("lnm://show?airport=%1").arg(aircraft.getToIdent()));
+        out.a(aircraft.getToIdent(), QString("lnm://show?airport=%1").arg(aircraft.getToIdent()));
       else
-        html.text(aircraft.getToIdent());
-      html.text(tr("."));
-      html.pEnd();
+        out.text(aircraft.getToIdent());
+      out.text(tr("."));
+      out.pEnd();
     }
   }
 
-  head(html, tr("Aircraft"));
-  html.table();
-  html.row2(tr("Heading:"), locale.toString(aircraft.getHeadingDegMag(), 'f', 0) + tr("°M, ") +
-            locale.toString(aircraft.getHeadingDegTrue(), 'f', 0) + tr("°T"));
+  head(out, tr("Aircraft"));
+  out.table();
+  out.row2(tr("Heading:"), locale.toString(aircraft.getHeadingDegMag(), 'f', 0) + tr("°M, ") +
+           locale.toString(aircraft.getHeadingDegTrue(), 'f', 0) + tr("°T"));
 
   if(userAircaft != nullptr && info)
   {
     if(userAircaft != nullptr)
-      html.row2(tr("Track:"), locale.toString(userAircaft->getTrackDegMag(), 'f', 0) + tr("°M, ") +
-                locale.toString(userAircaft->getTrackDegTrue(), 'f', 0) + tr("°T"));
+      out.row2(tr("Track:"), locale.toString(userAircaft->getTrackDegMag(), 'f', 0) + tr("°M, ") +
+               locale.toString(userAircaft->getTrackDegTrue(), 'f', 0) + tr("°T"));
 
-    html.row2(tr("Fuel Flow:"), locale.toString(userAircaft->getFuelFlowPPH(), 'f', 0) + tr(" pph, ") +
-              locale.toString(userAircaft->getFuelFlowGPH(), 'f', 0) + tr(" gph, "));
+    out.row2(tr("Fuel Flow:"), locale.toString(userAircaft->getFuelFlowPPH(), 'f', 0) + tr(" pph, ") +
+             locale.toString(userAircaft->getFuelFlowGPH(), 'f', 0) + tr(" gph, "));
 
     if(userAircaft->getFuelFlowPPH() > 1.0f && aircraft.getGroundSpeedKts() > 20.f)
     {
       float hoursRemaining = userAircaft->getFuelTotalWeightLbs() / userAircaft->getFuelFlowPPH();
       float distanceRemaining = hoursRemaining * aircraft.getGroundSpeedKts();
-      html.row2(tr("Endurance:"), formatter::formatMinutesHoursLong(hoursRemaining) + tr(", ") +
-                locale.toString(distanceRemaining, 'f', 0) + tr(" nm"));
+      out.row2(tr("Endurance:"), formatter::formatMinutesHoursLong(hoursRemaining) + tr(", ") +
+               locale.toString(distanceRemaining, 'f', 0) + tr(" nm"));
     }
 
     if(distToDestNm > 1.f && userAircaft->getFuelFlowPPH() > 1.f && userAircaft->getGroundSpeedKts() > 20.f)
     {
       float neededFuel = distToDestNm / aircraft.getGroundSpeedKts() * userAircaft->getFuelFlowPPH();
-      html.row2(tr("Fuel at Destination:"),
-                locale.toString(userAircaft->getFuelTotalWeightLbs() - neededFuel, 'f', 0) + tr(" lbs"));
+      out.row2(tr("Fuel at Destination:"),
+               locale.toString(userAircaft->getFuelTotalWeightLbs() - neededFuel, 'f', 0) + tr(" lbs"));
     }
 
     QString ice;
@@ -1085,67 +1277,67 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
     if(ice.isEmpty())
       ice = tr("None");
 
-    html.row2(tr("Ice:"), ice);
+    out.row2(tr("Ice:"), ice);
   }
-  html.tableEnd();
+  out.tableEnd();
 
   if(info)
-    head(html, tr("Altitude"));
-  html.table();
+    head(out, tr("Altitude"));
+  out.table();
   if(info)
-    html.row2(tr("Indicated:"), locale.toString(aircraft.getIndicatedAltitudeFt(), 'f', 0) + tr(" ft"));
-  html.row2(info ? tr("Actual:") : tr("Altitude:"),
-            locale.toString(aircraft.getPosition().getAltitude(), 'f', 0) + tr(" ft"));
+    out.row2(tr("Indicated:"), locale.toString(aircraft.getIndicatedAltitudeFt(), 'f', 0) + tr(" ft"));
+  out.row2(info ? tr("Actual:") : tr("Altitude:"),
+           locale.toString(aircraft.getPosition().getAltitude(), 'f', 0) + tr(" ft"));
 
   if(userAircaft != nullptr && info)
   {
-    html.row2(tr("Above Ground:"),
-              locale.toString(userAircaft->getAltitudeAboveGroundFt(), 'f', 0) + tr(" ft"));
-    html.row2(tr("Ground Elevation:"), locale.toString(userAircaft->getGroundAltitudeFt(), 'f', 0) + tr(" ft"));
+    out.row2(tr("Above Ground:"),
+             locale.toString(userAircaft->getAltitudeAboveGroundFt(), 'f', 0) + tr(" ft"));
+    out.row2(tr("Ground Elevation:"), locale.toString(userAircaft->getGroundAltitudeFt(), 'f', 0) + tr(" ft"));
   }
-  html.tableEnd();
+  out.tableEnd();
 
   if(info)
-    head(html, tr("Speed"));
-  html.table();
+    head(out, tr("Speed"));
+  out.table();
   if(info)
-    html.row2(tr("Indicated:"), locale.toString(aircraft.getIndicatedSpeedKts(), 'f', 0) + tr(" kts"));
+    out.row2(tr("Indicated:"), locale.toString(aircraft.getIndicatedSpeedKts(), 'f', 0) + tr(" kts"));
 
-  html.row2(info ? tr("Ground:") : tr("Groundspeed:"),
-            locale.toString(aircraft.getGroundSpeedKts(), 'f', 0) + tr(" kts"));
+  out.row2(info ? tr("Ground:") : tr("Groundspeed:"),
+           locale.toString(aircraft.getGroundSpeedKts(), 'f', 0) + tr(" kts"));
   if(info)
-    html.row2(tr("True Airspeed:"), locale.toString(aircraft.getTrueSpeedKts(), 'f', 0) + tr(" kts"));
+    out.row2(tr("True Airspeed:"), locale.toString(aircraft.getTrueSpeedKts(), 'f', 0) + tr(" kts"));
 
   if(info)
   {
     float mach = aircraft.getMachSpeed();
     if(mach > 0.4f)
-      html.row2(tr("Mach:"), locale.toString(mach, 'f', 2));
+      out.row2(tr("Mach:"), locale.toString(mach, 'f', 2));
     else
-      html.row2(tr("Mach:"), tr("-"));
+      out.row2(tr("Mach:"), tr("-"));
   }
 
   int vspeed = atools::roundToPrecision(aircraft.getVerticalSpeedFeetPerMin());
   QString upDown;
   if(vspeed >= 100)
-    upDown = tr(" <b>▲</b>");
+    upDown = tr(" ▲");
   else if(vspeed <= -100)
-    upDown = tr(" <b>▼</b>");
-  html.row2(info ? tr("Vertical:") : tr("Vertical Speed:"),
-            locale.toString(vspeed) + tr(" ft/min ") + upDown);
-  html.tableEnd();
+    upDown = tr(" ▼");
+  out.row2(info ? tr("Vertical:") : tr("Vertical Speed:"),
+           locale.toString(vspeed) + tr(" ft/min ") + upDown);
+  out.tableEnd();
 
   if(userAircaft != nullptr && info)
   {
-    head(html, tr("Environment"));
-    html.table();
+    head(out, tr("Environment"));
+    out.table();
     float windSpeed = userAircaft->getWindSpeedKts();
     float windDir = normalizeCourse(userAircaft->getWindDirectionDegT() - userAircaft->getMagVarDeg());
     if(windSpeed >= 1.f)
-      html.row2(tr("Wind Direction and Speed:"), locale.toString(windDir, 'f', 0) + tr("°M, ") +
-                locale.toString(windSpeed, 'f', 0) + tr(" kts"));
+      out.row2(tr("Wind Direction and Speed:"), locale.toString(windDir, 'f', 0) + tr("°M, ") +
+               locale.toString(windSpeed, 'f', 0) + tr(" kts"));
     else
-      html.row2(tr("Wind Direction and Speed:"), tr("None"));
+      out.row2(tr("Wind Direction and Speed:"), tr("None"));
 
     float diffRad = atools::geo::toRadians(windDir - userAircaft->getHeadingDegMag());
     float headWind = windSpeed * std::cos(diffRad);
@@ -1157,9 +1349,9 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
       value += locale.toString(std::abs(headWind), 'f', 0) + tr(" kts ");
 
       if(headWind <= -1.f)
-        value += tr("<b>▲</b>");  // Tailwind
+        value += tr("▲");  // Tailwind
       else
-        value += tr("<b>▼</b>");  // Headwind
+        value += tr("▼");  // Headwind
     }
 
     if(std::abs(crossWind) >= 1.0f)
@@ -1170,25 +1362,25 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
       value += locale.toString(std::abs(crossWind), 'f', 0) + tr(" kts ");
 
       if(crossWind >= 1.f)
-        value += tr("<b>◄</b>");
+        value += tr("◄");
       else if(crossWind <= -1.f)
-        value += tr("<b>►</b>");
+        value += tr("►");
 
     }
 
-    html.row2(QString(), value);
+    out.row2(QString(), value);
 
     float temp = userAircaft->getTotalAirTemperatureCelsius();
-    html.row2(tr("Total Air Temperature:"), locale.toString(temp, 'f', 0) + tr("°C, ") +
-              locale.toString(atools::geo::degCToDegF(temp), 'f', 0) + tr("°F"));
+    out.row2(tr("Total Air Temperature:"), locale.toString(temp, 'f', 0) + tr("°C, ") +
+             locale.toString(atools::geo::degCToDegF(temp), 'f', 0) + tr("°F"));
 
     temp = userAircaft->getAmbientTemperatureCelsius();
-    html.row2(tr("Static Air Temperature:"), locale.toString(temp, 'f', 0) + tr("°C, ") +
-              locale.toString(atools::geo::degCToDegF(temp), 'f', 0) + tr("°F"));
+    out.row2(tr("Static Air Temperature:"), locale.toString(temp, 'f', 0) + tr("°C, ") +
+             locale.toString(atools::geo::degCToDegF(temp), 'f', 0) + tr("°F"));
 
     float slp = userAircaft->getSeaLevelPressureMbar();
-    html.row2(tr("Sea Level Pressure:"), locale.toString(slp, 'f', 0) + tr(" mbar, ") +
-              locale.toString(atools::geo::mbarToInHg(slp), 'f', 2) + tr(" inHg"));
+    out.row2(tr("Sea Level Pressure:"), locale.toString(slp, 'f', 0) + tr(" mbar, ") +
+             locale.toString(atools::geo::mbarToInHg(slp), 'f', 2) + tr(" inHg"));
 
     QStringList precip;
     // if(data.getFlags() & atools::fs::sc::IN_CLOUD) // too unreliable
@@ -1199,7 +1391,7 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
       precip.append(tr("Snow"));
     if(precip.isEmpty())
       precip.append(tr("None"));
-    html.row2(tr("Conditions:"), precip.join(tr(", ")));
+    out.row2(tr("Conditions:"), precip.join(tr(", ")));
 
     float visibilityMeter = userAircaft->getAmbientVisibilityMeter();
     float visibilityNm = atools::geo::meterToNm(visibilityMeter);
@@ -1211,25 +1403,25 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
         atools::roundToPrecision(visibilityMeter, visibilityMeter > 1000 ? 2 : 1)) + tr(" m");
 
     if(visibilityNm > 20.f)
-      html.row2(tr("Visibility:"), tr("> 20 nm"));
+      out.row2(tr("Visibility:"), tr("> 20 nm"));
     else
-      html.row2(tr("Visibility:"), locale.toString(visibilityNm, 'f', visibilityNm < 5 ? 1 : 0) + tr(
-                  " nm, ") +
-                visibilityMeterStr);
+      out.row2(tr("Visibility:"), locale.toString(visibilityNm, 'f', visibilityNm < 5 ? 1 : 0) + tr(
+                 " nm, ") +
+               visibilityMeterStr);
 
-    html.tableEnd();
+    out.tableEnd();
   }
 
   if(info)
   {
-    head(html, tr("Position"));
-    html.row2(tr("Coordinates:"), aircraft.getPosition().toHumanReadableString());
-    html.tableEnd();
+    head(out, tr("Position"));
+    out.table();
+    out.row2(tr("Coordinates:"), aircraft.getPosition().toHumanReadableString());
+    out.tableEnd();
   }
 }
 
-void HtmlInfoBuilder::aircraftTitle(const atools::fs::sc::SimConnectAircraft& aircraft,
-                                    HtmlBuilder& html) const
+void HtmlInfoBuilder::aircraftTitle(const atools::fs::sc::SimConnectAircraft& aircraft, InfoOutput& out) const
 {
   const QString *icon;
 
@@ -1249,10 +1441,11 @@ void HtmlInfoBuilder::aircraftTitle(const atools::fs::sc::SimConnectAircraft& ai
   }
 
   if(aircraft.isUser())
-    html.img(*icon, tr("User Aircraft"), QString(), QSize(24, 24));
+    out.img(*icon, tr("User Aircraft"), QSize(24, 24));
   else
-    html.img(*icon, tr("AI / Multiplayer Aircraft"), QString(), QSize(24, 24));
-  html.nbsp().nbsp();
+    out.img(*icon, tr("AI / Multiplayer Aircraft"), QSize(24, 24));
+  out.nbsp();
+  out.nbsp();
 
   QString title(aircraft.getAirplaneRegistration());
 
@@ -1266,13 +1459,14 @@ void HtmlInfoBuilder::aircraftTitle(const atools::fs::sc::SimConnectAircraft& ai
   if(!title2.isEmpty())
     title += " (" + title2 + ")";
 
-  html.text(title, atools::util::html::BOLD | atools::util::html::BIG);
+  out.text(title, atools::util::html::BOLD | atools::util::html::BIG);
 
   if(info)
   {
-    html.nbsp().nbsp();
-    html.a(tr("Map"), QString("lnm://show?lonx=%1&laty=%2").
-           arg(aircraft.getPosition().getLonX()).arg(aircraft.getPosition().getLatY()));
+    out.nbsp();
+    out.nbsp();
+    out.a(tr("Map"), QString("lnm://show?lonx=%1&laty=%2").
+          arg(aircraft.getPosition().getLonX()).arg(aircraft.getPosition().getLatY()));
   }
 }
 
@@ -1305,6 +1499,14 @@ void HtmlInfoBuilder::head(HtmlBuilder& html, const QString& text) const
     html.b(text);
 }
 
+void HtmlInfoBuilder::head(InfoOutput& out, const QString& text) const
+{
+  if(info)
+    out.h4(text);
+  else
+    out.b(text);
+}
+
 void HtmlInfoBuilder::title(HtmlBuilder& html, const QString& text) const
 {
   if(info)
@@ -22,6 +22,7 @@
 
 #include <QCoreApplication>
 #include <QLocale>
+#include <QStringList>
 
 class RouteMapObject;
 class MapQuery;
@@ -68,6 +69,27 @@ class MorseCode;
 }
 }
 
+class InfoOutput;
+
+/*
+ * Layout and values of an aircraft text. Built instead of HTML to update a document that was
+ * created from the HTML of the same layout. See TextDocumentFields.
+ */
+struct InfoFields
+{
+  /* Heads, row names and all other static texts in order of appearance */
+  QStringList layout;
+
+  /* Texts of the table value cells in order of appearance */
+  QStringList values;
+
+  /* Link targets in order of appearance */
+  QStringList links;
+
+  /* Characters in values which are shown in bold (arrows) */
+  static const QString BOLD_CHARACTERS;
+};
+
 /*
  * Builds HTML snippets (no <html> and no <body> tags) for QTextEdits or tooltips.
  */
@@ -77,8 +99,9 @@ class HtmlInfoBuilder
 
 public:
   /*
-   * @param mapDbQuery Initialized database query object
-   * @param infoDbQuery Initialized database query object
+   * @param mapDbQuery Initialized database query object. Can be null to build a preliminary text
+   * without database access.
+   * @param infoDbQuery Initialized database query object. Can be null.
    * @param formatInfo true if this should generate HTML for QTextEdits or QWebBrowser
    * (i.e. generate alternating background color for tables)
    */
@@ -107,6 +130,15 @@ public:
   void runwayText(const maptypes::MapAirport& airport, atools::util::HtmlBuilder& html,
                   QColor background, bool details = true, bool soft = true) const;
 
+  /*
+   * Creates an airport title with a note to be shown while the airport records are loaded.
+   * @param airport
+   * @param html Result containing HTML snippet
+   * @param background Background color for icons
+   */
+  void loadingText(const maptypes::MapAirport& airport, atools::util::HtmlBuilder& html,
+                   QColor background) const;
+
   /*
    * Creates a HTML description for all COM frequencies of an airport.
    * @param airport
@@ -210,6 +242,15 @@ public:
                             atools::util::HtmlBuilder& html,
                             const RouteMapObjectList& rmoList) const;
 
+  /* Same as above but append layout and values to fields instead of building HTML */
+  void aircraftText(const atools::fs::sc::SimConnectAircraft& userAircraft,
+                    InfoFields& fields, int num = -1, int total = -1) const;
+  void aircraftTextWeightAndFuel(const atools::fs::sc::SimConnectUserAircraft& userAircraft,
+                                 InfoFields& fields) const;
+  void aircraftProgressText(const atools::fs::sc::SimConnectAircraft& data,
+                            InfoFields& fields,
+                            const RouteMapObjectList& rmoList) const;
+
 private:
   void addScenery(const atools::sql::SqlRecord *rec, atools::util::HtmlBuilder& html) const;
   void addCoordinates(const atools::sql::SqlRecord *rec, atools::util::HtmlBuilder& html) const;
@@ -238,11 +279,18 @@ private:
   void rowForStrCap(atools::util::HtmlBuilder& html, const atools::sql::SqlRecord *rec,
                     const QString& colName, const QString& msg, const QString& val) const;
 
-  void aircraftTitle(const atools::fs::sc::SimConnectAircraft& aircraft,
-                     atools::util::HtmlBuilder& html) const;
+  void aircraftTextInternal(const atools::fs::sc::SimConnectAircraft& aircraft,
+                            InfoOutput& out, int num, int total) const;
+  void aircraftTextWeightAndFuelInternal(const atools::fs::sc::SimConnectUserAircraft& userAircraft,
+                                         InfoOutput& out) const;
+  void aircraftProgressTextInternal(const atools::fs::sc::SimConnectAircraft& aircraft,
+                                    InfoOutput& out, const RouteMapObjectList& rmoList) const;
+
+  void aircraftTitle(const atools::fs::sc::SimConnectAircraft& aircraft, InfoOutput& out) const;
+
+  void timeAndDate(const atools::fs::sc::SimConnectUserAircraft *userAircaft, InfoOutput& out) const;
 
-  void timeAndDate(const atools::fs::sc::SimConnectUserAircraft *userAircaft,
-                   atools::util::HtmlBuilder& html) const;
+  void head(InfoOutput& out, const QString& text) const;
 
   MapQuery *mapQuery;
   InfoQuery *infoQuery;
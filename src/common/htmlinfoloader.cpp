@@ -0,0 +1,133 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "common/htmlinfoloader.h"
+
+#include "info/infoquery.h"
+#include "mapgui/mapquery.h"
+#include "sql/sqldatabase.h"
+
+#include <QSqlDatabase>
+
+HtmlInfoLoader::HtmlInfoLoader(QObject *parent, atools::sql::SqlDatabase *sqlDb, MapQuery *mapDbQuery,
+                               InfoQuery *infoDbQuery)
+  : QObject(parent), db(sqlDb), mapQuery(mapDbQuery), infoQuery(infoDbQuery)
+{
+  qRegisterMetaType<HtmlInfoRecords>("HtmlInfoRecords");
+  qRegisterMetaType<maptypes::MapObjectRefList>("maptypes::MapObjectRefList");
+
+  // Worker lives in its own thread and is deleted when the thread stops
+  worker = new HtmlInfoWorker(&latestRequestId);
+  worker->moveToThread(&workerThread);
+  connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+
+  // Calls into the worker thread are queued
+  connect(this, &HtmlInfoLoader::fetchRecordsInWorker, worker, &HtmlInfoWorker::fetchRecords);
+  connect(this, &HtmlInfoLoader::closeDatabaseInWorker, worker, &HtmlInfoWorker::closeDatabase,
+          Qt::BlockingQueuedConnection);
+
+  connect(worker, &HtmlInfoWorker::recordsAvailable, this, &HtmlInfoLoader::recordsAvailable);
+
+  workerThread.start();
+}
+
+HtmlInfoLoader::~HtmlInfoLoader()
+{
+  cancel();
+  workerThread.quit();
+  workerThread.wait();
+}
+
+bool HtmlInfoLoader::load(const maptypes::MapObjectRefList& refs)
+{
+  if(refs.isEmpty() || refs == loadedRefs ||
+     (mapQuery->hasRecords(refs) && (infoQuery == nullptr || infoQuery->hasRecords(refs))))
+  {
+    // Everything is available - a pending request for other objects is not needed anymore
+    cancel();
+    return true;
+  }
+
+  if(loading && refs == requestedRefs)
+    // Same objects are already loading - e.g. tooltip update for weather changes
+    return false;
+
+  requestedRefs = refs;
+  loadedRefs.clear();
+
+  currentRequestId++;
+  latestRequestId.storeRelease(currentRequestId);
+  loading = true;
+
+  QSqlDatabase sqlDb = db->getQSqlDatabase();
+  emit fetchRecordsInWorker(currentRequestId, sqlDb.driverName(), sqlDb.databaseName(), refs,
+                            infoQuery != nullptr);
+  return false;
+}
+
+void HtmlInfoLoader::cancel()
+{
+  if(loading)
+  {
+    // Worker will notice the changed id and drop the request
+    currentRequestId++;
+    latestRequestId.storeRelease(currentRequestId);
+    loading = false;
+    requestedRefs.clear();
+  }
+}
+
+void HtmlInfoLoader::preDatabaseLoad()
+{
+  cancel();
+  loadedRefs.clear();
+
+  // Release the database file
+  emit closeDatabaseInWorker();
+}
+
+void HtmlInfoLoader::recordsAvailable(int requestId, const HtmlInfoRecords& records)
+{
+  if(requestId != currentRequestId)
+    // Superseded by a newer request
+    return;
+
+  mapQuery->insertRecords(records.mapRecords);
+  if(infoQuery != nullptr)
+    infoQuery->insertRecords(records.infoRecords);
+
+  loading = false;
+  loadedRefs = requestedRefs;
+  requestedRefs.clear();
+
+  emit recordsLoaded();
+}
+
+maptypes::MapObjectRefList HtmlInfoLoader::objectRefs(const maptypes::MapSearchResult& result)
+{
+  maptypes::MapObjectRefList refs;
+  for(const maptypes::MapAirport& airport : result.airports)
+    refs.append({airport.id, maptypes::AIRPORT});
+  for(const maptypes::MapVor& vor : result.vors)
+    refs.append({vor.id, maptypes::VOR});
+  for(const maptypes::MapNdb& ndb : result.ndbs)
+    refs.append({ndb.id, maptypes::NDB});
+  for(const maptypes::MapWaypoint& waypoint : result.waypoints)
+    refs.append({waypoint.id, maptypes::WAYPOINT});
+  return refs;
+}
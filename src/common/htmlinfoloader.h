@@ -0,0 +1,111 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_HTMLINFOLOADER_H
+#define LITTLENAVMAP_HTMLINFOLOADER_H
+
+#include "common/htmlinfoworker.h"
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QThread>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+class MapQuery;
+class InfoQuery;
+
+/*
+ * Loads the database records needed by the HtmlInfoBuilder in a background HtmlInfoWorker and copies them
+ * into the caches of the MapQuery and InfoQuery of the GUI thread.
+ *
+ * Tooltips and the information panel show a preliminary text built from cached data only and build
+ * the full HTML once recordsLoaded is emitted. Then all records are taken from the caches.
+ * A new request supersedes all pending ones.
+ */
+class HtmlInfoLoader :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /*
+   * @param sqlDb database of the GUI thread. Only used to get driver and file name for the worker.
+   * @param mapDbQuery receives the MapQuery records
+   * @param infoDbQuery receives the InfoQuery records. Can be null if only tooltips are built.
+   */
+  HtmlInfoLoader(QObject *parent, atools::sql::SqlDatabase *sqlDb, MapQuery *mapDbQuery,
+                 InfoQuery *infoDbQuery);
+  virtual ~HtmlInfoLoader();
+
+  /*
+   * Check the caches for all records needed to describe the objects and start loading if anything
+   * is missing. recordsLoaded is emitted when done.
+   * @return true if the full HTML can be built now without running queries in the GUI thread
+   */
+  bool load(const maptypes::MapObjectRefList& refs);
+
+  /* Drop the pending request if any */
+  void cancel();
+
+  /* true if a request is pending */
+  bool isLoading() const
+  {
+    return loading;
+  }
+
+  /* Drop requests and disconnect the worker from the database */
+  void preDatabaseLoad();
+
+  /* Get airports, VORs, NDBs and waypoints of the result that might need database records */
+  static maptypes::MapObjectRefList objectRefs(const maptypes::MapSearchResult& result);
+
+signals:
+  /* Records of the latest request are in the caches now */
+  void recordsLoaded();
+
+  /* Calls into the worker thread */
+  void fetchRecordsInWorker(int requestId, const QString& driverName, const QString& databaseName,
+                            const maptypes::MapObjectRefList& refs, bool info);
+  void closeDatabaseInWorker();
+
+private:
+  void recordsAvailable(int requestId, const HtmlInfoRecords& records);
+
+  atools::sql::SqlDatabase *db;
+  MapQuery *mapQuery;
+  InfoQuery *infoQuery;
+
+  /* Objects of the pending request and of the last loaded request. The latter are not loaded again
+   * in case a cache dropped some of the records. */
+  maptypes::MapObjectRefList requestedRefs, loadedRefs;
+
+  /* Id of the pending request. Also read by worker. */
+  QAtomicInt latestRequestId;
+  int currentRequestId = 0;
+  bool loading = false;
+
+  QThread workerThread;
+  HtmlInfoWorker *worker = nullptr;
+};
+
+#endif // LITTLENAVMAP_HTMLINFOLOADER_H
@@ -0,0 +1,121 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "common/htmlinfoworker.h"
+
+#include "exception.h"
+#include "sql/sqldatabase.h"
+
+#include <QDebug>
+
+using atools::sql::SqlDatabase;
+
+HtmlInfoWorker::HtmlInfoWorker(const QAtomicInt *latestRequestIdParam)
+  : latestRequestId(latestRequestIdParam)
+{
+  connectionName = QString("HtmlInfoWorker-%1").arg(reinterpret_cast<quintptr>(this));
+}
+
+HtmlInfoWorker::~HtmlInfoWorker()
+{
+  closeDatabase();
+}
+
+void HtmlInfoWorker::closeDatabase()
+{
+  delete mapQuery;
+  mapQuery = nullptr;
+  delete infoQuery;
+  infoQuery = nullptr;
+
+  if(db != nullptr)
+  {
+    db->close();
+    delete db;
+    db = nullptr;
+    SqlDatabase::removeDatabase(connectionName);
+  }
+  currentDatabaseName.clear();
+}
+
+bool HtmlInfoWorker::openDatabase(const QString& driverName, const QString& databaseName)
+{
+  if(db != nullptr && currentDatabaseName == databaseName)
+    return true;
+
+  closeDatabase();
+
+  try
+  {
+    // Connection has to be created in this thread
+    db = new SqlDatabase(SqlDatabase::addDatabase(driverName, connectionName));
+    db->setDatabaseName(databaseName);
+    db->open({"PRAGMA query_only = ON"});
+
+    mapQuery = new MapQuery(nullptr, db);
+    mapQuery->initQueries();
+    infoQuery = new InfoQuery(nullptr, db);
+    infoQuery->initQueries();
+    currentDatabaseName = databaseName;
+  }
+  catch(atools::Exception& e)
+  {
+    qWarning() << "Cannot open database" << databaseName << "for info worker:" << e.what();
+    closeDatabase();
+    return false;
+  }
+  return true;
+}
+
+bool HtmlInfoWorker::isSuperseded(int requestId) const
+{
+  return requestId != latestRequestId->loadAcquire();
+}
+
+void HtmlInfoWorker::fetchRecords(int requestId, const QString& driverName, const QString& databaseName,
+                                  const maptypes::MapObjectRefList& refs, bool info)
+{
+  if(isSuperseded(requestId))
+    return;
+
+  HtmlInfoRecords records;
+  if(openDatabase(driverName, databaseName))
+  {
+    try
+    {
+      for(const maptypes::MapObjectRef& ref : refs)
+      {
+        if(isSuperseded(requestId))
+          // Mouse has moved on or another object was selected
+          return;
+
+        mapQuery->fetchRecords({ref}, records.mapRecords);
+        if(info)
+          infoQuery->fetchRecords({ref}, records.infoRecords);
+      }
+    }
+    catch(atools::Exception& e)
+    {
+      qWarning() << "Info worker query failed:" << e.what();
+    }
+  }
+
+  // Records are incomplete on errors - the GUI thread will query anything missing itself
+  if(!isSuperseded(requestId))
+    emit recordsAvailable(requestId, records);
+}
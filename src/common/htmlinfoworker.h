@@ -0,0 +1,92 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_HTMLINFOWORKER_H
+#define LITTLENAVMAP_HTMLINFOWORKER_H
+
+#include "common/maptypes.h"
+#include "info/infoquery.h"
+#include "mapgui/mapquery.h"
+
+#include <QAtomicInt>
+#include <QObject>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/* Query results sent back by the HtmlInfoWorker */
+struct HtmlInfoRecords
+{
+  MapQueryRecords mapRecords;
+  InfoQueryRecords infoRecords;
+};
+
+Q_DECLARE_METATYPE(HtmlInfoRecords);
+Q_DECLARE_METATYPE(maptypes::MapObjectRefList);
+
+/*
+ * Runs the database queries needed by the HtmlInfoBuilder in a background thread using its own database
+ * connection, MapQuery and InfoQuery. The HTML is still built in the GUI thread since it contains
+ * icons that are painted on pixmaps.
+ * All slots have to be called by queued connections.
+ *
+ * Every request has an id. A request is dropped as soon as a newer one is started which is detected
+ * by comparing the id with the shared latest request id.
+ */
+class HtmlInfoWorker :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /*
+   * @param latestRequestIdParam id of the latest request started by the loader. Owned by the loader.
+   */
+  HtmlInfoWorker(const QAtomicInt *latestRequestIdParam);
+  virtual ~HtmlInfoWorker();
+
+  /* Fetch all records needed to describe the objects in refs and send them back. Records might be
+   * incomplete if the database cannot be opened or a query fails.
+   * Opens the database if it is not open yet or if the database name has changed.
+   * @param info fetch the records for the information panel too */
+  void fetchRecords(int requestId, const QString& driverName, const QString& databaseName,
+                    const maptypes::MapObjectRefList& refs, bool info);
+
+  /* Close queries and database connection. Needed before the database file is replaced. */
+  void closeDatabase();
+
+signals:
+  /* Sent when all records for a request are fetched */
+  void recordsAvailable(int requestId, const HtmlInfoRecords& records);
+
+private:
+  bool openDatabase(const QString& driverName, const QString& databaseName);
+  bool isSuperseded(int requestId) const;
+
+  const QAtomicInt *latestRequestId;
+
+  QString connectionName, currentDatabaseName;
+  atools::sql::SqlDatabase *db = nullptr;
+  MapQuery *mapQuery = nullptr;
+  InfoQuery *infoQuery = nullptr;
+};
+
+#endif // LITTLENAVMAP_HTMLINFOWORKER_H
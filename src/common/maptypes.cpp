@@ -537,6 +537,25 @@ QString airwayText(const MapAirway& airway)
   return QObject::tr("Airway %1").arg(airway.name);
 }
 
+QString airwayLabelText(const MapAirway& airway, bool info)
+{
+  QString text(airway.name);
+  if(info)
+  {
+    text += QObject::tr(" / ") + airwayTypeToShortString(airway.type);
+    if(airway.minAltitude)
+      text += QObject::tr(" / ") + QLocale().toString(airway.minAltitude) + QObject::tr(" ft");
+  }
+  return text;
+}
+
+quint64 airwayWaypointKey(const MapAirway& airway)
+{
+  quint32 id1 = static_cast<quint32>(std::min(airway.fromWaypointId, airway.toWaypointId));
+  quint32 id2 = static_cast<quint32>(std::max(airway.fromWaypointId, airway.toWaypointId));
+  return (static_cast<quint64>(id1) << 32) | id2;
+}
+
 QString airportText(const MapAirport& airport)
 {
   return QObject::tr("Airport %1 (%2)").arg(airport.name).arg(airport.ident);
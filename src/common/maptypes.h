@@ -25,6 +25,7 @@
 #include "fs/sc/simconnectuseraircraft.h"
 
 #include <QColor>
+#include <QHash>
 #include <QString>
 
 /*
@@ -419,6 +420,7 @@ struct MapAirway
       fragment /* fragment number of disconnected airways with the same name */;
   atools::geo::Pos from, to;
   atools::geo::Rect bounding; /* pre calculated using from and to */
+  int labelIndex = -1; /* Index into the airway label list. Only valid for airways from the map cache */
 
   atools::geo::Pos getPosition() const
   {
@@ -432,6 +434,30 @@ struct MapAirway
 
 };
 
+/* Combined label for all airway segments connecting the same two waypoints.
+ * Created once when the airway cache is filled */
+struct MapAirwayLabel
+{
+  int airwayIndex; /* Index of the first segment in the airway list - used for text placement */
+  QVector<int> airwayIndexes; /* Index of all segments in the airway list sharing the same waypoints */
+  QString identText, /* Airway names, e.g. "V1, J12" */
+          infoText; /* Airway names, types and altitudes, e.g. "V1 / V / 2.000 ft, J12 / J" */
+  bool hasJet = false, hasVictor = false; /* Contains JET or VICTOR segments */
+};
+
+/* Connected segments of the same airway, fragment and type merged into one line.
+ * Created once when the airway cache is filled */
+struct MapAirwayLine
+{
+  maptypes::MapAirwayType type;
+  QVector<int> airwayIndexes; /* Index of all segments in the airway list in sequence order */
+  atools::geo::Rect bounding;
+
+  /* Great circle interpolated points along all segments. Calculated once for each zoom distance. */
+  atools::geo::LineString points;
+  QVector<int> pieceAirwayIds; /* Airway segment id for each line piece between points i and i + 1 */
+};
+
 /* Marker beacon */
 struct MapMarker
 {
@@ -505,6 +531,15 @@ struct MapSearchResult
   atools::fs::sc::SimConnectUserAircraft userAircraft;
 };
 
+/* Airports and navaids for many idents fetched at once. Objects are stored by ident and contain all regions. */
+struct MapIdentSearchResult
+{
+  QHash<QString, QList<MapAirport> > airports;
+  QHash<QString, QList<MapVor> > vors;
+  QHash<QString, QList<MapNdb> > ndbs;
+  QHash<QString, QList<MapWaypoint> > waypoints;
+};
+
 /* Range rings marker. Can be converted to QVariant */
 struct RangeMarker
 {
@@ -571,6 +606,12 @@ QString ndbText(const maptypes::MapNdb& ndb);
 QString waypointText(const maptypes::MapWaypoint& waypoint);
 QString userpointText(const maptypes::MapUserpoint& userpoint);
 QString airwayText(const maptypes::MapAirway& airway);
+
+/* Airway text for map display with name and optionally type and minimum altitude */
+QString airwayLabelText(const maptypes::MapAirway& airway, bool info);
+
+/* Get a direction independent key for the two waypoints of an airway segment */
+quint64 airwayWaypointKey(const maptypes::MapAirway& airway);
 QString magvarText(float magvar);
 
 /* Get a number for surface quality to get the best runway. Higher numbers are better surface. */
@@ -592,6 +633,8 @@ Q_DECLARE_TYPEINFO(maptypes::MapNdb, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapWaypoint, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapAirwayWaypoint, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapAirway, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(maptypes::MapAirwayLabel, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(maptypes::MapAirwayLine, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapMarker, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapIls, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(maptypes::MapUserpoint, Q_MOVABLE_TYPE);
@@ -20,6 +20,8 @@
 #include "common/maptypes.h"
 #include "mapgui/mapquery.h"
 #include "common/mapcolors.h"
+#include "mapgui/maplabelplacer.h"
+#include "mapgui/maplayer.h"
 #include "options/optiondata.h"
 
 #include <QPainter>
@@ -432,17 +434,16 @@ void SymbolPainter::drawNdbText(QPainter *painter, const maptypes::MapNdb& ndb,
     texts.append(QLocale().toString(ndb.frequency / 100., 'f', 1));
 
   textatt::TextAttributes textAttrs = textatt::BOLD;
+  textplace::Priority priority = textplace::NDB;
   if(flags & textflags::ROUTE_TEXT)
-    textAttrs |= textatt::ROUTE_BG_COLOR;
-
-  if(!flags.testFlag(textflags::ABS_POS))
   {
-    y += size / 2 + painter->fontMetrics().ascent();
-    textAttrs |= textatt::CENTER;
+    textAttrs |= textatt::ROUTE_BG_COLOR;
+    priority = textplace::ROUTE;
   }
 
   int transparency = fill ? 255 : 0;
-  textBox(painter, texts, mapcolors::ndbSymbolColor, x, y, textAttrs, transparency);
+  textBoxSymbol(painter, texts, mapcolors::ndbSymbolColor, x, y, size / 2, textplace::BOTTOM_SIDE, priority,
+                textAttrs, transparency, flags.testFlag(textflags::ABS_POS));
 }
 
 void SymbolPainter::drawVorText(QPainter *painter, const maptypes::MapVor& vor, int x, int y,
@@ -459,17 +460,16 @@ void SymbolPainter::drawVorText(QPainter *painter, const maptypes::MapVor& vor,
     texts.append(QLocale().toString(vor.frequency / 1000., 'f', 2));
 
   textatt::TextAttributes textAttrs = textatt::BOLD;
+  textplace::Priority priority = textplace::VOR;
   if(flags & textflags::ROUTE_TEXT)
-    textAttrs |= textatt::ROUTE_BG_COLOR;
-
-  if(!flags.testFlag(textflags::ABS_POS))
   {
-    x -= size / 2 + 2;
-    textAttrs |= textatt::RIGHT;
+    textAttrs |= textatt::ROUTE_BG_COLOR;
+    priority = textplace::ROUTE;
   }
 
   int transparency = fill ? 255 : 0;
-  textBox(painter, texts, mapcolors::vorSymbolColor, x, y, textAttrs, transparency);
+  textBoxSymbol(painter, texts, mapcolors::vorSymbolColor, x, y, size / 2 + 2, textplace::LEFT_SIDE, priority,
+                textAttrs, transparency, flags.testFlag(textflags::ABS_POS));
 }
 
 void SymbolPainter::drawWaypointText(QPainter *painter, const maptypes::MapWaypoint& wp, int x, int y,
@@ -481,17 +481,16 @@ void SymbolPainter::drawWaypointText(QPainter *painter, const maptypes::MapWaypo
     texts.append(wp.ident);
 
   textatt::TextAttributes textAttrs = textatt::BOLD;
+  textplace::Priority priority = textplace::WAYPOINT;
   if(flags & textflags::ROUTE_TEXT)
-    textAttrs |= textatt::ROUTE_BG_COLOR;
-
-  if(!flags.testFlag(textflags::ABS_POS))
   {
-    x += size / 2 + 2;
-    textAttrs |= textatt::LEFT;
+    textAttrs |= textatt::ROUTE_BG_COLOR;
+    priority = textplace::ROUTE;
   }
   int transparency = fill ? 255 : 0;
 
-  textBox(painter, texts, mapcolors::waypointSymbolColor, x, y, textAttrs, transparency);
+  textBoxSymbol(painter, texts, mapcolors::waypointSymbolColor, x, y, size / 2 + 2, textplace::RIGHT_SIDE,
+                priority, textAttrs, transparency, flags.testFlag(textflags::ABS_POS));
 }
 
 void SymbolPainter::drawAirportText(QPainter *painter, const maptypes::MapAirport& airport, int x, int y,
@@ -504,17 +503,27 @@ void SymbolPainter::drawAirportText(QPainter *painter, const maptypes::MapAirpor
     if(airport.flags.testFlag(maptypes::AP_ADDON))
       atts |= textatt::ITALIC | textatt::UNDERLINE;
 
+    // Bigger airports get their texts placed first
+    textplace::Priority priority;
+    if(airport.longestRunwayLength > MapLayer::MAX_LARGE_RUNWAY_FT)
+      priority = textplace::AIRPORT_LARGE;
+    else if(airport.longestRunwayLength > MapLayer::MAX_MEDIUM_RUNWAY_FT)
+      priority = textplace::AIRPORT_MEDIUM;
+    else
+      priority = textplace::AIRPORT_SMALL;
+
     if(flags & textflags::ROUTE_TEXT)
+    {
       atts |= textatt::ROUTE_BG_COLOR;
+      priority = textplace::ROUTE;
+    }
 
     int transparency = diagram ? 130 : 255;
     if(airport.empty() && OptionData::instance().getFlags() & opts::MAP_EMPTY_AIRPORTS)
       transparency = 0;
 
-    if(!flags.testFlag(textflags::ABS_POS))
-      x += size + 2;
-
-    textBox(painter, texts, mapcolors::colorForAirport(airport), x, y, atts, transparency);
+    textBoxSymbol(painter, texts, mapcolors::colorForAirport(airport), x, y, size + 2, textplace::RIGHT_SIDE,
+                  priority, atts, transparency, flags.testFlag(textflags::ABS_POS));
   }
 }
 
@@ -643,6 +652,45 @@ void SymbolPainter::textBoxF(QPainter *painter, const QStringList& texts, const
   painter->restore();
 }
 
+void SymbolPainter::textBoxSymbol(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y,
+                                  int offset, textplace::Side side, textplace::Priority priority,
+                                  textatt::TextAttributes atts, int transparency, bool absPos)
+{
+  if(texts.isEmpty())
+    return;
+
+  if(absPos)
+    textBox(painter, texts, textPen, x, y, atts, transparency);
+  else if(labelPlacer != nullptr)
+    // Collect text - will be placed and drawn after all symbols are painted
+    labelPlacer->addLabel(painter, texts, textPen, x, y, offset, side, priority, atts, transparency);
+  else
+  {
+    // Remove any alignment and use the one of the preferred side
+    atts &= ~(textatt::LEFT | textatt::RIGHT | textatt::CENTER);
+    switch(side)
+    {
+      case textplace::RIGHT_SIDE:
+        x += offset;
+        atts |= textatt::LEFT;
+        break;
+      case textplace::LEFT_SIDE:
+        x -= offset;
+        atts |= textatt::RIGHT;
+        break;
+      case textplace::BOTTOM_SIDE:
+        y += offset + painter->fontMetrics().ascent();
+        atts |= textatt::CENTER;
+        break;
+      case textplace::TOP_SIDE:
+        y -= offset + (texts.size() - 1) * painter->fontMetrics().height() + painter->fontMetrics().descent();
+        atts |= textatt::CENTER;
+        break;
+    }
+    textBox(painter, texts, textPen, x, y, atts, transparency);
+  }
+}
+
 QRect SymbolPainter::textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts)
 {
   QRect retval;
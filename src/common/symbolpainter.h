@@ -24,6 +24,7 @@
 
 class QPainter;
 class QPen;
+class MapLabelPlacer;
 
 namespace Marble {
 class GeoPainter;
@@ -80,11 +81,37 @@ Q_DECLARE_FLAGS(TextAttributes, TextAttribute);
 Q_DECLARE_OPERATORS_FOR_FLAGS(TextAttributes);
 }
 
+namespace textplace {
+/* Preferred side of a symbol where a text is placed. Other sides are tried if the preferred one is occupied */
+enum Side
+{
+  RIGHT_SIDE,
+  LEFT_SIDE,
+  BOTTOM_SIDE,
+  TOP_SIDE
+};
+
+/* Priority for text placement. Lower values are placed first and win over others */
+enum Priority
+{
+  ROUTE = 0, /* Texts for flight plan objects */
+  AIRPORT_LARGE, /* Airports with runways longer than 8000 ft */
+  AIRPORT_MEDIUM, /* Airports with runways longer than 4000 ft */
+  AIRPORT_SMALL,
+  VOR,
+  NDB,
+  WAYPOINT,
+  NUM_PRIORITIES
+};
+
+}
+
 /*
  * Draws all kind of map symbols and texts into an icon or a QPainter. Icons can change shape depending on size.
  * Separate functions are available for texts/captions.
  * An additional parameter "fast" is used to draw icons with less details while scrolling the map.
- * Instead of using a text collision detection text are placed on different sides of the symbols.
+ * Texts are placed on different sides of the symbols. If a label placer is set texts are collected
+ * and drawn later by the placer which avoids overlapping texts.
  */
 class SymbolPainter
 {
@@ -147,13 +174,28 @@ public:
   void textBoxF(QPainter *painter, const QStringList& texts, const QPen& textPen, float x, float y,
                 textatt::TextAttributes atts = textatt::NONE, int transparency = 255);
 
+  /* Draw a custom text box next to a symbol at the preferred side or pass it to the label placer if set.
+   * @param offset distance from symbol center to text
+   * @param absPos Draw the text at the given position without offset and placement */
+  void textBoxSymbol(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y, int offset,
+                     textplace::Side side, textplace::Priority priority, textatt::TextAttributes atts,
+                     int transparency, bool absPos = false);
+
   /* Get dimensions of a custom text box */
   QRect textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts);
 
+  /* Set a label placer that collects all symbol texts instead of drawing them immediately.
+   * Use nullptr to draw texts directly. */
+  void setLabelPlacer(MapLabelPlacer *placer)
+  {
+    labelPlacer = placer;
+  }
+
 private:
   QStringList airportTexts(textflags::TextFlags flags, const maptypes::MapAirport& airport);
 
   QColor iconBackground;
+  MapLabelPlacer *labelPlacer = nullptr;
 };
 
 #endif // LITTLENAVMAP_SYMBOLPAINTER_H
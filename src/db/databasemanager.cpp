@@ -22,6 +22,7 @@
 #include "common/constants.h"
 #include "fs/db/databasemeta.h"
 #include "db/databasedialog.h"
+#include "db/textindex.h"
 #include "settings/settings.h"
 #include "fs/navdatabaseoptions.h"
 #include "fs/navdatabaseprogress.h"
@@ -360,6 +361,9 @@ void DatabaseManager::openDatabase()
 
     if(!hasSchema())
       createEmptySchema(db);
+    else if(hasData())
+      // Databases loaded by older versions do not have the text search indexes
+      textindex::createMissingIndexes(db);
 
     DatabaseMeta dbmeta(db);
     qInfo().nospace() << "Database version "
@@ -460,7 +464,11 @@ bool DatabaseManager::runInternal()
         {
           if(loadScenery())
           {
-            // Successfully loaded
+            // Successfully loaded - add indexes for the search line edits
+            QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+            textindex::createIndexes(db);
+            QGuiApplication::restoreOverrideCursor();
+
             DatabaseMeta dbmeta(db);
             dbmeta.updateAll();
             reopenDialog = false;
@@ -0,0 +1,147 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "db/textindex.h"
+
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+#include "exception.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+
+namespace textindex {
+
+/* Describes an index table for the text columns of one table */
+struct IndexTable
+{
+  QString tablename, idColumnName;
+  QStringList columns;
+};
+
+/* All indexed tables and their columns that are used by the line edits in the search tabs */
+static const QList<IndexTable> INDEX_TABLES(
+{
+  {"airport", "airport_id", {"ident", "name", "city", "state", "country"}},
+  {"nav_search", "nav_search_id", {"ident", "name", "region", "airport_ident"}}
+});
+
+/* Suffix for index table names */
+static const QString INDEX_SUFFIX("_text_index");
+
+/* Trigram tokenizer needs at least this number of characters */
+static Q_DECL_CONSTEXPR int MIN_PATTERN_LENGTH = 3;
+
+static bool hasTable(atools::sql::SqlDatabase *db, const QString& name)
+{
+  atools::sql::SqlQuery query(db);
+  query.exec("select count(1) from sqlite_master where type = 'table' and name = '" + name + "'");
+  return query.next() && query.value(0).toInt() > 0;
+}
+
+static void createIndex(atools::sql::SqlDatabase *db, const IndexTable& table)
+{
+  QString indexName = table.tablename + INDEX_SUFFIX;
+
+  atools::sql::SqlQuery query(db);
+  query.exec("drop table if exists " + indexName);
+
+  // Index refers to the rows of the original table and does not duplicate the text
+  query.exec("create virtual table " + indexName + " using fts5(" + table.columns.join(", ") +
+             ", content='" + table.tablename + "', content_rowid='" + table.idColumnName +
+             "', tokenize='trigram')");
+
+  // Fill the index from the content table
+  query.exec("insert into " + indexName + "(" + indexName + ") values('rebuild')");
+}
+
+bool createIndexes(atools::sql::SqlDatabase *db)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  try
+  {
+    for(const IndexTable& table : INDEX_TABLES)
+      createIndex(db, table);
+    db->commit();
+  }
+  catch(atools::Exception& e)
+  {
+    // FTS5 module or trigram tokenizer not compiled in - searches fall back to "like"
+    qWarning() << "Cannot create text indexes:" << e.what();
+    db->rollback();
+    return false;
+  }
+
+  qDebug() << "Text indexes created in" << timer.elapsed() << "ms";
+  return true;
+}
+
+void createMissingIndexes(atools::sql::SqlDatabase *db)
+{
+  for(const IndexTable& table : INDEX_TABLES)
+  {
+    if(!hasTable(db, table.tablename + INDEX_SUFFIX))
+    {
+      createIndexes(db);
+      break;
+    }
+  }
+}
+
+QString indexTableName(atools::sql::SqlDatabase *db, const QString& tablename)
+{
+  for(const IndexTable& table : INDEX_TABLES)
+  {
+    if(table.tablename == tablename)
+    {
+      QString indexName = tablename + INDEX_SUFFIX;
+      if(hasTable(db, indexName))
+        return indexName;
+      break;
+    }
+  }
+  return QString();
+}
+
+bool isIndexedColumn(const QString& tablename, const QString& columnName)
+{
+  for(const IndexTable& table : INDEX_TABLES)
+  {
+    if(table.tablename == tablename)
+      return table.columns.contains(columnName);
+  }
+  return false;
+}
+
+bool isIndexablePattern(const QString& likePattern)
+{
+  int run = 0;
+  for(const QChar& c : likePattern)
+  {
+    if(c == '%' || c == '_')
+      run = 0;
+    else if(++run >= MIN_PATTERN_LENGTH)
+      return true;
+  }
+  return false;
+}
+
+} // namespace textindex
@@ -0,0 +1,55 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_TEXTINDEX_H
+#define LITTLENAVMAP_TEXTINDEX_H
+
+#include <QString>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/*
+ * Trigram full text indexes for the text columns of the search tables. The indexes are SQLite FTS5 tables
+ * using the table as external content and allow "like" queries with leading wildcards to use an index.
+ * Nothing is created if the SQLite library does not support FTS5 or the trigram tokenizer.
+ */
+namespace textindex {
+
+/* Drop and create all indexes. Call after the database was loaded. Returns false if not supported. */
+bool createIndexes(atools::sql::SqlDatabase *db);
+
+/* Create indexes only if not already present. Used for databases loaded by older versions. */
+void createMissingIndexes(atools::sql::SqlDatabase *db);
+
+/* Name of the index table for the given table or empty if there is none in the database */
+QString indexTableName(atools::sql::SqlDatabase *db, const QString& tablename);
+
+/* true if the column of table is contained in the index */
+bool isIndexedColumn(const QString& tablename, const QString& columnName);
+
+/* true if the "like" pattern contains at least three characters in sequence which is needed for trigram
+ * lookups. Shorter patterns result in a full scan of the index. */
+bool isIndexablePattern(const QString& likePattern);
+
+} // namespace textindex
+
+#endif // LITTLENAVMAP_TEXTINDEX_H
@@ -23,6 +23,7 @@
 #include "gui/dialog.h"
 #include "sql/sqlexport.h"
 #include "search/sqlcontroller.h"
+#include "export/exportjob.h"
 
 #include "sql/sqlrecord.h"
 
@@ -54,7 +55,6 @@ QString CsvExporter::saveCsvFileDialog()
                                 "csv", lnm::EXPORT_FILEDIALOG);
 }
 
-#ifdef ENABLE_CSV_EXPORT
 int CsvExporter::exportAll(bool open)
 {
   int exported = 0;
@@ -63,51 +63,19 @@ int CsvExporter::exportAll(bool open)
   if(!filename.isEmpty())
   {
     qDebug() << "exportAllCsv" << filename;
-    QFile file(filename);
-
-    if(file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-      QTextStream stream(&file);
-      qDebug() << "Used codec" << stream.codec()->name();
-
-      // Run the current query to get all results - not only the visible
-      atools::sql::SqlDatabase *db = controller->getSqlDatabase();
-      SqlQuery query(db);
-      query.exec(controller->getCurrentSqlQuery());
 
-      SqlExport sqlExport;
-      sqlExport.setSeparatorChar(';');
-      QVariantList values;
+    // Run the current query again in the background to get all results - not only the visible
+    ExportJob job(new CsvExportFormat, filename);
+    prepareExportJob(job);
+    exported = runExportJob(job);
 
-      int row = 0;
-      while(query.next())
-      {
-        atools::sql::SqlRecord rec = query.record();
-        if(row == 0)
-          stream << sqlExport.getResultSetHeader(headerNames(rec.count()));
-
-        // Write all columns
-        values.clear();
-        for(int col = 0; col < rec.count(); ++col)
-          // Get data formatted as shown in the table
-          values.append(controller->formatModelData(rec.fieldName(col), rec.value(col)));
-        stream << sqlExport.getResultSetRow(values);
-        row++;
-        exported++;
-      }
-
-      stream.flush();
-      file.close();
-
-      if(open)
-        openDocument(filename);
-    }
-    else
-      errorHandler->handleIOError(file);
+    if(exported != -1 && open)
+      openDocument(filename);
   }
   return exported;
 }
 
+#ifdef ENABLE_CSV_EXPORT
 int CsvExporter::exportSelected(bool open)
 {
   int exported = 0;
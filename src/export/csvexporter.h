@@ -44,15 +44,15 @@ public:
   CsvExporter(QWidget *parentWidget, SqlController *controller);
   virtual ~CsvExporter();
 
-  // Disabled unused export functionality since it is not compatible with other classes
-#ifdef ENABLE_CSV_EXPORT
-  /* Export all rows.
+  /* Export all rows of the current query in a background thread. Shows a progress dialog.
    *
    * @param open Open file in default application after export.
-   * @return number of rows exported.
+   * @return number of rows exported or -1 if canceled or failed.
    */
-  virtual int exportAll(bool open) override;
+  int exportAll(bool open);
 
+  // Disabled unused export functionality since it is not compatible with other classes
+#ifdef ENABLE_CSV_EXPORT
   /* Export only selected rows.
    *
    * @param open Open file in default application after export.
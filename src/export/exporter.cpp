@@ -20,6 +20,8 @@
 #include "gui/dialog.h"
 #include "gui/errorhandler.h"
 #include "search/column.h"
+#include "export/exportjob.h"
+#include "sql/sqldatabase.h"
 
 #include <QDebug>
 #include <QUrl>
@@ -27,6 +29,11 @@
 #include <QApplication>
 #include <QSqlField>
 #include <QSqlRecord>
+#include <QProgressDialog>
+#include <QSqlDatabase>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 using atools::gui::Dialog;
 using atools::gui::ErrorHandler;
@@ -116,3 +123,92 @@ void Exporter::fillRecord(const QVariantList& values, const QStringList& cols, Q
       rec.setValue(i, values.at(i));
   }
 }
+
+void Exporter::prepareExportJob(ExportJob& job)
+{
+  QVector<const Column *> allColumns = controller->getCurrentColumns();
+
+  // Create an index that maps the (probably reordered) columns of the view to the model
+  QVector<int> visualToIndex;
+  createVisualColumnIndex(allColumns.size(), visualToIndex);
+
+  QVector<const Column *> exportColumns;
+  QStringList captions;
+  for(int index : visualToIndex)
+  {
+    // Distance columns are calculated by the proxy model and not available in the query
+    if(index != -1 && !allColumns.at(index)->isDistance())
+    {
+      QString caption = allColumns.at(index)->getDisplayName();
+      captions.append(caption.replace("-\n", "").replace("\n", " "));
+      exportColumns.append(allColumns.at(index));
+    }
+  }
+
+  QSqlDatabase sqlDb = controller->getSqlDatabase()->getQSqlDatabase();
+  job.setQuery(sqlDb.driverName(), sqlDb.databaseName(),
+               controller->getCurrentSqlQuery(), controller->getCurrentCountQuery());
+  job.setColumns(exportColumns, captions, controller->getSqlModel()->getColumnFormatCallback(),
+                 controller->getSortColumn());
+  job.setIdColumn(controller->getIdColumnDescriptor()->getColumnName());
+
+  if(controller->isDistanceSearch())
+    // The query does only the coarse rectangle filtering - apply the same fine filter as the table
+    job.setDistanceFilter(controller->getDistanceFilter(), controller->getSqlModel()->getSortOrder());
+}
+
+int Exporter::runExportJob(ExportJob& job)
+{
+  if(!runJob(job, &ExportJob::run, tr("Exporting ...")))
+    return -1;
+
+  return job.getExported();
+}
+
+int Exporter::runCountJob(ExportJob& job)
+{
+  if(!runJob(job, &ExportJob::count, tr("Counting rows ...")))
+    return -1;
+
+  return job.getTotalRows();
+}
+
+bool Exporter::runJob(ExportJob& job, void (ExportJob::*func)(), const QString& labelText)
+{
+  progressDialog = new QProgressDialog(labelText, tr("&Cancel"), 0, 0, parentWidget);
+  progressDialog->setWindowModality(Qt::WindowModal);
+  progressDialog->setMinimumDuration(500);
+
+  connect(&job, &ExportJob::progress, this, &Exporter::exportProgress);
+  connect(progressDialog, &QProgressDialog::canceled, &job, &ExportJob::cancel);
+
+  // Keep the event loop running while the job works in the background
+  QEventLoop loop;
+  QFutureWatcher<void> watcher;
+  connect(&watcher, &QFutureWatcher<void>::finished, &loop, &QEventLoop::quit);
+  watcher.setFuture(QtConcurrent::run(&job, func));
+  loop.exec();
+
+  disconnect(&job, &ExportJob::progress, this, &Exporter::exportProgress);
+  delete progressDialog;
+  progressDialog = nullptr;
+
+  if(!job.getErrorString().isEmpty())
+  {
+    QMessageBox::warning(parentWidget, QApplication::applicationName(),
+                         tr("Export failed. Reason: %1").arg(job.getErrorString()));
+    return false;
+  }
+
+  return !job.wasCanceled();
+}
+
+void Exporter::exportProgress(int exportedRows, int totalRows)
+{
+  if(progressDialog != nullptr)
+  {
+    progressDialog->setMaximum(totalRows);
+    progressDialog->setValue(exportedRows);
+    progressDialog->setLabelText(tr("Exported %L1 of %L2 rows ...").arg(exportedRows).arg(totalRows));
+  }
+}
@@ -30,6 +30,8 @@ class ErrorHandler;
 class SqlController;
 class QWidget;
 class QSqlRecord;
+class QProgressDialog;
+class ExportJob;
 
 /*
  * Base for all export classes.
@@ -70,6 +72,26 @@ protected:
   /* Create an SQL record from column names and values */
   void fillRecord(const QVariantList& values, const QStringList& cols, QSqlRecord& rec);
 
+  /* Configure job with the current query of the controller, the distance search filter and the columns
+   * visible in the view in visual order */
+  void prepareExportJob(ExportJob& job);
+
+  /* Run the job in a background thread and show a progress dialog allowing to cancel. Shows an error dialog
+   * if the export failed. Returns number of exported rows or -1 if canceled or failed. */
+  int runExportJob(ExportJob& job);
+
+  /* Run the count query of the job in a background thread and show a progress dialog.
+   * Returns number of rows or -1 if canceled or failed. */
+  int runCountJob(ExportJob& job);
+
+private:
+  /* Run the job method in a background thread while showing a progress dialog.
+   * Returns false if canceled or failed. */
+  bool runJob(ExportJob& job, void (ExportJob::*func)(), const QString& labelText);
+  void exportProgress(int exportedRows, int totalRows);
+
+  QProgressDialog *progressDialog = nullptr;
+
 };
 
 #endif // LITTLELOGBOOK_EXPORTER_H
@@ -0,0 +1,506 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "export/exportformat.h"
+
+#include "geo/pos.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+ExportFileWriter::ExportFileWriter()
+{
+  buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+}
+
+ExportFileWriter::~ExportFileWriter()
+{
+  close();
+}
+
+bool ExportFileWriter::open(const QString& filename)
+{
+  close();
+  buffer.clear();
+  error = false;
+  file.setFileName(filename);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    error = true;
+    return false;
+  }
+  return true;
+}
+
+bool ExportFileWriter::close()
+{
+  if(file.isOpen())
+  {
+    flush();
+    file.close();
+  }
+  return !error;
+}
+
+void ExportFileWriter::flush()
+{
+  if(!buffer.isEmpty() && file.isOpen() && !error)
+  {
+    if(file.write(buffer) != buffer.size())
+      error = true;
+  }
+  buffer.clear();
+}
+
+QString ExportFileWriter::getErrorString() const
+{
+  return QString("%1: %2").arg(file.fileName()).arg(file.errorString());
+}
+
+// ======================================================================================
+ExportFormat::~ExportFormat()
+{
+
+}
+
+// ======================================================================================
+bool CsvExportFormat::begin(const QString& filename, const ExportHeader& header)
+{
+  if(!writer.open(filename))
+    return false;
+
+  writeLine(header.captions);
+  return !writer.hasError();
+}
+
+bool CsvExportFormat::writeRow(const ExportRow& row, const QStringList& formatted)
+{
+  Q_UNUSED(row);
+  writeLine(formatted);
+  return !writer.hasError();
+}
+
+bool CsvExportFormat::end()
+{
+  return writer.close();
+}
+
+QString CsvExportFormat::getErrorString() const
+{
+  return writer.getErrorString();
+}
+
+void CsvExportFormat::writeLine(const QStringList& values)
+{
+  // Reuse the line buffer to avoid allocations for each row
+  line.clear();
+  for(int i = 0; i < values.size(); i++)
+  {
+    if(i > 0)
+      line.append(';');
+
+    const QString& value = values.at(i);
+    if(value.contains(';') || value.contains('"') || value.contains('\n') || value.contains('\r'))
+    {
+      // Quote and escape quotes by doubling them
+      line.append('"');
+      line.append(QString(value).replace("\"", "\"\""));
+      line.append('"');
+    }
+    else
+      line.append(value);
+  }
+  line.append('\n');
+  writer.write(line);
+}
+
+// ======================================================================================
+HtmlExportFormat::HtmlExportFormat(int rowsPerPage, const QString& cssText, const QString& footerText)
+  : css(cssText), footer(footerText), pageSize(rowsPerPage)
+{
+}
+
+bool HtmlExportFormat::begin(const QString& filenameParam, const ExportHeader& header)
+{
+  filename = filenameParam;
+  basename = QFileInfo(filename).fileName();
+  exportHeader = header;
+  page = 0;
+  rowInPage = 0;
+  totalPages = std::max(1, static_cast<int>(std::ceil(static_cast<float>(header.totalRows) /
+                                                      static_cast<float>(pageSize))));
+  return startPage();
+}
+
+bool HtmlExportFormat::writeRow(const ExportRow& row, const QStringList& formatted)
+{
+  Q_UNUSED(row);
+
+  if(rowInPage == pageSize)
+  {
+    // Page is full - continue in the next file
+    if(!endPage())
+      return false;
+    page++;
+    rowInPage = 0;
+    if(!startPage())
+      return false;
+  }
+
+  bool alt = (rowInPage % 2) == 1;
+  rowText.clear();
+  // Use alternating color CSS class for rows
+  rowText.append(alt ? "<tr class=\"alt\">" : "<tr>");
+  for(int i = 0; i < formatted.size(); i++)
+  {
+    if(i == exportHeader.sortColumn)
+      // Change table field background color to darker if it is the sorting column
+      rowText.append(alt ? "<td class=\"sort\">" : "<td class=\"sortalt\">");
+    else
+      rowText.append("<td>");
+    rowText.append(formatted.at(i).toHtmlEscaped());
+    rowText.append("</td>");
+  }
+  rowText.append("</tr>\n");
+  writer.write(rowText);
+  rowInPage++;
+
+  return !writer.hasError();
+}
+
+bool HtmlExportFormat::end()
+{
+  return endPage();
+}
+
+QString HtmlExportFormat::getErrorString() const
+{
+  return writer.getErrorString();
+}
+
+QString HtmlExportFormat::filenameForPage(const QString& filename, int page)
+{
+  if(page == 0)
+    return filename;
+  else
+  {
+    QString retval = filename;
+    if(filename.lastIndexOf(".") == -1)
+      retval = filename + "_" + QString::number(page);
+    else
+      retval.insert(filename.lastIndexOf("."), "_" + QString::number(page));
+    return retval;
+  }
+}
+
+bool HtmlExportFormat::startPage()
+{
+  if(!writer.open(filenameForPage(filename, page)))
+    return false;
+
+  writer.write(QString("<!DOCTYPE html>\n<html>\n<head>\n"
+                       "<meta http-equiv=\"content-type\" content=\"text/html; charset=utf-8\"/>\n"
+                       "<title>%1</title>\n<style>\n%2\n</style>\n</head>\n<body>\n<h1>%1</h1>\n").
+               arg(QApplication::applicationName().toHtmlEscaped()).arg(css));
+  writeNav();
+
+  writer.write(QString("<table>\n<tbody>\n<tr>"));
+  for(const QString& caption : exportHeader.captions)
+    writer.write("<th>" + caption.toHtmlEscaped() + "</th>");
+  writer.write(QString("</tr>\n"));
+
+  return !writer.hasError();
+}
+
+bool HtmlExportFormat::endPage()
+{
+  writer.write(QString("</tbody>\n</table>\n"));
+  writeNav();
+  writer.write("<p class=\"footer\">" + footer.toHtmlEscaped() + "</p>\n</body>\n</html>\n");
+  return writer.close();
+}
+
+void HtmlExportFormat::writeNav()
+{
+  if(totalPages == 1)
+    return;
+
+  QStringList links;
+  if(page > 0)
+  {
+    links.append(link(0, tr("First Page")));
+    links.append(link(page - 1, tr("Previous Page")));
+  }
+  else
+    links << tr("First Page") << tr("Previous Page");
+
+  if(page < totalPages - 1)
+  {
+    links.append(link(page + 1, tr("Next Page")));
+    links.append(link(totalPages - 1, tr("Last Page")));
+  }
+  else
+    links << tr("Next Page") << tr("Last Page");
+
+  writer.write(tr("<p>Page %1 of %2 - %3</p>\n").arg(page + 1).arg(totalPages).arg(links.join(" - ")));
+}
+
+QString HtmlExportFormat::link(int linkPage, const QString& text) const
+{
+  return QString("<a href=\"%1\">%2</a>").arg(filenameForPage(basename, linkPage).toHtmlEscaped()).arg(text);
+}
+
+// ======================================================================================
+GeoJsonExportFormat::GeoJsonExportFormat()
+  : json(writer)
+{
+}
+
+bool GeoJsonExportFormat::begin(const QString& filename, const ExportHeader& header)
+{
+  exportHeader = header;
+  resolved = false;
+
+  if(!writer.open(filename))
+    return false;
+
+  json.begin();
+  return !writer.hasError();
+}
+
+bool GeoJsonExportFormat::writeRow(const ExportRow& row, const QStringList& formatted)
+{
+  Q_UNUSED(formatted);
+
+  if(!resolved)
+  {
+    QSqlRecord rec = row.record();
+    indexes.clear();
+    for(const QString& name : exportHeader.columnNames)
+      indexes.append(rec.indexOf(name));
+    lonXIndex = rec.indexOf("lonx");
+    latYIndex = rec.indexOf("laty");
+    resolved = true;
+  }
+
+  values.clear();
+  for(int index : indexes)
+    values.append(index != -1 ? row.value(index) : QVariant());
+
+  atools::geo::Pos pos;
+  if(lonXIndex != -1 && latYIndex != -1 && !row.isNull(lonXIndex) && !row.isNull(latYIndex))
+    pos = atools::geo::Pos(row.value(lonXIndex).toFloat(), row.value(latYIndex).toFloat());
+
+  json.writePointFeature(pos, exportHeader.columnNames, values);
+  return !writer.hasError();
+}
+
+bool GeoJsonExportFormat::end()
+{
+  json.end();
+  return writer.close();
+}
+
+QString GeoJsonExportFormat::getErrorString() const
+{
+  return writer.getErrorString();
+}
+
+// ======================================================================================
+static void appendUInt16(QByteArray& data, quint16 value)
+{
+  uchar buf[2];
+  qToLittleEndian(value, buf);
+  data.append(reinterpret_cast<const char *>(buf), 2);
+}
+
+static void appendUInt32(QByteArray& data, quint32 value)
+{
+  uchar buf[4];
+  qToLittleEndian(value, buf);
+  data.append(reinterpret_cast<const char *>(buf), 4);
+}
+
+static void appendInt32(QByteArray& data, qint32 value)
+{
+  appendUInt32(data, static_cast<quint32>(value));
+}
+
+static void appendFloat32(QByteArray& data, float value)
+{
+  quint32 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendUInt32(data, bits);
+}
+
+/* Append UTF-8 string with uint16 length prefix */
+static void appendString(QByteArray& data, const QString& str)
+{
+  QByteArray utf8 = str.toUtf8().left(std::numeric_limits<quint16>::max());
+  appendUInt16(data, static_cast<quint16>(utf8.size()));
+  data.append(utf8);
+}
+
+bool BinaryExportFormat::begin(const QString& filename, const ExportHeader& header)
+{
+  exportHeader = header;
+  headerWritten = false;
+  blockRows = 0;
+  columns.clear();
+  strings.clear();
+  stringData.clear();
+
+  return writer.open(filename);
+}
+
+bool BinaryExportFormat::writeRow(const ExportRow& row, const QStringList& formatted)
+{
+  Q_UNUSED(formatted);
+
+  if(!headerWritten)
+    // Column types are known with the first row
+    writeFileHeader(row.record());
+
+  for(BinaryColumn& col : columns)
+  {
+    bool isNull = col.queryIndex == -1 || row.isNull(col.queryIndex);
+    QVariant value = isNull ? QVariant() : row.value(col.queryIndex);
+
+    switch(col.type)
+    {
+      case INT32:
+        appendInt32(col.data, isNull ? 0 : value.toInt());
+        break;
+      case FLOAT32:
+        appendFloat32(col.data, isNull ? std::numeric_limits<float>::quiet_NaN() : value.toFloat());
+        break;
+      case STRING:
+        appendInt32(col.data, isNull ? -1 : stringIndex(value.toString()));
+        break;
+    }
+  }
+
+  blockRows++;
+  if(blockRows == BLOCK_ROWS)
+    writeBlock();
+
+  return !writer.hasError();
+}
+
+bool BinaryExportFormat::end()
+{
+  if(!headerWritten)
+    // Nothing exported - write header using default types
+    writeFileHeader(QSqlRecord());
+
+  if(blockRows > 0)
+    writeBlock();
+
+  // Terminating empty block
+  writeBlock();
+  return writer.close();
+}
+
+QString BinaryExportFormat::getErrorString() const
+{
+  return writer.getErrorString();
+}
+
+void BinaryExportFormat::writeFileHeader(const QSqlRecord& record)
+{
+  columns.clear();
+  columns.append({exportHeader.idColumnName, record.indexOf(exportHeader.idColumnName), INT32, QByteArray()});
+  columns.append({"lonx", record.indexOf("lonx"), FLOAT32, QByteArray()});
+  columns.append({"laty", record.indexOf("laty"), FLOAT32, QByteArray()});
+
+  for(const QString& name : exportHeader.columnNames)
+  {
+    if(name == exportHeader.idColumnName || name == "lonx" || name == "laty")
+      continue;
+
+    int index = record.indexOf(name);
+    ColumnType type = STRING;
+    if(index != -1)
+    {
+      // Use the declared type of the database column
+      QVariant::Type fieldType = record.field(index).type();
+      if(fieldType == QVariant::Int || fieldType == QVariant::UInt || fieldType == QVariant::LongLong ||
+         fieldType == QVariant::ULongLong || fieldType == QVariant::Bool)
+        type = INT32;
+      else if(fieldType == QVariant::Double)
+        type = FLOAT32;
+    }
+    columns.append({name, index, type, QByteArray()});
+  }
+
+  for(BinaryColumn& col : columns)
+    col.data.reserve(BLOCK_ROWS * 4);
+
+  QByteArray data("LNMB");
+  appendUInt16(data, FILE_VERSION);
+  appendUInt16(data, static_cast<quint16>(columns.size()));
+  for(const BinaryColumn& col : columns)
+  {
+    data.append(static_cast<char>(col.type));
+    appendString(data, col.name);
+  }
+  writer.write(data);
+  headerWritten = true;
+}
+
+void BinaryExportFormat::writeBlock()
+{
+  QByteArray data;
+  appendUInt32(data, static_cast<quint32>(blockRows));
+  appendUInt32(data, static_cast<quint32>(strings.size()));
+  writer.write(data);
+  writer.write(stringData);
+
+  for(BinaryColumn& col : columns)
+  {
+    writer.write(col.data);
+    // Keeps the reserved capacity
+    col.data.resize(0);
+  }
+
+  // Start a new string table with the next block
+  strings.clear();
+  stringData.clear();
+  blockRows = 0;
+}
+
+qint32 BinaryExportFormat::stringIndex(const QString& str)
+{
+  QHash<QString, qint32>::const_iterator it = strings.constFind(str);
+  if(it != strings.constEnd())
+    return it.value();
+
+  // New string - add to the table and write it with the current block
+  qint32 index = strings.size();
+  strings.insert(str, index);
+  appendString(stringData, str);
+  return index;
+}
@@ -0,0 +1,313 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_EXPORTFORMAT_H
+#define LITTLENAVMAP_EXPORTFORMAT_H
+
+#include "export/geojsonwriter.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Output file that collects text or binary data in a large buffer and writes it in blocks.
+ * Write errors are remembered and can be checked after closing.
+ */
+class ExportFileWriter
+{
+public:
+  ExportFileWriter();
+  ~ExportFileWriter();
+
+  bool open(const QString& filename);
+
+  /* Flush buffer and close file. Returns false if any write failed. */
+  bool close();
+
+  /* Append text as UTF-8 */
+  void write(const QString& text)
+  {
+    buffer.append(text.toUtf8());
+    flushIfFull();
+  }
+
+  void write(const QByteArray& data)
+  {
+    buffer.append(data);
+    flushIfFull();
+  }
+
+  void write(const char *data, int size)
+  {
+    buffer.append(data, size);
+    flushIfFull();
+  }
+
+  bool hasError() const
+  {
+    return error;
+  }
+
+  QString getErrorString() const;
+
+private:
+  void flushIfFull()
+  {
+    if(buffer.size() >= BUFFER_SIZE)
+      flush();
+  }
+
+  void flush();
+
+  /* Buffer is written if it exceeds this size */
+  static Q_DECL_CONSTEXPR int BUFFER_SIZE = 1024 * 1024;
+
+  QFile file;
+  QByteArray buffer;
+  bool error = false;
+};
+
+/* Column information that is passed to the export formats */
+struct ExportHeader
+{
+  /* Header captions of the exported columns in output order */
+  QStringList captions;
+
+  /* SQL column names of the exported columns in output order */
+  QStringList columnNames;
+
+  /* SQL column name of the primary key */
+  QString idColumnName;
+
+  /* Index of the sort column in the exported columns or -1 */
+  int sortColumn = -1;
+
+  /* Number of rows that will be exported */
+  int totalRows = 0;
+};
+
+/*
+ * Raw values of the current export row. Values are either read directly from the query or from a
+ * buffered record if rows have to be filtered or sorted before writing.
+ */
+class ExportRow
+{
+public:
+  explicit ExportRow(const QSqlQuery& sqlQuery)
+    : query(&sqlQuery)
+  {
+  }
+
+  explicit ExportRow(const QSqlRecord& sqlRecord)
+    : rec(&sqlRecord)
+  {
+  }
+
+  QVariant value(int index) const
+  {
+    return query != nullptr ? query->value(index) : rec->value(index);
+  }
+
+  bool isNull(int index) const
+  {
+    return query != nullptr ? query->isNull(index) : rec->isNull(index);
+  }
+
+  /* Field names and types */
+  QSqlRecord record() const
+  {
+    return query != nullptr ? query->record() : *rec;
+  }
+
+private:
+  const QSqlQuery *query = nullptr;
+  const QSqlRecord *rec = nullptr;
+};
+
+/*
+ * Base for all output formats of ExportJob. All methods are called in the worker thread.
+ */
+class ExportFormat
+{
+public:
+  virtual ~ExportFormat();
+
+  /* Open file and write all headers */
+  virtual bool begin(const QString& filename, const ExportHeader& header) = 0;
+
+  /* Write a row.
+   * @param row current row giving access to the raw values of all query columns
+   * @param formatted values of the exported columns as shown in the table */
+  virtual bool writeRow(const ExportRow& row, const QStringList& formatted) = 0;
+
+  /* Write footers and close file */
+  virtual bool end() = 0;
+
+  virtual QString getErrorString() const = 0;
+};
+
+/*
+ * Writes CSV using ';' as separator and '"' for quotation.
+ */
+class CsvExportFormat :
+  public ExportFormat
+{
+public:
+  virtual bool begin(const QString& filename, const ExportHeader& header) override;
+  virtual bool writeRow(const ExportRow& row, const QStringList& formatted) override;
+  virtual bool end() override;
+  virtual QString getErrorString() const override;
+
+private:
+  void writeLine(const QStringList& values);
+
+  ExportFileWriter writer;
+  QString line;
+};
+
+/*
+ * Writes HTML tables and splits them into pages having a navigation bar. Pages after the first one get
+ * the page number appended to the file name.
+ */
+class HtmlExportFormat :
+  public ExportFormat
+{
+  Q_DECLARE_TR_FUNCTIONS(HtmlExportFormat)
+
+public:
+  /*
+   * @param rowsPerPage start a new file after this number of rows
+   * @param cssText style sheet that is embedded in each page
+   * @param footerText text for the paragraph at the end of each page
+   */
+  HtmlExportFormat(int rowsPerPage, const QString& cssText, const QString& footerText);
+
+  virtual bool begin(const QString& filename, const ExportHeader& header) override;
+  virtual bool writeRow(const ExportRow& row, const QStringList& formatted) override;
+  virtual bool end() override;
+  virtual QString getErrorString() const override;
+
+  /* Get the filename for the page including page number */
+  static QString filenameForPage(const QString& filename, int page);
+
+private:
+  bool startPage();
+  bool endPage();
+  void writeNav();
+  QString link(int page, const QString& text) const;
+
+  ExportFileWriter writer;
+  ExportHeader exportHeader;
+  QString filename, basename, css, footer, rowText;
+  int pageSize, page = 0, totalPages = 1, rowInPage = 0;
+};
+
+/*
+ * Writes a GeoJSON feature collection having a point feature for each row. Properties are the raw values of
+ * the exported columns using the SQL column names as keys. Needs the query columns lonx and laty.
+ */
+class GeoJsonExportFormat :
+  public ExportFormat
+{
+public:
+  GeoJsonExportFormat();
+
+  virtual bool begin(const QString& filename, const ExportHeader& header) override;
+  virtual bool writeRow(const ExportRow& row, const QStringList& formatted) override;
+  virtual bool end() override;
+  virtual QString getErrorString() const override;
+
+private:
+  ExportFileWriter writer;
+  GeoJsonWriter json;
+  ExportHeader exportHeader;
+
+  /* Query indexes of exported columns and coordinates. Resolved with the first row. */
+  QVector<int> indexes;
+  int lonXIndex = -1, latYIndex = -1;
+  bool resolved = false;
+  QVariantList values;
+};
+
+/*
+ * Compact columnar binary format for reading search results in other tools. All numbers are little endian.
+ *
+ * The file header contains the magic number "LNMB", uint16 version and uint16 number of columns. Then follows
+ * a uint8 type, a uint16 name length and the UTF-8 name for each column. Types are 0 for int32,
+ * 1 for float32 and 2 for strings given as int32 index into the string table or -1 for null.
+ * The first three columns are always the id and the coordinates lonx and laty as float32.
+ * Null numbers are written as 0 or NaN.
+ *
+ * Rows are written in blocks of up to 4096 rows. Each block starts with uint32 number of rows and
+ * uint32 number of strings in the string table of this block. Each string is given as uint16 length and UTF-8.
+ * After that follows an array of values for each column. A block with zero rows ends the file.
+ *
+ * Strings are interned per block so each distinct value is written only once in a block. The table is
+ * reset for each block to limit memory usage for columns having many distinct values.
+ */
+class BinaryExportFormat :
+  public ExportFormat
+{
+public:
+  virtual bool begin(const QString& filename, const ExportHeader& header) override;
+  virtual bool writeRow(const ExportRow& row, const QStringList& formatted) override;
+  virtual bool end() override;
+  virtual QString getErrorString() const override;
+
+private:
+  enum ColumnType : quint8
+  {
+    INT32 = 0,
+    FLOAT32 = 1,
+    STRING = 2
+  };
+
+  struct BinaryColumn
+  {
+    QString name;
+    int queryIndex;
+    ColumnType type;
+
+    /* Values of the current block */
+    QByteArray data;
+  };
+
+  void writeFileHeader(const QSqlRecord& record);
+  void writeBlock();
+  qint32 stringIndex(const QString& str);
+
+  static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 1;
+  static Q_DECL_CONSTEXPR int BLOCK_ROWS = 4096;
+
+  ExportFileWriter writer;
+  ExportHeader exportHeader;
+  QVector<BinaryColumn> columns;
+  bool headerWritten = false;
+  int blockRows = 0;
+
+  /* String table of the current block and its encoded strings */
+  QHash<QString, qint32> strings;
+  QByteArray stringData;
+};
+
+#endif // LITTLENAVMAP_EXPORTFORMAT_H
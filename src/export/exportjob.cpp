@@ -0,0 +1,291 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "export/exportjob.h"
+
+#include "search/column.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include <algorithm>
+
+ExportJob::ExportJob(ExportFormat *exportFormat, const QString& exportFilename)
+  : format(exportFormat), filename(exportFilename)
+{
+}
+
+ExportJob::~ExportJob()
+{
+  delete format;
+}
+
+void ExportJob::setQuery(const QString& driverName, const QString& databaseName,
+                         const QString& queryStr, const QString& countQueryStr)
+{
+  driver = driverName;
+  dbName = databaseName;
+  query = queryStr;
+  countQuery = countQueryStr;
+}
+
+void ExportJob::setColumns(const QVector<const Column *>& exportColumns, const QStringList& captions,
+                           const SqlModel::ColumnFormatFunctionType& columnFormatFunc,
+                           const QString& sortColumn)
+{
+  sortColumnName = sortColumn;
+  columns.clear();
+  header.captions = captions;
+  header.columnNames.clear();
+  header.sortColumn = -1;
+
+  for(const Column *col : exportColumns)
+  {
+    if(col->getColumnName() == sortColumn)
+      header.sortColumn = columns.size();
+
+    header.columnNames.append(col->getColumnName());
+    // Query index is resolved after running the query. Formatter is resolved once for the whole export.
+    columns.append({col, -1, columnFormatFunc != nullptr ? columnFormatFunc(col) : nullptr});
+  }
+}
+
+void ExportJob::setIdColumn(const QString& idColumnName)
+{
+  header.idColumnName = idColumnName;
+}
+
+void ExportJob::setDistanceFilter(const sqlproxymodel::DistanceFilter& filter, Qt::SortOrder order)
+{
+  distanceFilter = filter;
+  sortOrder = order;
+}
+
+void ExportJob::cancel()
+{
+  canceled.storeRelease(1);
+}
+
+void ExportJob::count()
+{
+  runWithDatabase(&ExportJob::countInternal);
+}
+
+void ExportJob::run()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  runWithDatabase(&ExportJob::runInternal);
+
+  qDebug() << "Exported" << exported << "rows to" << filename << "in" << timer.elapsed() << "ms"
+           << (wasCanceled() ? "canceled" : "") << errorString;
+}
+
+void ExportJob::runWithDatabase(void (ExportJob::*func)(QSqlDatabase& database))
+{
+  QString connectionName = QString("ExportJob-%1").arg(reinterpret_cast<quintptr>(this));
+  {
+    // Connection has to be created in this thread
+    QSqlDatabase database = QSqlDatabase::addDatabase(driver, connectionName);
+    database.setDatabaseName(dbName);
+    database.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if(database.open())
+    {
+      (this->*func)(database);
+      database.close();
+    }
+    else
+      errorString = database.lastError().text();
+  }
+  QSqlDatabase::removeDatabase(connectionName);
+}
+
+void ExportJob::countInternal(QSqlDatabase& database)
+{
+  if(distanceFilter.isValid())
+  {
+    // Count query gives only the result of the coarse rectangle filter
+    QSqlQuery sqlQuery(database);
+    sqlQuery.setForwardOnly(true);
+    QVector<DistanceRow> rows;
+    if(collectDistanceRows(sqlQuery, rows))
+    {
+      header.totalRows = rows.size();
+      counted = true;
+    }
+    return;
+  }
+
+  QSqlQuery countStmt(database);
+  if(countStmt.exec(countQuery) && countStmt.next())
+  {
+    header.totalRows = countStmt.value(0).toInt();
+    counted = true;
+  }
+  else
+    errorString = countStmt.lastError().text();
+}
+
+void ExportJob::runInternal(QSqlDatabase& database)
+{
+  QSqlQuery sqlQuery(database);
+  sqlQuery.setForwardOnly(true);
+
+  QVector<DistanceRow> distanceRows;
+  if(distanceFilter.isValid())
+  {
+    // Filter and sort rows like the table of the distance search
+    if(!collectDistanceRows(sqlQuery, distanceRows))
+      return;
+    header.totalRows = distanceRows.size();
+  }
+  else
+  {
+    if(!counted)
+    {
+      countInternal(database);
+      if(!errorString.isEmpty())
+        return;
+    }
+
+    if(!sqlQuery.exec(query))
+    {
+      errorString = sqlQuery.lastError().text();
+      return;
+    }
+  }
+  emit progress(0, header.totalRows);
+
+  // Resolve the position of each exported column once
+  QSqlRecord rec = sqlQuery.record();
+  for(FormatColumn& col : columns)
+    col.queryIndex = rec.indexOf(col.column->getColumnName());
+
+  if(!format->begin(filename, header))
+  {
+    errorString = format->getErrorString();
+    return;
+  }
+
+  QStringList formatted;
+  formatted.reserve(columns.size());
+  if(distanceFilter.isValid())
+  {
+    for(const DistanceRow& distanceRow : distanceRows)
+    {
+      if(wasCanceled())
+        break;
+
+      if(!writeRow(ExportRow(distanceRow.record), formatted))
+        return;
+    }
+  }
+  else
+  {
+    while(sqlQuery.next())
+    {
+      if(wasCanceled())
+        break;
+
+      if(!writeRow(ExportRow(sqlQuery), formatted))
+        return;
+    }
+  }
+
+  if(!format->end())
+    errorString = format->getErrorString();
+
+  emit progress(exported, header.totalRows);
+}
+
+bool ExportJob::collectDistanceRows(QSqlQuery& sqlQuery, QVector<DistanceRow>& rows)
+{
+  if(!sqlQuery.exec(query))
+  {
+    errorString = sqlQuery.lastError().text();
+    return false;
+  }
+
+  QSqlRecord rec = sqlQuery.record();
+  int lonXIndex = rec.indexOf("lonx"), latYIndex = rec.indexOf("laty");
+  if(lonXIndex == -1 || latYIndex == -1)
+  {
+    errorString = "Query has no coordinate columns";
+    return false;
+  }
+
+  while(sqlQuery.next())
+  {
+    if(wasCanceled())
+      return false;
+
+    float distanceMeter, headingDeg;
+    distanceFilter.calculate(atools::geo::Pos(sqlQuery.value(lonXIndex).toFloat(),
+                                              sqlQuery.value(latYIndex).toFloat()), distanceMeter, headingDeg);
+
+    // Same test as the proxy model of the table
+    if(distanceFilter.accepts(distanceMeter, headingDeg))
+      rows.append({sqlQuery.record(), distanceMeter, headingDeg});
+  }
+
+  // Distance and heading are not available in the query - sort here
+  if(sortColumnName == "distance")
+    std::stable_sort(rows.begin(), rows.end(), [ = ](const DistanceRow& row1, const DistanceRow& row2) -> bool
+                     {
+                       return sortOrder == Qt::AscendingOrder ?
+                       row1.distanceMeter < row2.distanceMeter : row1.distanceMeter > row2.distanceMeter;
+                     });
+  else if(sortColumnName == "heading")
+    std::stable_sort(rows.begin(), rows.end(), [ = ](const DistanceRow& row1, const DistanceRow& row2) -> bool
+                     {
+                       return sortOrder == Qt::AscendingOrder ?
+                       row1.headingDeg < row2.headingDeg : row1.headingDeg > row2.headingDeg;
+                     });
+  return true;
+}
+
+bool ExportJob::writeRow(const ExportRow& row, QStringList& formatted)
+{
+  formatRow(row, formatted);
+  if(!format->writeRow(row, formatted))
+  {
+    errorString = format->getErrorString();
+    return false;
+  }
+
+  exported++;
+  if((exported % PROGRESS_INTERVAL) == 0)
+    emit progress(exported, header.totalRows);
+  return true;
+}
+
+void ExportJob::formatRow(const ExportRow& row, QStringList& formatted) const
+{
+  formatted.clear();
+  for(const FormatColumn& col : columns)
+  {
+    QVariant value = col.queryIndex != -1 ? row.value(col.queryIndex) : QVariant();
+    formatted.append(col.formatter != nullptr ? col.formatter(value) : value.toString());
+  }
+}
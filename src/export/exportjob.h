@@ -0,0 +1,148 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_EXPORTJOB_H
+#define LITTLENAVMAP_EXPORTJOB_H
+
+#include "export/exportformat.h"
+#include "search/sqlmodel.h"
+#include "search/sqlproxymodel.h"
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QVector>
+
+class Column;
+class QSqlDatabase;
+
+/*
+ * Runs a search query in a worker thread using its own read only database connection and streams all
+ * result rows into an export format. Values are formatted like in the search table.
+ * Results of distance searches are filtered and sorted like in the table before writing.
+ *
+ * Create, configure and connect in the GUI thread and call run() in a worker thread.
+ * progress is emitted from the worker thread.
+ */
+class ExportJob :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /* Takes ownership of the format */
+  ExportJob(ExportFormat *exportFormat, const QString& exportFilename);
+  virtual ~ExportJob();
+
+  /* Query to run and query to get the total number of rows */
+  void setQuery(const QString& driverName, const QString& databaseName,
+                const QString& queryStr, const QString& countQueryStr);
+
+  /* Columns to export in output order and the callback returning a formatter for each column.
+   * The callback is called here and the returned formatters have to be thread safe.
+   * Set a null callback to export values as is. */
+  void setColumns(const QVector<const Column *>& exportColumns, const QStringList& captions,
+                  const SqlModel::ColumnFormatFunctionType& columnFormatFunc, const QString& sortColumnName);
+
+  /* Name of the primary key column of the query */
+  void setIdColumn(const QString& idColumnName);
+
+  /* Apply the second stage filter of a distance search to the query results. Rows are sorted by distance
+   * or heading if one of these is the sort column given in setColumns(). */
+  void setDistanceFilter(const sqlproxymodel::DistanceFilter& filter, Qt::SortOrder order);
+
+  /* Run only the count query. Called in the worker thread.
+   * run() uses this count and does not query it again. */
+  void count();
+
+  /* Export all rows. Called in the worker thread. */
+  void run();
+
+  /* Stop exporting as soon as possible. Can be called from any thread. */
+  void cancel();
+
+  /* Number of rows in the result. Valid after count() or run(). */
+  int getTotalRows() const
+  {
+    return header.totalRows;
+  }
+
+  /* Number of rows written */
+  int getExported() const
+  {
+    return exported;
+  }
+
+  bool wasCanceled() const
+  {
+    return canceled.loadAcquire() != 0;
+  }
+
+  /* Empty if no error occured */
+  const QString& getErrorString() const
+  {
+    return errorString;
+  }
+
+signals:
+  /* Sent in intervals while exporting */
+  void progress(int exportedRows, int totalRows);
+
+private:
+  /* Column to export, its position in the query and its formatter */
+  struct FormatColumn
+  {
+    const Column *column;
+    int queryIndex;
+    SqlModel::FormatFunctionType formatter;
+  };
+
+  /* Buffered row of a distance search */
+  struct DistanceRow
+  {
+    QSqlRecord record;
+    float distanceMeter, headingDeg;
+  };
+
+  /* Open a separate read only connection and call func with it */
+  void runWithDatabase(void (ExportJob::*func)(QSqlDatabase& database));
+  void runInternal(QSqlDatabase& database);
+  void countInternal(QSqlDatabase& database);
+
+  /* Run query and keep all rows passing the distance filter in sort order. Returns false on error or cancel. */
+  bool collectDistanceRows(QSqlQuery& sqlQuery, QVector<DistanceRow>& rows);
+
+  /* Format and write row. Returns false on error. */
+  bool writeRow(const ExportRow& row, QStringList& formatted);
+  void formatRow(const ExportRow& row, QStringList& formatted) const;
+
+  /* Emit progress after this number of rows */
+  static Q_DECL_CONSTEXPR int PROGRESS_INTERVAL = 2000;
+
+  ExportFormat *format;
+  QString filename, driver, dbName, query, countQuery, errorString;
+  QVector<FormatColumn> columns;
+  ExportHeader header;
+  QString sortColumnName;
+  sqlproxymodel::DistanceFilter distanceFilter;
+  Qt::SortOrder sortOrder = Qt::AscendingOrder;
+  int exported = 0;
+  bool counted = false;
+  QAtomicInt canceled;
+};
+
+#endif // LITTLENAVMAP_EXPORTJOB_H
@@ -0,0 +1,146 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "export/geoexporter.h"
+
+#include "common/aircrafttrack.h"
+#include "common/constants.h"
+#include "export/exportjob.h"
+#include "export/geojsonwriter.h"
+#include "gui/dialog.h"
+#include "route/routemapobjectlist.h"
+
+#include <QDebug>
+
+GeoExporter::GeoExporter(QWidget *parent, SqlController *controller)
+  : Exporter(parent, controller)
+{
+}
+
+GeoExporter::~GeoExporter()
+{
+}
+
+int GeoExporter::exportAllGeoJson()
+{
+  int exported = 0;
+  QString filename = dialog->saveFileDialog(tr("Export GeoJSON Document"),
+                                            tr("GeoJSON Documents %1;;All Files (*)").
+                                            arg(lnm::FILE_PATTERN_GEOJSON),
+                                            "geojson", lnm::EXPORT_FILEDIALOG);
+
+  if(!filename.isEmpty())
+  {
+    qDebug() << "exportAllGeoJson" << filename;
+    ExportJob job(new GeoJsonExportFormat, filename);
+    prepareExportJob(job);
+    exported = runExportJob(job);
+  }
+  return exported;
+}
+
+int GeoExporter::exportAllBinary()
+{
+  int exported = 0;
+  QString filename = dialog->saveFileDialog(tr("Export Binary File"),
+                                            tr("Binary Files %1;;All Files (*)").
+                                            arg(lnm::FILE_PATTERN_BINARY_EXPORT),
+                                            "lnmb", lnm::EXPORT_FILEDIALOG);
+
+  if(!filename.isEmpty())
+  {
+    qDebug() << "exportAllBinary" << filename;
+    ExportJob job(new BinaryExportFormat, filename);
+    prepareExportJob(job);
+    exported = runExportJob(job);
+  }
+  return exported;
+}
+
+bool GeoExporter::exportRouteGeoJson(const RouteMapObjectList& route, const QString& filename,
+                                     QString& errorString)
+{
+  ExportFileWriter writer;
+  if(!writer.open(filename))
+  {
+    errorString = writer.getErrorString();
+    return false;
+  }
+
+  GeoJsonWriter json(writer);
+  json.begin();
+
+  const atools::fs::pln::Flightplan& flightplan = route.getFlightplan();
+  json.beginLineFeature({"type", "departure", "destination", "cruise_altitude", "distance"},
+                        {"flightplan", flightplan.getDepartureIdent(), flightplan.getDestinationIdent(),
+                         flightplan.getCruisingAltitude(), route.getTotalDistance()});
+  for(const RouteMapObject& obj : route)
+    json.addLinePoint(obj.getPosition(), false);
+  json.endLineFeature();
+
+  for(int i = 0; i < route.size(); i++)
+  {
+    const RouteMapObject& obj = route.at(i);
+    json.writePointFeature(obj.getPosition(),
+                           {"type", "index", "ident", "region", "name", "object_type", "airway",
+                            "distance", "course"},
+                           {"waypoint", i, obj.getIdent(), obj.getRegion(), obj.getName(),
+                            obj.getMapObjectTypeName(), obj.getAirway(), obj.getDistanceTo(),
+                            obj.getCourseTo()});
+  }
+
+  json.end();
+  if(!writer.close())
+  {
+    errorString = writer.getErrorString();
+    return false;
+  }
+  return true;
+}
+
+bool GeoExporter::exportTrackGeoJson(const AircraftTrack& track, const QString& filename,
+                                     QString& errorString)
+{
+  ExportFileWriter writer;
+  if(!writer.open(filename))
+  {
+    errorString = writer.getErrorString();
+    return false;
+  }
+
+  GeoJsonWriter json(writer);
+  json.begin();
+  json.beginLineFeature({"type", "positions"}, {"track", track.size()});
+
+  // Iterate over the chunks to avoid copying the track
+  for(const at::AircraftTrackChunk& chunk : track.getChunks())
+  {
+    for(const at::AircraftTrackPos& trackPos : chunk.positions)
+      json.addLinePoint(trackPos.pos, true);
+  }
+
+  json.endLineFeature();
+  json.end();
+
+  if(!writer.close())
+  {
+    errorString = writer.getErrorString();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_GEOEXPORTER_H
+#define LITTLENAVMAP_GEOEXPORTER_H
+
+#include "export/exporter.h"
+
+class SqlController;
+class QWidget;
+class RouteMapObjectList;
+class AircraftTrack;
+
+/*
+ * Exports search results into GeoJSON or the compact binary format of BinaryExportFormat. Rows are streamed
+ * by a background job. Also allows to export the flight plan and the aircraft track into GeoJSON.
+ */
+class GeoExporter :
+  public Exporter
+{
+  Q_OBJECT
+
+public:
+  GeoExporter(QWidget *parentWidget, SqlController *controller);
+  virtual ~GeoExporter();
+
+  /* Export all rows of the current query. Shows a progress dialog.
+   * @return number of rows exported or -1 if canceled or failed. */
+  int exportAllGeoJson();
+  int exportAllBinary();
+
+  /* Write the flight plan as a line string feature followed by a point feature for each waypoint.
+   * Returns false and an error message if writing failed. */
+  static bool exportRouteGeoJson(const RouteMapObjectList& route, const QString& filename,
+                                 QString& errorString);
+
+  /* Write the full resolution aircraft track as a line string feature with altitudes */
+  static bool exportTrackGeoJson(const AircraftTrack& track, const QString& filename, QString& errorString);
+
+};
+
+#endif // LITTLENAVMAP_GEOEXPORTER_H
@@ -0,0 +1,169 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "export/geojsonwriter.h"
+
+#include "export/exportformat.h"
+#include "geo/calculations.h"
+#include "geo/pos.h"
+
+#include <cmath>
+
+GeoJsonWriter::GeoJsonWriter(ExportFileWriter& fileWriter)
+  : writer(fileWriter)
+{
+}
+
+void GeoJsonWriter::begin()
+{
+  firstFeature = true;
+  writer.write(QString("{\"type\":\"FeatureCollection\",\"features\":[\n"));
+}
+
+void GeoJsonWriter::end()
+{
+  writer.write(QString("\n]}\n"));
+}
+
+void GeoJsonWriter::writePointFeature(const atools::geo::Pos& pos, const QStringList& names,
+                                      const QVariantList& values)
+{
+  beginFeature(names, values);
+  if(pos.isValid())
+  {
+    text.append("\"geometry\":{\"type\":\"Point\",\"coordinates\":");
+    appendCoordinates(pos, false);
+    text.append("}}");
+  }
+  else
+    text.append("\"geometry\":null}");
+  writer.write(text);
+}
+
+void GeoJsonWriter::beginLineFeature(const QStringList& names, const QVariantList& values)
+{
+  beginFeature(names, values);
+  text.append("\"geometry\":{\"type\":\"LineString\",\"coordinates\":[");
+  writer.write(text);
+  firstPoint = true;
+}
+
+void GeoJsonWriter::addLinePoint(const atools::geo::Pos& pos, bool withAltitude)
+{
+  text.clear();
+  if(!firstPoint)
+    text.append(',');
+  firstPoint = false;
+  appendCoordinates(pos, withAltitude);
+  writer.write(text);
+}
+
+void GeoJsonWriter::endLineFeature()
+{
+  writer.write(QString("]}}"));
+}
+
+void GeoJsonWriter::beginFeature(const QStringList& names, const QVariantList& values)
+{
+  Q_ASSERT(names.size() == values.size());
+
+  text.clear();
+  if(!firstFeature)
+    text.append(",\n");
+  firstFeature = false;
+
+  text.append("{\"type\":\"Feature\",\"properties\":{");
+  for(int i = 0; i < names.size(); i++)
+  {
+    if(i > 0)
+      text.append(',');
+    text.append(jsonString(names.at(i)));
+    text.append(':');
+    text.append(jsonValue(values.at(i)));
+  }
+  text.append("},");
+}
+
+void GeoJsonWriter::appendCoordinates(const atools::geo::Pos& pos, bool withAltitude)
+{
+  text.append('[');
+  text.append(QString::number(pos.getLonX(), 'f', 6));
+  text.append(',');
+  text.append(QString::number(pos.getLatY(), 'f', 6));
+  if(withAltitude)
+  {
+    // Altitude is feet in the program but meter in GeoJSON
+    text.append(',');
+    text.append(QString::number(atools::geo::feetToMeter(pos.getAltitude()), 'f', 1));
+  }
+  text.append(']');
+}
+
+QString GeoJsonWriter::jsonValue(const QVariant& value)
+{
+  if(value.isNull() || !value.isValid())
+    return "null";
+
+  if(value.type() == QVariant::Double || value.userType() == QMetaType::Float)
+  {
+    // JSON has no representation for NaN or infinity
+    double doubleValue = value.toDouble();
+    return std::isfinite(doubleValue) ? QString::number(doubleValue, 'g', 10) : QString("null");
+  }
+
+  switch(value.type())
+  {
+    case QVariant::Bool:
+      return value.toBool() ? "true" : "false";
+
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      return value.toString();
+
+    default:
+      return jsonString(value.toString());
+  }
+}
+
+QString GeoJsonWriter::jsonString(const QString& str)
+{
+  QString retval;
+  retval.reserve(str.size() + 2);
+  retval.append('"');
+  for(const QChar& c : str)
+  {
+    if(c == '"')
+      retval.append("\\\"");
+    else if(c == '\\')
+      retval.append("\\\\");
+    else if(c == '\n')
+      retval.append("\\n");
+    else if(c == '\r')
+      retval.append("\\r");
+    else if(c == '\t')
+      retval.append("\\t");
+    else if(c.unicode() < 0x20)
+      retval.append(QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0')));
+    else
+      retval.append(c);
+  }
+  retval.append('"');
+  return retval;
+}
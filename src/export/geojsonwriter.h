@@ -0,0 +1,73 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_GEOJSONWRITER_H
+#define LITTLENAVMAP_GEOJSONWRITER_H
+
+#include <QStringList>
+#include <QVariantList>
+
+namespace atools {
+namespace geo {
+class Pos;
+}
+}
+
+class ExportFileWriter;
+
+/*
+ * Streams a GeoJSON feature collection into a file writer. Features are written as soon as they are
+ * complete so memory usage does not depend on the number of features.
+ * Coordinates are written as longitude, latitude and optionally altitude in meter.
+ */
+class GeoJsonWriter
+{
+public:
+  GeoJsonWriter(ExportFileWriter& fileWriter);
+
+  /* Start and end the feature collection */
+  void begin();
+  void end();
+
+  /* Write a feature having a point geometry. An invalid position results in a null geometry.
+   * Names and values are the feature properties. */
+  void writePointFeature(const atools::geo::Pos& pos, const QStringList& names, const QVariantList& values);
+
+  /* Write a feature having a line string geometry. Add points between begin and end. */
+  void beginLineFeature(const QStringList& names, const QVariantList& values);
+  void addLinePoint(const atools::geo::Pos& pos, bool withAltitude);
+  void endLineFeature();
+
+  /* Convert value to a JSON number, string, boolean or null */
+  static QString jsonValue(const QVariant& value);
+
+  /* Quote and escape string */
+  static QString jsonString(const QString& str);
+
+private:
+  void beginFeature(const QStringList& names, const QVariantList& values);
+  void appendCoordinates(const atools::geo::Pos& pos, bool withAltitude);
+
+  ExportFileWriter& writer;
+
+  /* Reused for each feature */
+  QString text;
+  bool firstFeature = true, firstPoint = true;
+};
+
+#endif // LITTLENAVMAP_GEOJSONWRITER_H
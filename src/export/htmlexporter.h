@@ -24,13 +24,10 @@
 
 class SqlController;
 class QWidget;
-class QXmlStreamWriter;
-class QFile;
 
 /*
- * Allows to export the table content or the selected table content from the
- * given controller into HTML files. Uses a CSS file from the resources to
- * format file.
+ * Allows to export the table content from the given controller into HTML files. Uses a CSS file from the
+ * resources to format file.
  */
 class HtmlExporter :
   public Exporter
@@ -41,81 +38,20 @@ public:
   HtmlExporter(QWidget *parentWidget, SqlController *controller, int rowsPerPage);
   virtual ~HtmlExporter();
 
-  // Disabled unused export functionality since it is not compatible with other classes
-#ifdef ENABLE_HTML_EXPORT
-  /* Export all rows.
+  /* Export all rows of the current query in a background thread. Shows a progress dialog.
    *
    * @param open Open file in default browser after export.
-   * @return number of rows exported.
+   * @return number of rows exported or -1 if canceled or failed.
    */
-  virtual int exportAll(bool open) override;
-
-  /* Export only selected rows.
-   *
-   * @param open Open file in default browser after export.
-   * @return number of rows exported.
-   */
-  virtual int exportSelected(bool open) override;
+  int exportAll(bool open);
 
 private:
   /* Get filename from save dialog */
   QString saveHtmlFileDialog();
 
-  /* Write head and start of body */
-  void writeHtmlStart(QXmlStreamWriter& stream, const QString& cssFilename);
-
-  /* End body and html */
-  void writeHtmlEnd(QXmlStreamWriter& stream);
-
-  /* Write heading */
-  void writeHtmlHeader(QXmlStreamWriter& stream);
-
-  /* Write table header tr and th */
-  void writeHtmlTableHeader(QXmlStreamWriter& stream, const QStringList& names);
-
-  /* Write footer (exported on, etc.) */
-  void writeHtmlFooter(QXmlStreamWriter& stream);
-
-  /* Write td as is */
-  void writeHtmlTableCellRaw(QXmlStreamWriter& stream,
-                             const QString& fieldName,
-                             const QString& value,
-                             int row);
-
-  /* Write td and format it using the controller */
-  void writeHtmlTableCellFormatted(QXmlStreamWriter& stream,
-                                   const QString& fieldName,
-                                   QVariant value,
-                                   int row);
-
-  /* Write next, previous, last and first page links */
-  void writeHtmlNav(QXmlStreamWriter& stream, const QString& basename, int currentPage, int totalPages);
-
-  /* Write an anchor and href */
-  void writeHtmlLink(QXmlStreamWriter& stream, const QString& url, const QString& text);
-
-  /* Close file and write all end of page footer, etc. including table end tags */
-  void endFile(QFile& file,
-               const QString& basename,
-               QXmlStreamWriter& stream,
-               int currentPage,
-               int totalPages);
-
-  /* Open file and write all HTML headers until including table begin tags */
-  bool startFile(QFile& file,
-                 const QString& basename,
-                 QXmlStreamWriter& stream,
-                 int currentPage,
-                 int totalPages);
-
   /* Check if multiple files for paging already exist and ask user for overwrite or not */
   bool askOverwriteDialog(const QString& basename, int totalPages);
 
-  /* Get the filename for the page including page number */
-  QString filenameForPage(const QString& filename, int currentPage);
-
-#endif
-
   int pageSize = 500;
 };
 
@@ -18,6 +18,7 @@
 #include "gui/mainwindow.h"
 
 #include "common/constants.h"
+#include "export/geoexporter.h"
 #include "gui/application.h"
 #include "common/weatherreporter.h"
 #include "connect/connectclient.h"
@@ -580,6 +581,8 @@ void MainWindow::connectAllSlots()
   connect(ui->actionPrintMap, &QAction::triggered, printSupport, &PrintSupport::printMap);
   connect(ui->actionPrintFlightplan, &QAction::triggered, printSupport, &PrintSupport::printFlightplan);
   connect(ui->actionSaveMapAsImage, &QAction::triggered, this, &MainWindow::mapSaveImage);
+  connect(ui->actionRouteExportGeoJson, &QAction::triggered, this, &MainWindow::routeExportGeoJson);
+  connect(ui->actionTrackExportGeoJson, &QAction::triggered, this, &MainWindow::trackExportGeoJson);
 
   // KML actions
   connect(ui->actionLoadKml, &QAction::triggered, this, &MainWindow::kmlOpen);
@@ -767,8 +770,6 @@ void MainWindow::connectAllSlots()
   connect(connectClient, &ConnectClient::disconnectedFromSimulator,
           profileWidget, &ProfileWidget::disconnectedFromSimulator);
 
-  connect(mapWidget, &MapWidget::aircraftTrackPruned, profileWidget, &ProfileWidget::aircraftTrackPruned);
-
   connect(weatherReporter, &WeatherReporter::weatherUpdated,
           mapWidget, &MapWidget::updateTooltip);
   connect(weatherReporter, &WeatherReporter::weatherUpdated,
@@ -1286,6 +1287,49 @@ void MainWindow::mapSaveImage()
   }
 }
 
+void MainWindow::routeExportGeoJson()
+{
+  QString file = dialog->saveFileDialog(
+    tr("Export Flight Plan as GeoJSON"),
+    tr("GeoJSON Documents %1;;All Files (*)").arg(lnm::FILE_PATTERN_GEOJSON),
+    "geojson", lnm::EXPORT_FILEDIALOG, QString(),
+    QFileInfo(routeController->buildDefaultFilename()).completeBaseName() + ".geojson");
+
+  if(!file.isEmpty())
+  {
+    QString error;
+    if(GeoExporter::exportRouteGeoJson(routeController->getRouteMapObjects(), file, error))
+      setStatusMessage(tr("Flight plan exported to GeoJSON."));
+    else
+      QMessageBox::warning(this, QApplication::applicationName(),
+                           tr("Error exporting flight plan.\n%1").arg(error));
+  }
+}
+
+void MainWindow::trackExportGeoJson()
+{
+  if(mapWidget->getAircraftTrack().isEmpty())
+  {
+    setStatusMessage(tr("Aircraft trail is empty."));
+    return;
+  }
+
+  QString file = dialog->saveFileDialog(
+    tr("Export Aircraft Trail as GeoJSON"),
+    tr("GeoJSON Documents %1;;All Files (*)").arg(lnm::FILE_PATTERN_GEOJSON),
+    "geojson", lnm::EXPORT_FILEDIALOG, QString(), tr("Little Navmap Trail.geojson"));
+
+  if(!file.isEmpty())
+  {
+    QString error;
+    if(GeoExporter::exportTrackGeoJson(mapWidget->getAircraftTrack(), file, error))
+      setStatusMessage(tr("Aircraft trail exported to GeoJSON."));
+    else
+      QMessageBox::warning(this, QApplication::applicationName(),
+                           tr("Error exporting trail.\n%1").arg(error));
+  }
+}
+
 /* Selection in flight plan table has changed */
 void MainWindow::routeSelectionChanged(int selected, int total)
 {
@@ -1448,6 +1492,7 @@ void MainWindow::updateActionStates()
   ui->actionMapShowRoute->setEnabled(hasFlightplan);
   ui->actionRouteEditMode->setEnabled(hasFlightplan);
   ui->actionPrintFlightplan->setEnabled(hasFlightplan);
+  ui->actionRouteExportGeoJson->setEnabled(hasFlightplan);
 
   // Remove or add empty airport action from menu and toolbar depending on option
   if(OptionData::instance().getFlags() & opts::MAP_EMPTY_AIRPORTS)
@@ -169,6 +169,8 @@ private:
   void resetMessages();
   void showDatabaseFiles();
   void mapSaveImage();
+  void routeExportGeoJson();
+  void trackExportGeoJson();
 
   void kmlOpenRecent(const QString& kmlFile);
   void kmlOpen();
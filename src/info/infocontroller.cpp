@@ -20,6 +20,8 @@
 #include "atools.h"
 #include "common/constants.h"
 #include "common/htmlinfobuilder.h"
+#include "common/htmlinfoloader.h"
+#include "info/textdocumentfields.h"
 #include "gui/mainwindow.h"
 #include "gui/widgetstate.h"
 #include "mapgui/mapquery.h"
@@ -44,6 +46,15 @@ InfoController::InfoController(MainWindow *parent, MapQuery *mapDbQuery, InfoQue
 
   infoBuilder = new HtmlInfoBuilder(mapQuery, infoQuery, true);
 
+  // Builds texts without database access while the loader fetches the records in background
+  preliminaryBuilder = new HtmlInfoBuilder(nullptr, nullptr, true);
+  infoLoader = new HtmlInfoLoader(this, mainWindow->getDatabase(), mapQuery, infoQuery);
+
+  aircraftFields = new TextDocumentFields;
+  aircraftProgressFields = new TextDocumentFields;
+  aircraftAiFields = new TextDocumentFields;
+  connect(infoLoader, &HtmlInfoLoader::recordsLoaded, this, &InfoController::infoRecordsLoaded);
+
   Ui::MainWindow *ui = mainWindow->getUi();
   infoFontPtSize = static_cast<float>(ui->textBrowserAirportInfo->font().pointSizeF());
   simInfoFontPtSize = static_cast<float>(ui->textBrowserAircraftInfo->font().pointSizeF());
@@ -76,6 +87,10 @@ InfoController::InfoController(MainWindow *parent, MapQuery *mapDbQuery, InfoQue
 InfoController::~InfoController()
 {
   delete infoBuilder;
+  delete preliminaryBuilder;
+  delete aircraftFields;
+  delete aircraftProgressFields;
+  delete aircraftAiFields;
 }
 
 /* User clicked on "Map" link in text browsers */
@@ -165,9 +180,9 @@ void InfoController::updateAirport()
     maptypes::MapAirport ap;
     mapQuery->getAirportById(ap, currentSearchResult.airports.first().id);
 
-    infoBuilder->airportText(ap, html,
-                             &mainWindow->getRouteController()->getRouteMapObjects(),
-                             mainWindow->getWeatherReporter(), iconBackColor);
+    currentBuilder()->airportText(ap, html,
+                                  &mainWindow->getRouteController()->getRouteMapObjects(),
+                                  mainWindow->getWeatherReporter(), iconBackColor);
     mainWindow->getUi()->textBrowserAirportInfo->setText(html.getHtml());
   }
 }
@@ -195,7 +210,6 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
   qDebug() << "InfoController::showInformation";
 
   bool foundAirport = false, foundNavaid = false, foundUserAircraft = false, foundAiAircraft = false;
-  HtmlBuilder html(true);
 
   Ui::MainWindow *ui = mainWindow->getUi();
   int idx = ui->tabWidgetInformation->currentIndex();
@@ -215,76 +229,30 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
 
   if(!result.airports.isEmpty())
   {
-    // Only one airport shown
-    const maptypes::MapAirport& airport = result.airports.first();
-
     currentSearchResult.airports.clear();
     currentSearchResult.airportIds.clear();
     // Remember one airport
-    currentSearchResult.airports.append(airport);
-
-    updateAirport();
-
-    html.clear();
-    infoBuilder->runwayText(airport, html, iconBackColor);
-    ui->textBrowserRunwayInfo->setText(html.getHtml());
-
-    html.clear();
-    infoBuilder->comText(airport, html, iconBackColor);
-    ui->textBrowserComInfo->setText(html.getHtml());
-
-    html.clear();
-    infoBuilder->approachText(airport, html, iconBackColor);
-    ui->textBrowserApproachInfo->setText(html.getHtml());
-
+    currentSearchResult.airports.append(result.airports.first());
     foundAirport = true;
   }
 
   if(!result.vors.isEmpty() || !result.ndbs.isEmpty() || !result.waypoints.isEmpty() ||
      !result.airways.isEmpty())
   {
-    // if any navaids are to be shown clear search result before
-    currentSearchResult.vors.clear();
+    // if any navaids are to be shown replace all of the last search result
+    currentSearchResult.vors = result.vors;
     currentSearchResult.vorIds.clear();
-    currentSearchResult.ndbs.clear();
+    currentSearchResult.ndbs = result.ndbs;
     currentSearchResult.ndbIds.clear();
-    currentSearchResult.waypoints.clear();
+    currentSearchResult.waypoints = result.waypoints;
     currentSearchResult.waypointIds.clear();
-    currentSearchResult.airways.clear();
-  }
-
-  html.clear();
-  for(const maptypes::MapVor& vor : result.vors)
-  {
-    currentSearchResult.vors.append(vor);
-    infoBuilder->vorText(vor, html, iconBackColor);
-    ui->textBrowserNavaidInfo->setText(html.getHtml());
+    currentSearchResult.airways = result.airways;
     foundNavaid = true;
   }
 
-  for(const maptypes::MapNdb& ndb : result.ndbs)
-  {
-    currentSearchResult.ndbs.append(ndb);
-    infoBuilder->ndbText(ndb, html, iconBackColor);
-    ui->textBrowserNavaidInfo->setText(html.getHtml());
-    foundNavaid = true;
-  }
-
-  for(const maptypes::MapWaypoint& waypoint : result.waypoints)
-  {
-    currentSearchResult.waypoints.append(waypoint);
-    infoBuilder->waypointText(waypoint, html, iconBackColor);
-    ui->textBrowserNavaidInfo->setText(html.getHtml());
-    foundNavaid = true;
-  }
-
-  for(const maptypes::MapAirway& airway : result.airways)
-  {
-    currentSearchResult.airways.append(airway);
-    infoBuilder->airwayText(airway, html);
-    ui->textBrowserNavaidInfo->setText(html.getHtml());
-    foundNavaid = true;
-  }
+  // Start fetching runways, COM frequencies, approaches, etc. in background if not cached already
+  infoLoader->load(HtmlInfoLoader::objectRefs(currentSearchResult));
+  updateInfoTexts(foundAirport, foundNavaid);
 
   // Show dock windows if needed
   if(showWindows)
@@ -339,8 +307,78 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
     ui->tabWidgetAircraft->setCurrentIndex(ic::AIRCRAFT_AI);
 }
 
+/* Records for all tabs were loaded in background - replace the preliminary texts */
+void InfoController::infoRecordsLoaded()
+{
+  if(!databaseLoadStatus)
+    updateInfoTexts(true, true);
+}
+
+/* Build texts for the airport and navaid tabs from the current search result */
+void InfoController::updateInfoTexts(bool airport, bool navaids)
+{
+  Ui::MainWindow *ui = mainWindow->getUi();
+  const HtmlInfoBuilder *builder = currentBuilder();
+  HtmlBuilder html(true);
+
+  if(airport && !currentSearchResult.airports.isEmpty())
+  {
+    const maptypes::MapAirport& ap = currentSearchResult.airports.first();
+
+    updateAirport();
+
+    html.clear();
+    if(infoLoader->isLoading())
+      builder->loadingText(ap, html, iconBackColor);
+    else
+      builder->runwayText(ap, html, iconBackColor);
+    ui->textBrowserRunwayInfo->setText(html.getHtml());
+
+    html.clear();
+    if(infoLoader->isLoading())
+      builder->loadingText(ap, html, iconBackColor);
+    else
+      builder->comText(ap, html, iconBackColor);
+    ui->textBrowserComInfo->setText(html.getHtml());
+
+    html.clear();
+    if(infoLoader->isLoading())
+      builder->loadingText(ap, html, iconBackColor);
+    else
+      builder->approachText(ap, html, iconBackColor);
+    ui->textBrowserApproachInfo->setText(html.getHtml());
+  }
+
+  if(navaids)
+  {
+    html.clear();
+    for(const maptypes::MapVor& vor : currentSearchResult.vors)
+      builder->vorText(vor, html, iconBackColor);
+
+    for(const maptypes::MapNdb& ndb : currentSearchResult.ndbs)
+      builder->ndbText(ndb, html, iconBackColor);
+
+    for(const maptypes::MapWaypoint& waypoint : currentSearchResult.waypoints)
+      builder->waypointText(waypoint, html, iconBackColor);
+
+    for(const maptypes::MapAirway& airway : currentSearchResult.airways)
+      builder->airwayText(airway, html);
+
+    if(!html.isEmpty())
+      ui->textBrowserNavaidInfo->setText(html.getHtml());
+  }
+}
+
+/* Use a builder without database access while records are loaded to keep the GUI responsive */
+const HtmlInfoBuilder *InfoController::currentBuilder() const
+{
+  return infoLoader->isLoading() ? preliminaryBuilder : infoBuilder;
+}
+
 void InfoController::preDatabaseLoad()
 {
+  infoLoader->preDatabaseLoad();
+
   // Clear current airport and navaids result
   currentSearchResult = maptypes::MapSearchResult();
   databaseLoadStatus = true;
@@ -363,8 +401,10 @@ void InfoController::simulatorDataReceived(atools::fs::sc::SimConnectData data)
     {
       updateAiAirports(data);
 
-      // Last update was more than 500 ms ago
+      // Last update was more than MIN_SIM_UPDATE_TIME_MS ago
+      // Values are written directly into the documents - HTML is only built if the layout changes
       HtmlBuilder html(true /* has background color */);
+      const RouteMapObjectList& rmoList = mainWindow->getRouteController()->getRouteMapObjects();
 
       if(ui->dockWidgetAircraft->isVisible())
       {
@@ -372,37 +412,63 @@ void InfoController::simulatorDataReceived(atools::fs::sc::SimConnectData data)
            canTextEditUpdate(ui->textBrowserAircraftInfo))
         {
           // ok - scrollbars not pressed
-          infoBuilder->aircraftText(data.getUserAircraft(), html);
-          infoBuilder->aircraftTextWeightAndFuel(data.getUserAircraft(), html);
-          updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml());
+          InfoFields fields;
+          infoBuilder->aircraftText(data.getUserAircraft(), fields);
+          infoBuilder->aircraftTextWeightAndFuel(data.getUserAircraft(), fields);
+
+          if(!aircraftFields->update(fields))
+          {
+            infoBuilder->aircraftText(data.getUserAircraft(), html);
+            infoBuilder->aircraftTextWeightAndFuel(data.getUserAircraft(), html);
+            updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml());
+            aircraftFields->reset(ui->textBrowserAircraftInfo->document(), fields);
+          }
         }
 
         if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_USER_PROGRESS &&
            canTextEditUpdate(ui->textBrowserAircraftProgressInfo))
         {
           // ok - scrollbars not pressed
-          html.clear();
-          infoBuilder->aircraftProgressText(data.getUserAircraft(), html,
-                                            mainWindow->getRouteController()->getRouteMapObjects());
-          updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml());
+          InfoFields fields;
+          infoBuilder->aircraftProgressText(data.getUserAircraft(), fields, rmoList);
+
+          if(!aircraftProgressFields->update(fields))
+          {
+            html.clear();
+            infoBuilder->aircraftProgressText(data.getUserAircraft(), html, rmoList);
+            updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml());
+            aircraftProgressFields->reset(ui->textBrowserAircraftProgressInfo->document(), fields);
+          }
         }
 
         if(ui->tabWidgetAircraft->currentIndex() == ic::AIRCRAFT_AI &&
            canTextEditUpdate(ui->textBrowserAircraftAiInfo))
         {
           // ok - scrollbars not pressed
-          html.clear();
           if(!currentSearchResult.aiAircraft.isEmpty())
           {
+            InfoFields fields;
             int num = 1;
             for(const SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
             {
-              infoBuilder->aircraftText(aircraft, html, num, lastSimData.getAiAircraft().size());
-              infoBuilder->aircraftProgressText(aircraft, html,
-                                                mainWindow->getRouteController()->getRouteMapObjects());
+              infoBuilder->aircraftText(aircraft, fields, num, lastSimData.getAiAircraft().size());
+              infoBuilder->aircraftProgressText(aircraft, fields, rmoList);
               num++;
             }
-            updateTextEdit(ui->textBrowserAircraftAiInfo, html.getHtml());
+
+            if(!aircraftAiFields->update(fields))
+            {
+              html.clear();
+              num = 1;
+              for(const SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
+              {
+                infoBuilder->aircraftText(aircraft, html, num, lastSimData.getAiAircraft().size());
+                infoBuilder->aircraftProgressText(aircraft, html, rmoList);
+                num++;
+              }
+              updateTextEdit(ui->textBrowserAircraftAiInfo, html.getHtml());
+              aircraftAiFields->reset(ui->textBrowserAircraftAiInfo->document(), fields);
+            }
           }
           else
           {
@@ -27,6 +27,8 @@ class MainWindow;
 class MapQuery;
 class InfoQuery;
 class HtmlInfoBuilder;
+class HtmlInfoLoader;
+class TextDocumentFields;
 class QTextEdit;
 namespace ic {
 enum TabIndex
@@ -95,8 +97,8 @@ signals:
   void showRect(const atools::geo::Rect& rect);
 
 private:
-  /* Do not update aircraft information more than every 0.5 seconds */
-  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 500;
+  /* Do not update aircraft information more than every 0.1 seconds */
+  static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 100;
 
   void updateTextEditFontSizes();
   bool canTextEditUpdate(const QTextEdit *textEdit);
@@ -105,6 +107,9 @@ private:
   void anchorClicked(const QUrl& url);
   void clearInfoTextBrowsers();
   void showInformationInternal(maptypes::MapSearchResult result, bool showWindows);
+  void updateInfoTexts(bool airport, bool navaids);
+  void infoRecordsLoaded();
+  const HtmlInfoBuilder *currentBuilder() const;
   void updateAiAirports(const atools::fs::sc::SimConnectData& data);
 
   bool databaseLoadStatus = false;
@@ -119,6 +124,13 @@ private:
   QColor iconBackColor;
   HtmlInfoBuilder *infoBuilder;
 
+  /* Used to build texts without database access while infoLoader fetches records in background */
+  HtmlInfoBuilder *preliminaryBuilder;
+  HtmlInfoLoader *infoLoader;
+
+  /* Write changed values into the aircraft text browsers without building HTML */
+  TextDocumentFields *aircraftFields, *aircraftProgressFields, *aircraftAiFields;
+
   float simInfoFontPtSize = 10.f, infoFontPtSize = 10.f;
 };
 
@@ -102,6 +102,111 @@ atools::sql::SqlRecordVector InfoQuery::getAirwayWaypointInformation(const QStri
   return rec;
 }
 
+template<typename TYPE>
+void InfoQuery::fetchedRecord(QHash<int, TYPE>& hash, int id, const TYPE *rec)
+{
+  hash.insert(id, rec != nullptr ? *rec : TYPE());
+}
+
+template<typename TYPE>
+void InfoQuery::insertCached(QCache<int, TYPE>& cache, const QHash<int, TYPE>& hash)
+{
+  for(auto it = hash.constBegin(); it != hash.constEnd(); ++it)
+    cache.insert(it.key(), new TYPE(it.value()));
+}
+
+void InfoQuery::fetchRecords(const maptypes::MapObjectRefList& refs, InfoQueryRecords& records)
+{
+  for(const maptypes::MapObjectRef& ref : refs)
+  {
+    if(ref.type == maptypes::AIRPORT)
+    {
+      fetchedRecord(records.airports, ref.id, getAirportInformation(ref.id));
+      fetchedRecord(records.coms, ref.id, getComInformation(ref.id));
+
+      const SqlRecordVector *runways = getRunwayInformation(ref.id);
+      fetchedRecord(records.runways, ref.id, runways);
+      if(runways != nullptr)
+      {
+        for(const SqlRecord& runway : *runways)
+        {
+          for(int endId : {runway.valueInt("primary_end_id"), runway.valueInt("secondary_end_id")})
+          {
+            fetchedRecord(records.runwayEnds, endId, getRunwayEndInformation(endId));
+            fetchedRecord(records.ils, endId, getIlsInformation(endId));
+          }
+        }
+      }
+
+      const SqlRecordVector *approaches = getApproachInformation(ref.id);
+      fetchedRecord(records.approaches, ref.id, approaches);
+      if(approaches != nullptr)
+      {
+        for(const SqlRecord& approach : *approaches)
+        {
+          int approachId = approach.valueInt("approach_id");
+          fetchedRecord(records.transitions, approachId, getTransitionInformation(approachId));
+        }
+      }
+    }
+    else if(ref.type == maptypes::VOR)
+      fetchedRecord(records.vors, ref.id, getVorInformation(ref.id));
+    else if(ref.type == maptypes::NDB)
+      fetchedRecord(records.ndbs, ref.id, getNdbInformation(ref.id));
+    else if(ref.type == maptypes::WAYPOINT)
+      fetchedRecord(records.waypoints, ref.id, getWaypointInformation(ref.id));
+  }
+}
+
+bool InfoQuery::hasRecords(const maptypes::MapObjectRefList& refs)
+{
+  for(const maptypes::MapObjectRef& ref : refs)
+  {
+    if(ref.type == maptypes::AIRPORT)
+    {
+      if(!airportCache.contains(ref.id) || !comCache.contains(ref.id) ||
+         !runwayCache.contains(ref.id) || !approachCache.contains(ref.id))
+        return false;
+
+      for(const SqlRecord& runway : *runwayCache.object(ref.id))
+      {
+        for(int endId : {runway.valueInt("primary_end_id"), runway.valueInt("secondary_end_id")})
+        {
+          if(!runwayEndCache.contains(endId) || !ilsCache.contains(endId))
+            return false;
+        }
+      }
+
+      for(const SqlRecord& approach : *approachCache.object(ref.id))
+      {
+        if(!transitionCache.contains(approach.valueInt("approach_id")))
+          return false;
+      }
+    }
+    else if(ref.type == maptypes::VOR && !vorCache.contains(ref.id))
+      return false;
+    else if(ref.type == maptypes::NDB && !ndbCache.contains(ref.id))
+      return false;
+    else if(ref.type == maptypes::WAYPOINT && !waypointCache.contains(ref.id))
+      return false;
+  }
+  return true;
+}
+
+void InfoQuery::insertRecords(const InfoQueryRecords& records)
+{
+  insertCached(airportCache, records.airports);
+  insertCached(vorCache, records.vors);
+  insertCached(ndbCache, records.ndbs);
+  insertCached(waypointCache, records.waypoints);
+  insertCached(runwayEndCache, records.runwayEnds);
+  insertCached(ilsCache, records.ils);
+  insertCached(comCache, records.coms);
+  insertCached(runwayCache, records.runways);
+  insertCached(approachCache, records.approaches);
+  insertCached(transitionCache, records.transitions);
+}
+
 /* Get a record from the cache of get it from a database query */
 const SqlRecord *InfoQuery::cachedRecord(QCache<int, SqlRecord>& cache, SqlQuery *query, int id)
 {
@@ -18,7 +18,11 @@
 #ifndef LITTLENAVMAP_INFOQUERY_H
 #define LITTLENAVMAP_INFOQUERY_H
 
+#include "common/maptypes.h"
+#include "sql/sqlrecord.h"
+
 #include <QCache>
+#include <QHash>
 #include <QObject>
 
 namespace atools {
@@ -30,6 +34,17 @@ class SqlRecordVector;
 }
 }
 
+/*
+ * Records needed to describe airports and navaids in the information panel. Filled by an InfoQuery with
+ * its own connection in a worker thread and then copied into the caches of the InfoQuery in the GUI thread.
+ * Empty records and vectors indicate that nothing was found.
+ */
+struct InfoQueryRecords
+{
+  QHash<int, atools::sql::SqlRecord> airports, vors, ndbs, waypoints, runwayEnds, ils;
+  QHash<int, atools::sql::SqlRecordVector> coms, runways, approaches, transitions;
+};
+
 /*
  * Database queries for the info controller. Does not return objects but sql records. Records are cached.
  */
@@ -79,6 +94,16 @@ public:
   /* Get record for table transition */
   const atools::sql::SqlRecordVector *getTransitionInformation(int approachId);
 
+  /* Run all queries needed to describe the airports, VORs, NDBs and waypoints in refs including runways,
+   * runway ends, ILS, COM frequencies, approaches and transitions and copy the results into records. */
+  void fetchRecords(const maptypes::MapObjectRefList& refs, InfoQueryRecords& records);
+
+  /* @return true if all records needed for refs are in the cache */
+  bool hasRecords(const maptypes::MapObjectRefList& refs);
+
+  /* Add records fetched by another InfoQuery to the caches */
+  void insertRecords(const InfoQueryRecords& records);
+
   /* Create all queries */
   void initQueries();
 
@@ -92,6 +117,13 @@ private:
   const atools::sql::SqlRecordVector *cachedRecordVector(QCache<int, atools::sql::SqlRecordVector>& cache,
                                                          atools::sql::SqlQuery *query, int id);
 
+  /* Copy a record or vector returned by one of the get methods into the hash. Null is stored as empty. */
+  template<typename TYPE>
+  static void fetchedRecord(QHash<int, TYPE>& hash, int id, const TYPE *rec);
+
+  template<typename TYPE>
+  static void insertCached(QCache<int, TYPE>& cache, const QHash<int, TYPE>& hash);
+
   /* Caches */
   QCache<int, atools::sql::SqlRecord> airportCache, vorCache, ndbCache, waypointCache, airwayCache,
                                       runwayEndCache, ilsCache;
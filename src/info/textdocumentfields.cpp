@@ -0,0 +1,146 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "info/textdocumentfields.h"
+
+#include "common/htmlinfobuilder.h"
+
+#include <QDebug>
+#include <QTextBlock>
+#include <QTextFrame>
+
+void TextDocumentFields::reset(QTextDocument *textDocument, const InfoFields& fields)
+{
+  document = textDocument;
+  cells.clear();
+  linkCursors.clear();
+  layout = fields.layout;
+  values = fields.values;
+  links = fields.links;
+
+  collectCells(document->rootFrame());
+
+  // Get all links in order of appearance
+  for(QTextBlock block = document->begin(); block.isValid(); block = block.next())
+  {
+    for(QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it)
+    {
+      QTextFragment fragment = it.fragment();
+      if(fragment.charFormat().isAnchor())
+      {
+        QTextCursor cursor(document);
+        cursor.setPosition(fragment.position());
+        cursor.setPosition(fragment.position() + fragment.length(), QTextCursor::KeepAnchor);
+        linkCursors.append(cursor);
+      }
+    }
+  }
+
+  // Tables are needed to detect if the document was set again
+  valid = !cells.isEmpty() && cells.size() == values.size() && linkCursors.size() == links.size();
+  if(!valid)
+    qWarning() << "Document does not match fields: cells" << cells.size() << "values" << values.size()
+               << "links" << linkCursors.size() << links.size();
+}
+
+bool TextDocumentFields::update(const InfoFields& fields)
+{
+  if(!valid || document.isNull() || fields.layout != layout)
+    return false;
+
+  // All tables are deleted if the document was cleared or set again
+  for(const Cell& cell : cells)
+  {
+    if(cell.table.isNull())
+      return false;
+  }
+
+  QTextCursor editCursor(document);
+  editCursor.beginEditBlock();
+  for(int i = 0; i < cells.size(); i++)
+  {
+    if(fields.values.at(i) != values.at(i))
+      writeCell(cells.at(i), fields.values.at(i));
+  }
+
+  for(int i = 0; i < linkCursors.size(); i++)
+  {
+    if(fields.links.at(i) != links.at(i))
+    {
+      QTextCharFormat format;
+      format.setAnchorHref(fields.links.at(i));
+      linkCursors[i].mergeCharFormat(format);
+    }
+  }
+  editCursor.endEditBlock();
+
+  values = fields.values;
+  links = fields.links;
+  return true;
+}
+
+void TextDocumentFields::collectCells(QTextFrame *frame)
+{
+  for(QTextFrame *child : frame->childFrames())
+  {
+    QTextTable *table = qobject_cast<QTextTable *>(child);
+    if(table != nullptr && table->columns() == 2)
+    {
+      for(int row = 0; row < table->rows(); row++)
+      {
+        // Use format of the first character or the cell format if the cell is empty
+        QTextTableCell tableCell = table->cellAt(row, 1);
+        QTextCursor cursor = tableCell.firstCursorPosition();
+        if(cursor < tableCell.lastCursorPosition())
+          cursor.movePosition(QTextCursor::NextCharacter);
+        cells.append({table, row, cursor.charFormat()});
+      }
+    }
+    else
+      collectCells(child);
+  }
+}
+
+void TextDocumentFields::writeCell(const Cell& cell, const QString& value)
+{
+  QTextTableCell tableCell = cell.table->cellAt(cell.row, 1);
+  QTextCursor cursor = tableCell.firstCursorPosition();
+  cursor.setPosition(tableCell.lastCursorPosition().position(), QTextCursor::KeepAnchor);
+  cursor.removeSelectedText();
+
+  QTextCharFormat boldFormat(cell.format);
+  boldFormat.setFontWeight(QFont::Bold);
+
+  // Insert runs of normal and bold text
+  QString text;
+  bool bold = false;
+  for(QChar c : value)
+  {
+    bool boldChar = InfoFields::BOLD_CHARACTERS.contains(c);
+    if(boldChar != bold && !text.isEmpty())
+    {
+      cursor.insertText(text, bold ? boldFormat : cell.format);
+      text.clear();
+    }
+    bold = boldChar;
+    text += c;
+  }
+
+  if(!text.isEmpty())
+    cursor.insertText(text, bold ? boldFormat : cell.format);
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_TEXTDOCUMENTFIELDS_H
+#define LITTLENAVMAP_TEXTDOCUMENTFIELDS_H
+
+#include <QPointer>
+#include <QStringList>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTextTable>
+#include <QVector>
+
+struct InfoFields;
+
+/*
+ * Updates a shown text document that was built once from the HTML of HtmlInfoBuilder.
+ *
+ * Keeps handles to the value cells (second column of all two column tables) and to the links of the
+ * document. New values are written directly into the cells as long as the layout of the fields does not
+ * change. This avoids generating and parsing HTML and a complete relayout for each update. Used for the
+ * aircraft information panels.
+ */
+class TextDocumentFields
+{
+public:
+  /*
+   * Collect the value cells and links. The document has to be set from HTML that was built with the
+   * same data as fields.
+   */
+  void reset(QTextDocument *textDocument, const InfoFields& fields);
+
+  /*
+   * Write changed values and links into the document.
+   * @return false if the layout has changed or the document was cleared or set again. The document is
+   * not changed in this case and the caller has to build the HTML and call reset.
+   */
+  bool update(const InfoFields& fields);
+
+private:
+  /* Value cell of a table row */
+  struct Cell
+  {
+    QPointer<QTextTable> table;
+    int row;
+    QTextCharFormat format; /* Format of the value text */
+  };
+
+  void collectCells(QTextFrame *frame);
+  void writeCell(const Cell& cell, const QString& value);
+
+  QPointer<QTextDocument> document;
+  QVector<Cell> cells;
+  QVector<QTextCursor> linkCursors;
+
+  /* State of the document */
+  QStringList layout, values, links;
+  bool valid = false;
+};
+
+#endif // LITTLENAVMAP_TEXTDOCUMENTFIELDS_H
@@ -0,0 +1,192 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/maplabelplacer.h"
+
+#include <QPainter>
+
+#include <algorithm>
+
+/* Sides to try for each preferred side */
+static const textplace::Side SIDE_ORDER[4][4] =
+{
+  {textplace::RIGHT_SIDE, textplace::LEFT_SIDE, textplace::BOTTOM_SIDE, textplace::TOP_SIDE},
+  {textplace::LEFT_SIDE, textplace::RIGHT_SIDE, textplace::BOTTOM_SIDE, textplace::TOP_SIDE},
+  {textplace::BOTTOM_SIDE, textplace::TOP_SIDE, textplace::RIGHT_SIDE, textplace::LEFT_SIDE},
+  {textplace::TOP_SIDE, textplace::BOTTOM_SIDE, textplace::RIGHT_SIDE, textplace::LEFT_SIDE}
+};
+
+MapLabelPlacer::MapLabelPlacer()
+{
+  symbolPainter = new SymbolPainter();
+}
+
+MapLabelPlacer::~MapLabelPlacer()
+{
+  delete symbolPainter;
+}
+
+void MapLabelPlacer::reset(int width, int height)
+{
+  for(QVector<Label>& bucket : labels)
+    bucket.clear();
+
+  screenWidth = width;
+  screenHeight = height;
+  gridWidth = width / GRID_CELL_SIZE + 1;
+  gridHeight = height / GRID_CELL_SIZE + 1;
+
+  if(grid.size() != gridWidth * gridHeight)
+    grid.resize(gridWidth * gridHeight);
+  grid.fill(false);
+}
+
+void MapLabelPlacer::addLabel(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y,
+                              int offset, textplace::Side side, textplace::Priority priority,
+                              textatt::TextAttributes atts, int transparency)
+{
+  if(texts.isEmpty())
+    return;
+
+  Label label;
+  label.texts = texts;
+  label.pen = textPen;
+  label.font = painter->font();
+  label.x = x;
+  label.y = y;
+  label.offset = offset;
+  label.transparency = transparency;
+  label.side = side;
+  label.atts = atts & ~(textatt::LEFT | textatt::RIGHT | textatt::CENTER);
+
+  // Use the same font attributes as SymbolPainter::textBox to get the right size
+  label.font.setBold(atts.testFlag(textatt::BOLD));
+  label.font.setItalic(atts.testFlag(textatt::ITALIC));
+  label.font.setUnderline(atts.testFlag(textatt::UNDERLINE));
+
+  labels[priority].append(label);
+}
+
+void MapLabelPlacer::drawLabels(QPainter *painter)
+{
+  painter->save();
+
+  // Buckets are already in priority order
+  for(QVector<Label>& bucket : labels)
+  {
+    for(const Label& label : bucket)
+    {
+      QFontMetrics metrics(label.font);
+
+      int textWidth = 0;
+      for(const QString& text : label.texts)
+        textWidth = std::max(textWidth, metrics.width(text) + 2);
+
+      // Try preferred side first and then all others
+      for(textplace::Side side : SIDE_ORDER[label.side])
+      {
+        int x, y;
+        textatt::TextAttributes atts;
+        QRect rect = labelRect(label, side, metrics, textWidth, x, y, atts);
+
+        if(!rect.isNull() && isFree(rect))
+        {
+          occupy(rect);
+          painter->setFont(label.font);
+          symbolPainter->textBox(painter, label.texts, label.pen, x, y, atts, label.transparency);
+          break;
+        }
+      }
+    }
+    bucket.clear();
+  }
+
+  painter->restore();
+}
+
+QRect MapLabelPlacer::labelRect(const Label& label, textplace::Side side, const QFontMetrics& metrics,
+                                int textWidth, int& x, int& y, textatt::TextAttributes& atts) const
+{
+  x = label.x;
+  y = label.y;
+  atts = label.atts;
+
+  int left = x;
+  switch(side)
+  {
+    case textplace::RIGHT_SIDE:
+      x += label.offset;
+      atts |= textatt::LEFT;
+      left = x;
+      break;
+    case textplace::LEFT_SIDE:
+      x -= label.offset;
+      atts |= textatt::RIGHT;
+      left = x - textWidth;
+      break;
+    case textplace::BOTTOM_SIDE:
+      y += label.offset + metrics.ascent();
+      atts |= textatt::CENTER;
+      left = x - textWidth / 2;
+      break;
+    case textplace::TOP_SIDE:
+      y -= label.offset + (label.texts.size() - 1) * metrics.height() + metrics.descent();
+      atts |= textatt::CENTER;
+      left = x - textWidth / 2;
+      break;
+  }
+
+  // Same geometry as the background rectangles in SymbolPainter::textBox
+  QRect rect(left, y - metrics.ascent() - 1, textWidth, label.texts.size() * metrics.height());
+
+  if(!rect.intersects(QRect(0, 0, screenWidth, screenHeight)))
+    return QRect();
+
+  return rect;
+}
+
+bool MapLabelPlacer::isFree(const QRect& rect) const
+{
+  int x1 = std::max(rect.left() / GRID_CELL_SIZE, 0);
+  int x2 = std::min(rect.right() / GRID_CELL_SIZE, gridWidth - 1);
+  int y1 = std::max(rect.top() / GRID_CELL_SIZE, 0);
+  int y2 = std::min(rect.bottom() / GRID_CELL_SIZE, gridHeight - 1);
+
+  for(int gy = y1; gy <= y2; gy++)
+  {
+    int row = gy * gridWidth;
+    for(int gx = x1; gx <= x2; gx++)
+      if(grid.testBit(row + gx))
+        return false;
+  }
+  return true;
+}
+
+void MapLabelPlacer::occupy(const QRect& rect)
+{
+  int x1 = std::max(rect.left() / GRID_CELL_SIZE, 0);
+  int x2 = std::min(rect.right() / GRID_CELL_SIZE, gridWidth - 1);
+  int y1 = std::max(rect.top() / GRID_CELL_SIZE, 0);
+  int y2 = std::min(rect.bottom() / GRID_CELL_SIZE, gridHeight - 1);
+
+  for(int gy = y1; gy <= y2; gy++)
+  {
+    int row = gy * gridWidth;
+    for(int gx = x1; gx <= x2; gx++)
+      grid.setBit(row + gx);
+  }
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_MAPLABELPLACER_H
+#define LITTLENAVMAP_MAPLABELPLACER_H
+
+#include "common/symbolpainter.h"
+
+#include <QBitArray>
+#include <QFont>
+#include <QPen>
+#include <QStringList>
+#include <QVector>
+
+class QPainter;
+
+/*
+ * Collects symbol texts during a paint cycle and draws them afterwards avoiding overlap.
+ * Labels are placed in priority order (route, airports by size, navaids) into a screen occupancy grid.
+ * Each label tries the preferred side of its symbol first and then the other sides.
+ * Labels that do not fit anywhere are skipped.
+ *
+ * Runtime is linear in the number of labels since labels are sorted into fixed priority buckets and
+ * each placement check touches only the grid cells covered by the label.
+ */
+class MapLabelPlacer
+{
+public:
+  MapLabelPlacer();
+  ~MapLabelPlacer();
+
+  /* Remove all labels and clear the occupancy grid. Call before each paint cycle.
+   * @param width,height Screen size in pixel */
+  void reset(int width, int height);
+
+  /* Add a text label for a symbol at x and y. Painter is used to get the current font.
+   * @param offset distance from symbol center to text
+   * @param side preferred side for the text */
+  void addLabel(QPainter *painter, const QStringList& texts, const QPen& textPen, int x, int y, int offset,
+                textplace::Side side, textplace::Priority priority, textatt::TextAttributes atts,
+                int transparency);
+
+  /* Place and draw all collected labels and remove them afterwards */
+  void drawLabels(QPainter *painter);
+
+private:
+  struct Label
+  {
+    QStringList texts;
+    QPen pen;
+    QFont font;
+    int x, y, offset, transparency;
+    textplace::Side side;
+    textatt::TextAttributes atts;
+  };
+
+  /* Get text box rectangle and text position for a side. Returns a null rectangle if not on screen. */
+  QRect labelRect(const Label& label, textplace::Side side, const QFontMetrics& metrics, int textWidth,
+                  int& x, int& y, textatt::TextAttributes& atts) const;
+
+  /* true if none of the grid cells covered by the rectangle is occupied */
+  bool isFree(const QRect& rect) const;
+
+  /* Mark all grid cells covered by the rectangle as occupied */
+  void occupy(const QRect& rect);
+
+  /* Pixel size of a grid cell */
+  static Q_DECL_CONSTEXPR int GRID_CELL_SIZE = 4;
+
+  QVector<Label> labels[textplace::NUM_PRIORITIES];
+
+  /* Occupancy grid - one bit per cell */
+  QBitArray grid;
+  int gridWidth = 0, gridHeight = 0, screenWidth = 0, screenHeight = 0;
+
+  SymbolPainter *symbolPainter;
+};
+
+#endif // LITTLENAVMAP_MAPLABELPLACER_H
@@ -38,6 +38,7 @@ class GeoPainter;
 }
 
 class SymbolPainter;
+class MapLabelPlacer;
 class MapLayer;
 class MapQuery;
 class MapScale;
@@ -58,6 +59,7 @@ struct PaintContext
   QFont defaultFont /* Default widget font */,
         defaultFontScaled /* Default widget font scaled by option settings */;
   float symbolScale = 1.0f; /* Symbol size scale factor */
+  MapLabelPlacer *labelPlacer = nullptr; /* Collects symbol texts to avoid overlapping */
 
   /* Calculate real symbol size */
   int symSize(int size) const
@@ -70,7 +70,7 @@ void MapPainterAircraft::render(const PaintContext *context)
   context->painter->save();
 
   if(context->objectTypes.testFlag(maptypes::AIRCRAFT_TRACK))
-    paintAircraftTrack(context->painter);
+    paintAircraftTrack(context);
 
   if(mapWidget->distance() < DISTANCE_CUT_OFF_AI_LIMIT)
   {
@@ -148,66 +148,103 @@ void MapPainterAircraft::paintUserAircraft(const PaintContext *context,
   }
 }
 
-void MapPainterAircraft::paintAircraftTrack(GeoPainter *painter)
+void MapPainterAircraft::paintAircraftTrack(const PaintContext *context)
 {
   const AircraftTrack& aircraftTrack = mapWidget->getAircraftTrack();
 
   if(!aircraftTrack.isEmpty())
   {
-    QPolygon polyline;
-
+    GeoPainter *painter = context->painter;
     painter->setPen(mapcolors::aircraftTrackPen);
-    bool lastVisible = false;
-
-    int x1, y1;
-    int x2 = -1, y2 = -1;
     QRect vpRect(painter->viewport());
-    wToS(aircraftTrack.first().pos, x1, y1);
-
-    for(int i = 1; i < aircraftTrack.size(); i++)
-    {
-      const at::AircraftTrackPos& trackPos = aircraftTrack.at(i);
-      wToS(trackPos.pos, x2, y2);
 
-      QRect rect(QPoint(x1, y1), QPoint(x2, y2));
-      rect = rect.normalized();
-      rect.adjust(-1, -1, 1, 1);
+    // Use a simplified track depending on zoom distance
+    float pixelPerKm = scale->getPixelForMeter(1000.f);
+    int level = pixelPerKm > 0.f ? AircraftTrack::levelForResolution(1000.f / pixelPerKm) : 0;
 
-      // Current line is visible (most likely)
-      bool nowVisible = rect.intersects(vpRect);
-
-      if(lastVisible || nowVisible)
+    const QVector<at::AircraftTrackChunk>& chunks = aircraftTrack.getChunks();
+    QVector<QPoint> points;
+    for(int c = 0; c < chunks.size(); c++)
+    {
+      const at::AircraftTrackChunk& chunk = chunks.at(c);
+      if(!chunk.bounding.overlaps(context->viewportRect))
+        // Chunk is not visible
+        continue;
+
+      // Get screen coordinates for the chunk and the first point of the next one
+      points.clear();
+      int x, y;
+      for(int i = 0; i < chunk.size(level); i++)
       {
-        if(!polyline.isEmpty())
-        {
-          const QPoint& lastPt = polyline.last();
-          // Last line or this one are visible add coords
-          if(atools::geo::manhattanDistance(lastPt.x(), lastPt.y(), x2, y2) > AIRCRAFT_TRACK_MIN_LINE_LENGTH)
-            polyline.append(QPoint(x1, y1));
-        }
-        else
-          // Always add first visible point
-          polyline.append(QPoint(x1, y1));
+        wToS(chunk.at(level, i).pos, x, y);
+        points.append(QPoint(x, y));
       }
 
-      if(lastVisible && !nowVisible)
+      if(c < chunks.size() - 1)
       {
-        // Not visible anymore draw previous line segment
-        painter->drawPolyline(polyline);
-        polyline.clear();
+        wToS(chunks.at(c + 1).positions.first().pos, x, y);
+        points.append(QPoint(x, y));
       }
 
-      lastVisible = nowVisible;
-      x1 = x2;
-      y1 = y2;
+      paintTrackPoints(painter, vpRect, points);
+    }
+  }
+}
+
+void MapPainterAircraft::paintTrackPoints(GeoPainter *painter, const QRect& vpRect, const QVector<QPoint>& points)
+{
+  if(points.isEmpty())
+    return;
+
+  QPolygon polyline;
+  bool lastVisible = false;
+
+  int x1 = points.first().x(), y1 = points.first().y();
+  int x2 = -1, y2 = -1;
+
+  for(int i = 1; i < points.size(); i++)
+  {
+    x2 = points.at(i).x();
+    y2 = points.at(i).y();
+
+    QRect rect(QPoint(x1, y1), QPoint(x2, y2));
+    rect = rect.normalized();
+    rect.adjust(-1, -1, 1, 1);
+
+    // Current line is visible (most likely)
+    bool nowVisible = rect.intersects(vpRect);
+
+    if(lastVisible || nowVisible)
+    {
+      if(!polyline.isEmpty())
+      {
+        const QPoint& lastPt = polyline.last();
+        // Last line or this one are visible add coords
+        if(atools::geo::manhattanDistance(lastPt.x(), lastPt.y(), x2, y2) > AIRCRAFT_TRACK_MIN_LINE_LENGTH)
+          polyline.append(QPoint(x1, y1));
+      }
+      else
+        // Always add first visible point
+        polyline.append(QPoint(x1, y1));
     }
 
-    // Draw rest
-    if(!polyline.isEmpty())
+    if(lastVisible && !nowVisible)
     {
-      polyline.append(QPoint(x2, y2));
+      // Not visible anymore draw previous line segment
       painter->drawPolyline(polyline);
+      polyline.clear();
     }
+
+    lastVisible = nowVisible;
+    x1 = x2;
+    y1 = y2;
+  }
+
+  // Draw rest
+  if(!polyline.isEmpty())
+  {
+    polyline.append(QPoint(x2, y2));
+    painter->drawPolyline(polyline);
   }
 }
 
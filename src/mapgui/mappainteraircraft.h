@@ -71,7 +71,10 @@ public:
   };
 
 private:
-  void paintAircraftTrack(Marble::GeoPainter *painter);
+  void paintAircraftTrack(const PaintContext *context);
+
+  /* Draw a part of the track and omit invisible or too short lines */
+  void paintTrackPoints(Marble::GeoPainter *painter, const QRect& vpRect, const QVector<QPoint>& points);
   void paintUserAircraft(const PaintContext *context,
                          const atools::fs::sc::SimConnectUserAircraft& userAircraft);
   void paintAiAircraft(const PaintContext *context,
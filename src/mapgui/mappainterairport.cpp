@@ -48,6 +48,8 @@ MapPainterAirport::~MapPainterAirport()
 
 void MapPainterAirport::render(const PaintContext *context)
 {
+  symbolPainter->setLabelPlacer(context->labelPlacer);
+
   // Get all airports from the route and add them to the map
   QHash<int, const MapAirport *> airportMap; // Collect all airports from route and bounding rectangle
   QSet<int> routeAirportIds; // Airport ids from departure and destination
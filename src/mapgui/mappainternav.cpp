@@ -21,6 +21,7 @@
 #include "common/mapcolors.h"
 #include "mapgui/mapwidget.h"
 
+#include <QBitArray>
 #include <QElapsedTimer>
 
 #include <marble/GeoDataLineString.h>
@@ -42,6 +43,8 @@ MapPainterNav::~MapPainterNav()
 
 void MapPainterNav::render(const PaintContext *context)
 {
+  symbolPainter->setLabelPlacer(context->labelPlacer);
+
   const GeoDataLatLonAltBox& curBox = context->viewport->viewLatLonAltBox();
 
   setRenderHints(context->painter);
@@ -98,101 +101,91 @@ void MapPainterNav::paintAirways(const PaintContext *context, const QList<MapAir
 {
   QFontMetrics metrics = context->painter->fontMetrics();
 
-  // Used to combine texts of different airway lines with the same coordinates into one text
-  // Key is line coordinates as text (avoid floating point compare) and value is index into texts and airwayIndex
-  QHash<QString, int> lines;
-  // Contains combined text for overlapping airway lines
-  QList<QString> texts;
-  // points to index or airway in airway list
-  QList<int> airwayIndex;
+  bool showJet = context->objectTypes.testFlag(maptypes::AIRWAYJ);
+  bool showVictor = context->objectTypes.testFlag(maptypes::AIRWAYV);
 
-  for(int i = 0; i < airways->size(); i++)
-  {
-    const MapAirway& airway = airways->at(i);
+  // Combined texts for airway lines with the same waypoints - pre calculated when filling the cache
+  const QList<MapAirwayLabel> *labels = query->getAirwayLabels();
+
+  // Set for all labels which have at least one visible airway line
+  QBitArray visibleLabels(labels->size());
 
-    if(airway.type == maptypes::JET && !context->objectTypes.testFlag(maptypes::AIRWAYJ))
+  // Connected segments merged into lines with points interpolated for the current zoom level
+  const QList<MapAirwayLine> *lines =
+    query->getAirwayLines(scale, mapWidget->zoom() / mapWidget->zoomStep(), fast);
+
+  for(const MapAirwayLine& line : *lines)
+  {
+    if(line.type == maptypes::JET && !showJet)
       continue;
-    if(airway.type == maptypes::VICTOR && !context->objectTypes.testFlag(maptypes::AIRWAYV))
+    if(line.type == maptypes::VICTOR && !showVictor)
       continue;
 
-    if(airway.type == maptypes::VICTOR)
+    if(!line.bounding.overlaps(context->viewportRect))
+      continue;
+
+    if(line.type == maptypes::VICTOR)
       context->painter->setPen(QPen(mapcolors::airwayVictorColor, 1.5));
-    else if(airway.type == maptypes::JET)
+    else if(line.type == maptypes::JET)
       context->painter->setPen(QPen(mapcolors::airwayJetColor, 1.5));
-    else if(airway.type == maptypes::BOTH)
+    else if(line.type == maptypes::BOTH)
       context->painter->setPen(QPen(mapcolors::airwayBothColor, 1.5));
 
-    // Get start and end point of airway segment in screen coordinates
-    int x1, y1, x2, y2;
-    bool visible1 = wToS(airway.from, x1, y1);
-    bool visible2 = wToS(airway.to, x2, y2);
-
-    if(!visible1 && !visible2)
-      // Check bounding rect for visibility
-      visible1 = airway.bounding.overlaps(context->viewportRect);
+    // Draw all connected segments with one call
+    GeoDataLineString lineString;
+    lineString.setTessellate(true);
+    for(const Pos& pos : line.points)
+      lineString << GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, DEG);
+    context->painter->drawPolyline(lineString);
 
-    if(visible1 || visible2)
+    if(!fast)
     {
-      // Draw line if both points are visible or line intersects screen coordinates
-      GeoDataCoordinates from(airway.from.getLonX(), airway.from.getLatY(), 0, DEG);
-      GeoDataCoordinates to(airway.to.getLonX(), airway.to.getLatY(), 0, DEG);
-      GeoDataLineString line;
-      line.setTessellate(true);
-      line << from << to;
-      context->painter->drawPolyline(line);
-
-      if(!fast)
+      for(int index : line.airwayIndexes)
       {
-        // Build text index
-        QString text;
-        if(context->mapLayer->isAirwayIdent())
-          text += airway.name;
-        if(context->mapLayer->isAirwayInfo())
-        {
-          text += QString(tr(" / ")) + maptypes::airwayTypeToShortString(airway.type);
-          if(airway.minAltitude)
-            text += QString(tr(" / ")) + QLocale().toString(airway.minAltitude) + tr(" ft");
-        }
-
-        if(!text.isEmpty())
-        {
-          QString firstStr = line.first().toString(GeoDataCoordinates::Decimal, 3);
-          QString lastStr = line.last().toString(GeoDataCoordinates::Decimal, 3);
-
-          // Create string key for index by using the coordinates
-          QString lineTextKey = firstStr + "|" + lastStr;
-
-          // Does it already exist in the map?
-          int index = lines.value(lineTextKey, -1);
-          if(index == -1)
-            // Try with reversed coordinates
-            index = lines.value(lastStr + "|" + firstStr, -1);
-
-          if(index != -1)
-          {
-            // Index already found - add the new text to the present one
-            QString oldTxt(texts.at(index));
-            if(oldTxt != text)
-              texts[index] = texts.at(index) + ", " + text;
-          }
-          else if(!text.isEmpty())
-          {
-            // Neither with forward nor reversed coordinates found - insert a new entry
-            texts.append(text);
-            lines.insert(lineTextKey, texts.size() - 1);
-            airwayIndex.append(i);
-          }
-        }
+        const MapAirway& airway = airways->at(index);
+        if(airway.labelIndex != -1 && airway.bounding.overlaps(context->viewportRect))
+          visibleLabels.setBit(airway.labelIndex);
       }
     }
   }
 
+  bool ident = context->mapLayer->isAirwayIdent(), info = context->mapLayer->isAirwayInfo();
+  if(fast || !(ident || info))
+    return;
+
   // Draw texts ----------------------------------------
-  int i = 0;
   context->painter->setPen(mapcolors::airwayTextColor);
-  for(const QString& text : texts)
+  for(int i = 0; i < labels->size(); i++)
   {
-    const MapAirway& airway = airways->at(airwayIndex.at(i));
+    if(!visibleLabels.testBit(i))
+      continue;
+
+    const MapAirwayLabel& label = labels->at(i);
+
+    QString text;
+    if((label.hasJet && !showJet) || (label.hasVictor && !showVictor))
+    {
+      // Some lines of this label are hidden - build text for the visible ones only
+      QStringList texts;
+      for(int index : label.airwayIndexes)
+      {
+        const MapAirway& airway = airways->at(index);
+        if((airway.type == maptypes::JET && !showJet) || (airway.type == maptypes::VICTOR && !showVictor))
+          continue;
+
+        QString txt = maptypes::airwayLabelText(airway, info);
+        if(!texts.contains(txt))
+          texts.append(txt);
+      }
+      text = texts.join(", ");
+    }
+    else
+      text = info ? label.infoText : label.identText;
+
+    if(text.isEmpty())
+      continue;
+
+    const MapAirway& airway = airways->at(label.airwayIndex);
     int xt = -1, yt = -1;
     float textBearing;
     if(findTextPos(airway.from, airway.to, context->painter, metrics.width(text), metrics.height() * 2,
@@ -210,7 +203,6 @@ void MapPainterNav::paintAirways(const PaintContext *context, const QList<MapAir
                                  context->painter->fontMetrics().ascent(), text);
       context->painter->resetTransform();
     }
-    i++;
   }
 }
 
@@ -49,6 +49,7 @@ void MapPainterRoute::render(const PaintContext *context)
     return;
 
   setRenderHints(context->painter);
+  symbolPainter->setLabelPlacer(context->labelPlacer);
 
   context->painter->save();
 
@@ -391,7 +392,8 @@ void MapPainterRoute::paintText(const PaintContext *context, const QColor& color
   if(text.isEmpty())
     return;
 
-  symbolPainter->textBox(context->painter, {text}, color,
-                         x + context->symSize(context->mapLayer->getWaypointSymbolSize()) / 2 + 2,
-                         y, textatt::BOLD | textatt::ROUTE_BG_COLOR, 255);
+  symbolPainter->textBoxSymbol(context->painter, {text}, color, x, y,
+                               context->symSize(context->mapLayer->getWaypointSymbolSize()) / 2 + 2,
+                               textplace::RIGHT_SIDE, textplace::ROUTE,
+                               textatt::BOLD | textatt::ROUTE_BG_COLOR, 255);
 }
@@ -20,6 +20,7 @@
 #include "connect/connectclient.h"
 #include "gui/mainwindow.h"
 #include "mapgui/mapwidget.h"
+#include "mapgui/maplabelplacer.h"
 #include "mapgui/maplayersettings.h"
 #include "mapgui/mappainteraircraft.h"
 #include "mapgui/mappainterairport.h"
@@ -54,6 +55,8 @@ MapPaintLayer::MapPaintLayer(MapWidget *widget, MapQuery *mapQueries)
   mapPainterRoute = new MapPainterRoute(mapWidget, mapQuery, mapScale, mapWidget->getRouteController());
   mapPainterAircraft = new MapPainterAircraft(mapWidget, mapQuery, mapScale);
 
+  labelPlacer = new MapLabelPlacer();
+
   // Default for visible object types
   objectTypes = maptypes::MapObjectTypes(
     maptypes::AIRPORT | maptypes::VOR | maptypes::NDB | maptypes::AP_ILS | maptypes::MARKER |
@@ -67,6 +70,7 @@ MapPaintLayer::~MapPaintLayer()
   delete mapPainterAirport;
   delete mapPainterMark;
   delete mapPainterRoute;
+  delete labelPlacer;
 
   delete layers;
   delete mapScale;
@@ -279,6 +283,9 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
 
       context.symbolScale = OptionData::instance().getMapSymbolSize() / 100.f;
 
+      labelPlacer->reset(viewport->width(), viewport->height());
+      context.labelPlacer = labelPlacer;
+
       if(mapWidget->distance() < DISTANCE_CUT_OFF_LIMIT)
       {
         if(context.mapLayerEffective->isAirportDiagram())
@@ -297,6 +304,10 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
         }
       }
       mapPainterRoute->render(&context);
+
+      // Draw all collected airport, navaid and route texts above the symbols
+      labelPlacer->drawLabels(painter);
+
       mapPainterMark->render(&context);
 
       mapPainterAircraft->render(&context);
@@ -41,6 +41,7 @@ class MapPainterIls;
 class MapPainterMark;
 class MapPainterRoute;
 class MapPainterAircraft;
+class MapLabelPlacer;
 
 /*
  * Implements the Marble layer interface that paints upon the Marble map. Contains all painter instances
@@ -120,6 +121,9 @@ private:
   MapPainterRoute *mapPainterRoute;
   MapPainterAircraft *mapPainterAircraft;
 
+  /* Places texts of airports, navaids and route objects */
+  MapLabelPlacer *labelPlacer;
+
   /* Database source */
   MapQuery *mapQuery = nullptr;
 
@@ -20,6 +20,8 @@
 #include "common/maptypesfactory.h"
 #include "sql/sqlquery.h"
 #include "common/maptools.h"
+#include "mapgui/mapscale.h"
+
 
 using namespace Marble;
 using namespace atools::sql;
@@ -47,6 +49,15 @@ MapQuery::~MapQuery()
 
 void MapQuery::getAirportAdminNamesById(int airportId, QString& city, QString& state, QString& country)
 {
+  const QStringList *names = airportAdminCache.object(airportId);
+  if(names != nullptr)
+  {
+    city = names->at(0);
+    state = names->at(1);
+    country = names->at(2);
+    return;
+  }
+
   airportAdminByIdQuery->bindValue(":id", airportId);
   airportAdminByIdQuery->exec();
   if(airportAdminByIdQuery->next())
@@ -55,6 +66,7 @@ void MapQuery::getAirportAdminNamesById(int airportId, QString& city, QString& s
     state = airportAdminByIdQuery->value("state").toString();
     country = airportAdminByIdQuery->value("country").toString();
   }
+  airportAdminCache.insert(airportId, new QStringList({city, state, country}));
 }
 
 void MapQuery::getAirportById(maptypes::MapAirport& airport, int airportId)
@@ -91,14 +103,24 @@ void MapQuery::getNdbForWaypoint(maptypes::MapNdb& ndb, int waypointId)
 
 void MapQuery::getAirwaysForWaypoint(QList<maptypes::MapAirway>& airways, int waypointId)
 {
+  const QList<maptypes::MapAirway> *cached = waypointAirwayCache.object(waypointId);
+  if(cached != nullptr)
+  {
+    airways.append(*cached);
+    return;
+  }
+
+  QList<maptypes::MapAirway> *result = new QList<maptypes::MapAirway>;
   airwayByWaypointIdQuery->bindValue(":id", waypointId);
   airwayByWaypointIdQuery->exec();
   while(airwayByWaypointIdQuery->next())
   {
     maptypes::MapAirway airway;
     mapTypesFactory->fillAirway(airwayByWaypointIdQuery->record(), airway);
-    airways.append(airway);
+    result->append(airway);
   }
+  airways.append(*result);
+  waypointAirwayCache.insert(waypointId, result);
 }
 
 void MapQuery::getWaypointsForAirway(QList<maptypes::MapWaypoint>& waypoints, const QString& airwayName,
@@ -240,6 +262,73 @@ void MapQuery::getMapObjectByIdent(maptypes::MapSearchResult& result, maptypes::
   }
 }
 
+void MapQuery::getMapObjectsByIdents(maptypes::MapIdentSearchResult& result, maptypes::MapObjectTypes type,
+                                     const QSet<QString>& idents)
+{
+  QStringList identList = idents.toList();
+
+  for(int start = 0; start < identList.size(); start += IDENT_BATCH_SIZE)
+  {
+    if(type & maptypes::AIRPORT)
+    {
+      bindIdentBatch(airportByIdentsQuery, identList, start);
+      airportByIdentsQuery->exec();
+      while(airportByIdentsQuery->next())
+      {
+        maptypes::MapAirport ap;
+        mapTypesFactory->fillAirport(airportByIdentsQuery->record(), ap, true);
+        result.airports[ap.ident].append(ap);
+      }
+    }
+
+    if(type & maptypes::VOR)
+    {
+      bindIdentBatch(vorByIdentsQuery, identList, start);
+      vorByIdentsQuery->exec();
+      while(vorByIdentsQuery->next())
+      {
+        maptypes::MapVor vor;
+        mapTypesFactory->fillVor(vorByIdentsQuery->record(), vor);
+        result.vors[vor.ident].append(vor);
+      }
+    }
+
+    if(type & maptypes::NDB)
+    {
+      bindIdentBatch(ndbByIdentsQuery, identList, start);
+      ndbByIdentsQuery->exec();
+      while(ndbByIdentsQuery->next())
+      {
+        maptypes::MapNdb ndb;
+        mapTypesFactory->fillNdb(ndbByIdentsQuery->record(), ndb);
+        result.ndbs[ndb.ident].append(ndb);
+      }
+    }
+
+    if(type & maptypes::WAYPOINT)
+    {
+      bindIdentBatch(waypointByIdentsQuery, identList, start);
+      waypointByIdentsQuery->exec();
+      while(waypointByIdentsQuery->next())
+      {
+        maptypes::MapWaypoint wp;
+        mapTypesFactory->fillWaypoint(waypointByIdentsQuery->record(), wp);
+        result.waypoints[wp.ident].append(wp);
+      }
+    }
+  }
+}
+
+void MapQuery::bindIdentBatch(atools::sql::SqlQuery *query, const QStringList& idents, int start)
+{
+  for(int i = 0; i < IDENT_BATCH_SIZE; i++)
+  {
+    int index = start + i;
+    // Fill unused placeholders with an empty ident that never matches
+    query->bindValue(":ident" + QString::number(i), index < idents.size() ? idents.at(index) : QString(""));
+  }
+}
+
 void MapQuery::getMapObjectById(maptypes::MapSearchResult& result, maptypes::MapObjectTypes type, int id)
 {
   if(type == maptypes::AIRPORT)
@@ -288,6 +377,39 @@ void MapQuery::getMapObjectById(maptypes::MapSearchResult& result, maptypes::Map
   }
 }
 
+void MapQuery::getObjectScreenPoints(const CoordinateConverter& conv, const MapLayer *mapLayer,
+                                     maptypes::MapObjectTypes types, QVector<QPoint>& points) const
+{
+  int x, y;
+  if(mapLayer->isAirport() && types.testFlag(maptypes::AIRPORT))
+  {
+    for(const MapAirport& airport : airportCache.list)
+      if(airport.isVisible(types) && conv.wToS(airport.position, x, y))
+        points.append(QPoint(x, y));
+  }
+
+  if(mapLayer->isVor() && types.testFlag(maptypes::VOR))
+  {
+    for(const MapVor& vor : vorCache.list)
+      if(conv.wToS(vor.position, x, y))
+        points.append(QPoint(x, y));
+  }
+
+  if(mapLayer->isNdb() && types.testFlag(maptypes::NDB))
+  {
+    for(const MapNdb& ndb : ndbCache.list)
+      if(conv.wToS(ndb.position, x, y))
+        points.append(QPoint(x, y));
+  }
+
+  if(mapLayer->isWaypoint() && types.testFlag(maptypes::WAYPOINT))
+  {
+    for(const MapWaypoint& wp : waypointCache.list)
+      if(conv.wToS(wp.position, x, y))
+        points.append(QPoint(x, y));
+  }
+}
+
 void MapQuery::getNearestObjects(const CoordinateConverter& conv, const MapLayer *mapLayer,
                                  bool airportDiagram, maptypes::MapObjectTypes types,
                                  int xs, int ys, int screenDistance,
@@ -568,10 +690,167 @@ const QList<maptypes::MapAirway> *MapQuery::getAirways(const GeoDataLatLonBox& r
       }
     }
     checkOverflow(airwayCache.list, maptypes::AIRWAY);
+    updateAirwayLabels();
+    updateAirwayLines();
   }
   return &airwayCache.list;
 }
 
+const QList<maptypes::MapAirwayLine> *MapQuery::getAirwayLines(const MapScale *scale, int zoomLevel, bool fast)
+{
+  // Keep the old points while zooming or scrolling if there are any
+  if(fast && airwayLinesZoomLevel != -1)
+    return &airwayLines;
+
+  if(zoomLevel != airwayLinesZoomLevel && scale->isValid())
+  {
+    // Zoom level has changed - calculate points along the great circle lines again
+    airwayLinesZoomLevel = zoomLevel;
+
+    for(maptypes::MapAirwayLine& line : airwayLines)
+    {
+      line.points.clear();
+      line.pieceAirwayIds.clear();
+
+      for(int index : line.airwayIndexes)
+      {
+        const maptypes::MapAirway& airway = airwayCache.list.at(index);
+
+        float distanceMeter = airway.from.distanceMeterTo(airway.to);
+        // Approximate the needed number of line segments
+        int numSegments = static_cast<int>(std::ceil(std::min(std::max(scale->getPixelIntForMeter(
+                                                                          distanceMeter) /
+                                                                        AIRWAY_PIXEL_PER_POINT, 2.f),
+                                                               AIRWAY_MAX_POINTS)));
+        float step = 1.f / numSegments;
+
+        for(int j = 0; j < numSegments; j++)
+        {
+          line.points.append(airway.from.interpolate(airway.to, distanceMeter, step * static_cast<float>(j)));
+          line.pieceAirwayIds.append(airway.id);
+        }
+      }
+
+      if(!line.airwayIndexes.isEmpty())
+        line.points.append(airwayCache.list.at(line.airwayIndexes.last()).to);
+    }
+  }
+  return &airwayLines;
+}
+
+void MapQuery::updateAirwayLines()
+{
+  airwayLines.clear();
+  airwayLinesZoomLevel = -1;
+
+  const QList<maptypes::MapAirway>& airways = airwayCache.list;
+
+  // Sort indexes by airway name, fragment and sequence to get connected segments in order
+  QVector<int> indexes;
+  for(int i = 0; i < airways.size(); i++)
+    indexes.append(i);
+
+  std::sort(indexes.begin(), indexes.end(), [&airways](int i1, int i2) -> bool
+  {
+    const maptypes::MapAirway& a1 = airways.at(i1);
+    const maptypes::MapAirway& a2 = airways.at(i2);
+    if(a1.name != a2.name)
+      return a1.name < a2.name;
+    else if(a1.fragment != a2.fragment)
+      return a1.fragment < a2.fragment;
+    else
+      return a1.sequence < a2.sequence;
+  });
+
+  // Segments might be duplicated if the query rectangle was split at the anti meridian
+  QSet<int> airwayIds;
+  const maptypes::MapAirway *last = nullptr;
+  maptypes::MapAirwayLine line;
+
+  for(int index : indexes)
+  {
+    const maptypes::MapAirway& airway = airways.at(index);
+    if(airwayIds.contains(airway.id))
+      continue;
+    airwayIds.insert(airway.id);
+
+    bool connected = last != nullptr && last->name == airway.name && last->fragment == airway.fragment &&
+                     last->type == airway.type && last->toWaypointId == airway.fromWaypointId;
+
+    if(!connected && !line.airwayIndexes.isEmpty())
+    {
+      // Start a new line
+      airwayLines.append(line);
+      line = maptypes::MapAirwayLine();
+    }
+
+    if(line.airwayIndexes.isEmpty())
+    {
+      line.type = airway.type;
+      line.bounding = airway.bounding;
+    }
+    else
+      line.bounding.extend(airway.to);
+
+    line.airwayIndexes.append(index);
+    last = &airway;
+  }
+
+  if(!line.airwayIndexes.isEmpty())
+    airwayLines.append(line);
+}
+
+void MapQuery::updateAirwayLabels()
+{
+  airwayLabels.clear();
+
+  // Maps direction independent waypoint id pair to label index
+  QHash<quint64, int> labelIndexByKey;
+
+  // Texts for each label - joined when done
+  QList<QStringList> identTexts, infoTexts;
+
+  for(int i = 0; i < airwayCache.list.size(); i++)
+  {
+    maptypes::MapAirway& airway = airwayCache.list[i];
+
+    quint64 key = maptypes::airwayWaypointKey(airway);
+    int index = labelIndexByKey.value(key, -1);
+    if(index == -1)
+    {
+      // Neither with forward nor reversed waypoints found - insert a new entry
+      maptypes::MapAirwayLabel label;
+      label.airwayIndex = i;
+      airwayLabels.append(label);
+      identTexts.append(QStringList());
+      infoTexts.append(QStringList());
+      index = airwayLabels.size() - 1;
+      labelIndexByKey.insert(key, index);
+    }
+
+    maptypes::MapAirwayLabel& label = airwayLabels[index];
+    label.airwayIndexes.append(i);
+    label.hasJet |= airway.type == maptypes::JET;
+    label.hasVictor |= airway.type == maptypes::VICTOR;
+    airway.labelIndex = index;
+
+    // Add the new text to the present ones if not already contained
+    QString identText = maptypes::airwayLabelText(airway, false);
+    if(!identTexts.at(index).contains(identText))
+      identTexts[index].append(identText);
+
+    QString infoText = maptypes::airwayLabelText(airway, true);
+    if(!infoTexts.at(index).contains(infoText))
+      infoTexts[index].append(infoText);
+  }
+
+  for(int i = 0; i < airwayLabels.size(); i++)
+  {
+    airwayLabels[i].identText = identTexts.at(i).join(", ");
+    airwayLabels[i].infoText = infoTexts.at(i).join(", ");
+  }
+}
+
 /*
  * Get airport cache
  * @param reverse reverse order of airports to have unimportant small ones below in painting order
@@ -819,6 +1098,46 @@ void MapQuery::getParkingByNameAndNumber(QList<maptypes::MapParking>& parkings,
   }
 }
 
+void MapQuery::fetchRecords(const maptypes::MapObjectRefList& refs, MapQueryRecords& records)
+{
+  for(const maptypes::MapObjectRef& ref : refs)
+  {
+    if(ref.type == maptypes::AIRPORT && !records.airportAdminNames.contains(ref.id))
+    {
+      QString city, state, country;
+      getAirportAdminNamesById(ref.id, city, state, country);
+      records.airportAdminNames.insert(ref.id, {city, state, country});
+    }
+    else if(ref.type == maptypes::WAYPOINT && !records.waypointAirways.contains(ref.id))
+    {
+      QList<maptypes::MapAirway> airways;
+      getAirwaysForWaypoint(airways, ref.id);
+      records.waypointAirways.insert(ref.id, airways);
+    }
+  }
+}
+
+bool MapQuery::hasRecords(const maptypes::MapObjectRefList& refs) const
+{
+  for(const maptypes::MapObjectRef& ref : refs)
+  {
+    if(ref.type == maptypes::AIRPORT && !airportAdminCache.contains(ref.id))
+      return false;
+    else if(ref.type == maptypes::WAYPOINT && !waypointAirwayCache.contains(ref.id))
+      return false;
+  }
+  return true;
+}
+
+void MapQuery::insertRecords(const MapQueryRecords& records)
+{
+  for(auto it = records.airportAdminNames.constBegin(); it != records.airportAdminNames.constEnd(); ++it)
+    airportAdminCache.insert(it.key(), new QStringList(it.value()));
+
+  for(auto it = records.waypointAirways.constBegin(); it != records.waypointAirways.constEnd(); ++it)
+    waypointAirwayCache.insert(it.key(), new QList<maptypes::MapAirway>(it.value()));
+}
+
 const QList<maptypes::MapHelipad> *MapQuery::getHelipads(int airportId)
 {
   if(helipadCache.contains(airportId))
@@ -1049,6 +1368,24 @@ void MapQuery::initQueries()
   waypointByIdentQuery = new SqlQuery(db);
   waypointByIdentQuery->prepare("select " + waypointQueryBase + " from waypoint where " + whereIdentRegion);
 
+  // Queries for batches of idents having placeholders :ident0 to :identN
+  QStringList identPlaceholders;
+  for(int i = 0; i < IDENT_BATCH_SIZE; i++)
+    identPlaceholders.append(":ident" + QString::number(i));
+  QString whereIdents("ident in (" + identPlaceholders.join(", ") + ")");
+
+  airportByIdentsQuery = new SqlQuery(db);
+  airportByIdentsQuery->prepare("select " + airportQueryBase + " from airport where " + whereIdents);
+
+  vorByIdentsQuery = new SqlQuery(db);
+  vorByIdentsQuery->prepare("select " + vorQueryBase + " from vor where " + whereIdents);
+
+  ndbByIdentsQuery = new SqlQuery(db);
+  ndbByIdentsQuery->prepare("select " + ndbQueryBase + " from ndb where " + whereIdents);
+
+  waypointByIdentsQuery = new SqlQuery(db);
+  waypointByIdentsQuery->prepare("select " + waypointQueryBase + " from waypoint where " + whereIdents);
+
   vorByIdQuery = new SqlQuery(db);
   vorByIdQuery->prepare("select " + vorQueryBase + " from vor where vor_id = :id");
 
@@ -1197,6 +1534,9 @@ void MapQuery::deInitQueries()
   markerCache.clear();
   ilsCache.clear();
   airwayCache.clear();
+  airwayLabels.clear();
+  airwayLines.clear();
+  airwayLinesZoomLevel = -1;
 
   runwayCache.clear();
   runwayOverwiewCache.clear();
@@ -1204,6 +1544,8 @@ void MapQuery::deInitQueries()
   taxipathCache.clear();
   parkingCache.clear();
   helipadCache.clear();
+  airportAdminCache.clear();
+  waypointAirwayCache.clear();
 
   delete airportByRectQuery;
   airportByRectQuery = nullptr;
@@ -1262,6 +1604,15 @@ void MapQuery::deInitQueries()
   delete waypointByIdentQuery;
   waypointByIdentQuery = nullptr;
 
+  delete airportByIdentsQuery;
+  airportByIdentsQuery = nullptr;
+  delete vorByIdentsQuery;
+  vorByIdentsQuery = nullptr;
+  delete ndbByIdentsQuery;
+  ndbByIdentsQuery = nullptr;
+  delete waypointByIdentsQuery;
+  waypointByIdentsQuery = nullptr;
+
   delete vorByIdQuery;
   vorByIdQuery = nullptr;
   delete ndbByIdQuery;
@@ -22,7 +22,12 @@
 #include "mapgui/maplayer.h"
 
 #include <QCache>
+#include <QHash>
 #include <QList>
+#include <QSet>
+#include <QPoint>
+#include <QStringList>
+#include <QVector>
 
 #include <marble/GeoDataLatLonBox.h>
 
@@ -39,6 +44,21 @@ class SqlQuery;
 class CoordinateConverter;
 class MapTypesFactory;
 class MapLayer;
+class MapScale;
+
+/*
+ * Results of MapQuery methods that are cached by id and needed for tooltips and the information panel.
+ * Filled by a MapQuery with its own connection in a worker thread and then copied into the caches of
+ * the MapQuery in the GUI thread.
+ */
+struct MapQueryRecords
+{
+  /* Airport id to city, state and country */
+  QHash<int, QStringList> airportAdminNames;
+
+  /* Waypoint id to all attached airways */
+  QHash<int, QList<maptypes::MapAirway> > waypointAirways;
+};
 
 /*
  * Provides map related database queries. Fill objects of the maptypes namespace and maintains a cache.
@@ -89,6 +109,16 @@ public:
   void getMapObjectByIdent(maptypes::MapSearchResult& result, maptypes::MapObjectTypes type,
                            const QString& ident, const QString& region = QString());
 
+  /*
+   * Get map objects for many idents at once using one query for each batch of idents.
+   * Use this to resolve all entries of a flight plan.
+   * @param result will receive objects of all regions based on type
+   * @param type AIRPORT, VOR, NDB or WAYPOINT
+   * @param idents ICAO idents
+   */
+  void getMapObjectsByIdents(maptypes::MapIdentSearchResult& result, maptypes::MapObjectTypes type,
+                             const QSet<QString>& idents);
+
   /*
    * Get a map object by type and id
    * @param result will receive objects based on type
@@ -113,6 +143,15 @@ public:
                          maptypes::MapObjectTypes types, int xs, int ys, int screenDistance,
                          maptypes::MapSearchResult& result);
 
+  /*
+   * Get screen coordinates of all visible airports, VORs, NDBs and waypoints from the caches.
+   * Does not access the database.
+   * @param types airport, VOR, NDB and waypoint types to include
+   * @param points receives the screen coordinates
+   */
+  void getObjectScreenPoints(const CoordinateConverter& conv, const MapLayer *mapLayer,
+                             maptypes::MapObjectTypes types, QVector<QPoint>& points) const;
+
   /*
    * Get a parking spot of an airport by name and number
    * @param parkings result
@@ -171,6 +210,20 @@ public:
   const QList<maptypes::MapAirway> *getAirways(const Marble::GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                                bool lazy);
 
+  /* Get combined labels for the airway list returned by getAirways. MapAirway::labelIndex points into
+   * this list. */
+  const QList<maptypes::MapAirwayLabel> *getAirwayLabels() const
+  {
+    return &airwayLabels;
+  }
+
+  /* Get connected airway segments merged into lines for the airway list returned by getAirways.
+   * Points of the lines are interpolated along the great circle once for each zoom level.
+   * @param scale used to approximate the number of needed points
+   * @param zoomLevel current zoom of the map divided by the zoom step
+   * @param fast keep already interpolated points even if the zoom level has changed */
+  const QList<maptypes::MapAirwayLine> *getAirwayLines(const MapScale *scale, int zoomLevel, bool fast);
+
   /* Get a partially filled runway list for the overview */
   const QList<maptypes::MapRunway> *getRunwaysForOverview(int airportId);
 
@@ -187,6 +240,16 @@ public:
 
   const QList<maptypes::MapHelipad> *getHelipads(int airportId);
 
+  /* Run all id based queries needed to describe the airports and waypoints in refs and copy the results
+   * into records. Other object types are ignored. */
+  void fetchRecords(const maptypes::MapObjectRefList& refs, MapQueryRecords& records);
+
+  /* @return true if all id based query results needed for refs are in the cache */
+  bool hasRecords(const maptypes::MapObjectRefList& refs) const;
+
+  /* Add records fetched by another MapQuery to the caches */
+  void insertRecords(const MapQueryRecords& records);
+
   /* Close all query objects thus disconnecting from the database */
   void initQueries();
 
@@ -220,6 +283,9 @@ private:
                                                    atools::sql::SqlQuery *query, bool reverse,
                                                    bool lazy, bool overview);
 
+  /* Bind idents starting at start to the placeholders of a batch query */
+  void bindIdentBatch(atools::sql::SqlQuery *query, const QStringList& idents, int start);
+
   void bindCoordinatePointInRect(const Marble::GeoDataLatLonBox& rect, atools::sql::SqlQuery *query,
                                  const QString& prefix = QString());
 
@@ -229,6 +295,12 @@ private:
 
   bool runwayCompare(const maptypes::MapRunway& r1, const maptypes::MapRunway& r2);
 
+  /* Build combined labels for all airway segments in the cache sharing the same waypoints */
+  void updateAirwayLabels();
+
+  /* Merge connected airway segments in the cache into lines */
+  void updateAirwayLines();
+
   template<typename TYPE>
   void checkOverflow(const QList<TYPE>& list, maptypes::MapObjectTypes type);
 
@@ -243,6 +315,9 @@ private:
   SimpleRectCache<maptypes::MapMarker> markerCache;
   SimpleRectCache<maptypes::MapIls> ilsCache;
   SimpleRectCache<maptypes::MapAirway> airwayCache;
+  QList<maptypes::MapAirwayLabel> airwayLabels;
+  QList<maptypes::MapAirwayLine> airwayLines;
+  int airwayLinesZoomLevel = -1; /* Zoom level for interpolated points in airwayLines */
 
   /* ID/object caches */
   QCache<int, QList<maptypes::MapRunway> > runwayCache;
@@ -252,12 +327,21 @@ private:
   QCache<int, QList<maptypes::MapParking> > parkingCache;
   QCache<int, QList<maptypes::MapStart> > startCache;
   QCache<int, QList<maptypes::MapHelipad> > helipadCache;
+  QCache<int, QStringList> airportAdminCache;
+  QCache<int, QList<maptypes::MapAirway> > waypointAirwayCache;
 
   /* Inflate bounding rectangle before passing it to query */
   static Q_DECL_CONSTEXPR double RECT_INFLATION_FACTOR_DEG = 0.3;
   static Q_DECL_CONSTEXPR double RECT_INFLATION_ADD_DEG = 0.1;
   static Q_DECL_CONSTEXPR int QUERY_ROW_LIMIT = 3000;
 
+  /* Number of idents bound to one query in getMapObjectsByIdents */
+  static Q_DECL_CONSTEXPR int IDENT_BATCH_SIZE = 50;
+
+  /* Screen pixel for each interpolated point along airways and maximum number of points per segment */
+  static Q_DECL_CONSTEXPR float AIRWAY_PIXEL_PER_POINT = 40.f;
+  static Q_DECL_CONSTEXPR float AIRWAY_MAX_POINTS = 72.f;
+
   /* Database queries */
   atools::sql::SqlQuery *airportByRectQuery = nullptr, *airportMediumByRectQuery = nullptr,
   *airportLargeByRectQuery = nullptr;
@@ -274,6 +358,9 @@ private:
   atools::sql::SqlQuery *airportByIdentQuery = nullptr, *vorByIdentQuery = nullptr,
   *ndbByIdentQuery = nullptr, *waypointByIdentQuery = nullptr;
 
+  atools::sql::SqlQuery *airportByIdentsQuery = nullptr, *vorByIdentsQuery = nullptr,
+  *ndbByIdentsQuery = nullptr, *waypointByIdentsQuery = nullptr;
+
   atools::sql::SqlQuery *vorByIdQuery = nullptr, *ndbByIdQuery = nullptr,
   *vorByWaypointIdQuery = nullptr, *ndbByWaypointIdQuery = nullptr, *waypointByIdQuery = nullptr;
 
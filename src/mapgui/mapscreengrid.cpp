@@ -0,0 +1,83 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mapscreengrid.h"
+
+#include <algorithm>
+
+MapScreenGrid::MapScreenGrid()
+{
+
+}
+
+MapScreenGrid::~MapScreenGrid()
+{
+
+}
+
+void MapScreenGrid::reset(const QRect& screenRect)
+{
+  gridRect = screenRect;
+  columns = std::max(1, (screenRect.width() + CELL_SIZE - 1) / CELL_SIZE);
+  rows = std::max(1, (screenRect.height() + CELL_SIZE - 1) / CELL_SIZE);
+
+  cells.clear();
+  cells.resize(columns * rows);
+}
+
+void MapScreenGrid::insert(int index, const QRect& bounding)
+{
+  if(cells.isEmpty())
+    return;
+
+  int col1, row1, col2, row2;
+  cellRange(bounding, col1, row1, col2, row2);
+
+  for(int row = row1; row <= row2; row++)
+  {
+    for(int col = col1; col <= col2; col++)
+      cells[row * columns + col].append(index);
+  }
+}
+
+void MapScreenGrid::query(const QRect& rect, QVector<int>& indexes) const
+{
+  if(cells.isEmpty())
+    return;
+
+  int col1, row1, col2, row2;
+  cellRange(rect, col1, row1, col2, row2);
+
+  for(int row = row1; row <= row2; row++)
+  {
+    for(int col = col1; col <= col2; col++)
+      indexes += cells.at(row * columns + col);
+  }
+
+  // Remove duplicates from objects covering more than one cell and keep the insertion order
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
+
+void MapScreenGrid::cellRange(const QRect& rect, int& col1, int& row1, int& col2, int& row2) const
+{
+  QRect normRect = rect.normalized();
+  col1 = std::min(std::max((normRect.left() - gridRect.left()) / CELL_SIZE, 0), columns - 1);
+  col2 = std::min(std::max((normRect.right() - gridRect.left()) / CELL_SIZE, 0), columns - 1);
+  row1 = std::min(std::max((normRect.top() - gridRect.top()) / CELL_SIZE, 0), rows - 1);
+  row2 = std::min(std::max((normRect.bottom() - gridRect.top()) / CELL_SIZE, 0), rows - 1);
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_MAPSCREENGRID_H
+#define LITTLENAVMAP_MAPSCREENGRID_H
+
+#include <QRect>
+#include <QVector>
+
+/*
+ * Uniform grid of cells over the map widget that keeps indexes of screen objects like lines or points.
+ * Used to find objects near the cursor without scanning all of them.
+ * Objects outside of the grid are added to the nearest border cells.
+ */
+class MapScreenGrid
+{
+public:
+  MapScreenGrid();
+  ~MapScreenGrid();
+
+  /* Remove all objects and set the covered screen area */
+  void reset(const QRect& screenRect);
+
+  /* Add object index to all cells overlapping the bounding rectangle */
+  void insert(int index, const QRect& bounding);
+
+  /* Get sorted indexes of all objects in cells overlapping the rectangle. Each index is returned once. */
+  void query(const QRect& rect, QVector<int>& indexes) const;
+
+private:
+  /* Get cell column and row range for a rectangle clamped to the grid */
+  void cellRange(const QRect& rect, int& col1, int& row1, int& col2, int& row2) const;
+
+  /* Cell size in pixel */
+  static Q_DECL_CONSTEXPR int CELL_SIZE = 32;
+
+  QRect gridRect;
+  int columns = 0, rows = 0;
+  QVector<QVector<int> > cells;
+};
+
+#endif // LITTLENAVMAP_MAPSCREENGRID_H
@@ -31,6 +31,8 @@
 #include "common/constants.h"
 #include "settings/settings.h"
 
+#include <marble/ViewportParams.h>
+
 MapScreenIndex::MapScreenIndex(MapWidget *parentWidget, MapQuery *mapQueryParam, MapPaintLayer *mapPaintLayer)
   : mapWidget(parentWidget), mapQuery(mapQueryParam), paintLayer(mapPaintLayer)
 {
@@ -41,12 +43,126 @@ MapScreenIndex::~MapScreenIndex()
 
 }
 
+/* Move all lines by offset and remove the ones that left the visible screen area */
+static void translateLines(QList<std::pair<int, QLine> >& lines, const QPoint& offset, const QRect& mapGeo)
+{
+  QList<std::pair<int, QLine> > translated;
+  for(const std::pair<int, QLine>& line : lines)
+  {
+    QLine newLine = line.second.translated(offset);
+    QRect rect(newLine.p1(), newLine.p2());
+    rect = rect.normalized();
+    rect.adjust(-1, -1, 1, 1);
+
+    if(mapGeo.intersects(rect))
+      translated.append(std::make_pair(line.first, newLine));
+  }
+  lines.swap(translated);
+}
+
+/* Fill grid with bounding rectangles of all lines */
+static void fillGrid(MapScreenGrid& grid, const QList<std::pair<int, QLine> >& lines, const QRect& mapGeo)
+{
+  grid.reset(mapGeo);
+  for(int i = 0; i < lines.size(); i++)
+  {
+    const QLine& line = lines.at(i).second;
+    QRect rect(line.p1(), line.p2());
+    rect = rect.normalized();
+    rect.adjust(-1, -1, 1, 1);
+    grid.insert(i, rect);
+  }
+}
+
+void MapScreenIndex::updateScreenGeometry(const Marble::GeoDataLatLonAltBox& curBox)
+{
+  QPoint offset;
+  if(calculatePanOffset(routeGeometryState, curBox, offset))
+    updateRouteScreenGeometryInternal(curBox, true, offset);
+  else
+    updateRouteScreenGeometryInternal(curBox, false, QPoint());
+
+  if(calculatePanOffset(airwayGeometryState, curBox, offset))
+    updateAirwayScreenGeometryInternal(curBox, true, offset);
+  else
+    updateAirwayScreenGeometryInternal(curBox, false, QPoint());
+}
+
+bool MapScreenIndex::calculatePanOffset(const ScreenGeometryState& state,
+                                        const Marble::GeoDataLatLonAltBox& curBox, QPoint& offset) const
+{
+  const Marble::ViewportParams *viewport = mapWidget->viewport();
+
+  // Only flat projections are shifted on the screen when moving the map
+  if(!state.valid ||
+     (viewport->projection() != Marble::Equirectangular && viewport->projection() != Marble::Mercator) ||
+     viewport->projection() != state.projection || viewport->radius() != state.radius ||
+     mapWidget->rect() != state.mapGeo)
+    return false;
+
+  // Map repeats at the anti meridian which can result in wrong offsets
+  if(curBox.crossesDateLine() || state.box.crossesDateLine())
+    return false;
+
+  CoordinateConverter conv(viewport);
+  int x, y;
+  if(!conv.wToS(state.center, x, y))
+    return false;
+
+  // Total shift since the last full update minus what was already applied
+  offset = QPoint(x, y) - state.centerScreen - state.panOffset;
+
+  // Nothing to keep if the old view is not visible anymore
+  return state.mapGeo.translated(offset).intersects(state.mapGeo);
+}
+
+void MapScreenIndex::saveGeometryState(ScreenGeometryState& state, const Marble::GeoDataLatLonAltBox& curBox,
+                                       bool pan, const QPoint& offset) const
+{
+  state.box = curBox;
+  if(pan)
+  {
+    // Keep reference point of the last full update
+    state.panOffset += offset;
+    return;
+  }
+
+  const Marble::ViewportParams *viewport = mapWidget->viewport();
+  CoordinateConverter conv(viewport);
+
+  state.projection = viewport->projection();
+  state.radius = viewport->radius();
+  state.mapGeo = mapWidget->rect();
+  state.panOffset = QPoint();
+  state.center = conv.sToW(state.mapGeo.center());
+
+  int x, y;
+  state.valid = state.center.isValid() && conv.wToS(state.center, x, y);
+  state.centerScreen = QPoint(x, y);
+}
+
 void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonAltBox& curBox)
+{
+  updateAirwayScreenGeometryInternal(curBox, false, QPoint());
+}
+
+void MapScreenIndex::updateAirwayScreenGeometryInternal(const Marble::GeoDataLatLonAltBox& curBox, bool pan,
+                                                        const QPoint& offset)
 {
   using atools::geo::Pos;
-  using maptypes::MapAirway;
+  using maptypes::MapAirwayLine;
+
+  const QRect& mapGeo = mapWidget->rect();
 
-  airwayLines.clear();
+  // Visible area of the last update in current screen coordinates
+  QRect lastMapGeo;
+  if(pan)
+  {
+    lastMapGeo = mapGeo.translated(offset);
+    translateLines(airwayLines, offset, mapGeo);
+  }
+  else
+    airwayLines.clear();
 
   CoordinateConverter conv(mapWidget->viewport());
   const MapScale *scale = paintLayer->getMapScale();
@@ -56,46 +172,52 @@ void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonAltBo
   if(scale->isValid() && paintLayer->getMapLayer()->isAirway() && (showJet || showVictor))
   {
     // Airways are visible on map - get them from the cache/database
-    const QList<MapAirway> *airways = mapQuery->getAirways(curBox, paintLayer->getMapLayer(), false);
-    const QRect& mapGeo = mapWidget->rect();
+    mapQuery->getAirways(curBox, paintLayer->getMapLayer(), false);
 
-    for(int i = 0; i < airways->size(); i++)
+    // Use the same interpolated points as the map painter
+    const QList<MapAirwayLine> *lines =
+      mapQuery->getAirwayLines(scale, mapWidget->zoom() / mapWidget->zoomStep(), false);
+
+    for(const MapAirwayLine& line : *lines)
     {
-      const MapAirway& airway = airways->at(i);
-      if((airway.type == maptypes::VICTOR && !showVictor) || (airway.type == maptypes::JET && !showJet))
+      if((line.type == maptypes::VICTOR && !showVictor) || (line.type == maptypes::JET && !showJet))
         continue;
 
-      Marble::GeoDataLatLonBox airwaybox(airway.bounding.getNorth(), airway.bounding.getSouth(),
-                                         airway.bounding.getEast(), airway.bounding.getWest(),
-                                         Marble::GeoDataCoordinates::Degree);
+      Marble::GeoDataLatLonBox linebox(line.bounding.getNorth(), line.bounding.getSouth(),
+                                       line.bounding.getEast(), line.bounding.getWest(),
+                                       Marble::GeoDataCoordinates::Degree);
 
-      if(airwaybox.intersects(curBox))
-      {
-        // Airway segment intersects with view rectangle
-        float distanceMeter = airway.from.distanceMeterTo(airway.to);
-        // Approximate the needed number of line segments
-        float numSegments = std::min(std::max(scale->getPixelIntForMeter(distanceMeter) / 40.f, 2.f), 72.f);
-        float step = 1.f / numSegments;
+      if(pan && airwayGeometryState.box.contains(linebox))
+        // Was completely in the last view - all visible pieces are already in the list
+        continue;
 
-        // Split the segments into smaller lines and add them only if visible
-        for(int j = 0; j < numSegments; j++)
+      if(linebox.intersects(curBox) && !line.points.isEmpty())
+      {
+        // Airway line intersects with view rectangle - add all visible pieces
+        int xs1, ys1, xs2, ys2;
+        conv.wToS(line.points.at(0), xs1, ys1);
+        for(int j = 1; j < line.points.size(); j++)
         {
-          float cur = step * static_cast<float>(j);
-          int xs1, ys1, xs2, ys2;
-          conv.wToS(airway.from.interpolate(airway.to, distanceMeter, cur), xs1, ys1);
-          conv.wToS(airway.from.interpolate(airway.to, distanceMeter, cur + step), xs2, ys2);
+          conv.wToS(line.points.at(j), xs2, ys2);
 
           QRect rect(QPoint(xs1, ys1), QPoint(xs2, ys2));
           rect = rect.normalized();
           // Avoid points or flat rectangles (lines)
           rect.adjust(-1, -1, 1, 1);
 
-          if(mapGeo.intersects(rect))
-            airwayLines.append(std::make_pair(airway.id, QLine(xs1, ys1, xs2, ys2)));
+          // Pieces touching the last view are already in the list when panning
+          if(mapGeo.intersects(rect) && !(pan && lastMapGeo.intersects(rect)))
+            airwayLines.append(std::make_pair(line.pieceAirwayIds.at(j - 1), QLine(xs1, ys1, xs2, ys2)));
+
+          xs1 = xs2;
+          ys1 = ys2;
         }
       }
     }
   }
+
+  fillGrid(airwayLineGrid, airwayLines, mapGeo);
+  saveGeometryState(airwayGeometryState, curBox, pan, offset);
 }
 
 void MapScreenIndex::saveState()
@@ -113,13 +235,58 @@ void MapScreenIndex::restoreState()
 }
 
 void MapScreenIndex::updateRouteScreenGeometry()
+{
+  updateRouteScreenGeometryInternal(mapWidget->viewport()->viewLatLonAltBox(), false, QPoint());
+}
+
+void MapScreenIndex::updateRouteScreenGeometryInternal(const Marble::GeoDataLatLonAltBox& curBox, bool pan,
+                                                       const QPoint& offset)
 {
   using atools::geo::Pos;
+  using atools::geo::Rect;
 
   const RouteMapObjectList& routeMapObjects = mapWidget->getRouteController()->getRouteMapObjects();
+  const QRect& mapGeo = mapWidget->rect();
+
+  // Leg bounding rectangles are only valid for the same route
+  pan = pan && routeLegBounding.size() == routeMapObjects.size();
+
+  // Legs that were completely inside the last view and keep their lines
+  QVector<bool> keepLeg(routeMapObjects.size(), false);
+
+  if(pan)
+  {
+    for(int i = 1; i < routeLegBounding.size(); i++)
+    {
+      const Rect& bounding = routeLegBounding.at(i);
+      if(bounding.isValid())
+      {
+        Marble::GeoDataLatLonBox legbox(bounding.getNorth(), bounding.getSouth(),
+                                        bounding.getEast(), bounding.getWest(),
+                                        Marble::GeoDataCoordinates::Degree);
+        keepLeg[i] = routeGeometryState.box.contains(legbox);
+      }
+    }
+
+    translateLines(routeLines, offset, mapGeo);
+
+    // Remove lines of legs that will be calculated again
+    QList<std::pair<int, QLine> > keptLines;
+    for(const std::pair<int, QLine>& line : routeLines)
+    {
+      if(keepLeg.at(line.first + 1))
+        keptLines.append(line);
+    }
+    routeLines.swap(keptLines);
+  }
+  else
+  {
+    routeLines.clear();
+    routeLegBounding.fill(Rect(), routeMapObjects.size());
+  }
 
-  routeLines.clear();
   routePoints.clear();
+  routePointGrid.reset(mapGeo);
 
   QList<std::pair<int, QPoint> > airportPoints;
   QList<std::pair<int, QPoint> > otherPoints;
@@ -129,7 +296,6 @@ void MapScreenIndex::updateRouteScreenGeometry()
   if(scale->isValid())
   {
     Pos p1;
-    const QRect& mapGeo = mapWidget->rect();
 
     for(int i = 0; i < routeMapObjects.size(); i++)
     {
@@ -144,20 +310,26 @@ void MapScreenIndex::updateRouteScreenGeometry()
       else
         otherPoints.append(std::make_pair(i, QPoint(x2, y2)));
 
-      if(p1.isValid())
+      if(p1.isValid() && !keepLeg.at(i))
       {
         float distanceMeter = p2.distanceMeterTo(p1);
         // Approximate the needed number of line segments
         float numSegments = std::min(std::max(scale->getPixelIntForMeter(distanceMeter) / 140.f, 4.f), 288.f);
         float step = 1.f / numSegments;
 
+        Rect bounding(p1);
+
         // Split the legs into smaller lines and add them only if visible
         for(int j = 0; j < numSegments; j++)
         {
           float cur = step * static_cast<float>(j);
+          Pos ip1 = p1.interpolate(p2, distanceMeter, cur);
+          Pos ip2 = p1.interpolate(p2, distanceMeter, cur + step);
+          bounding.extend(ip2);
+
           int xs1, ys1, xs2, ys2;
-          conv.wToS(p1.interpolate(p2, distanceMeter, cur), xs1, ys1);
-          conv.wToS(p1.interpolate(p2, distanceMeter, cur + step), xs2, ys2);
+          conv.wToS(ip1, xs1, ys1);
+          conv.wToS(ip2, xs2, ys2);
 
           QRect rect(QPoint(xs1, ys1), QPoint(xs2, ys2));
           rect = rect.normalized();
@@ -167,13 +339,23 @@ void MapScreenIndex::updateRouteScreenGeometry()
           if(mapGeo.intersects(rect))
             routeLines.append(std::make_pair(i - 1, QLine(xs1, ys1, xs2, ys2)));
         }
+        routeLegBounding[i] = bounding;
       }
       p1 = p2;
     }
 
     routePoints.append(airportPoints);
     routePoints.append(otherPoints);
+
+    for(int i = 0; i < routePoints.size(); i++)
+    {
+      const QPoint& point = routePoints.at(i).second;
+      routePointGrid.insert(i, QRect(point, point));
+    }
   }
+
+  fillGrid(routeLineGrid, routeLines, mapGeo);
+  saveGeometryState(routeGeometryState, curBox, pan, offset);
 }
 
 void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, maptypes::MapSearchResult& result)
@@ -282,8 +464,12 @@ int MapScreenIndex::getNearestRoutePointIndex(int xs, int ys, int maxDistance)
   int minIndex = -1;
   int minDist = std::numeric_limits<int>::max();
 
-  for(const std::pair<int, QPoint>& rsp : routePoints)
+  QVector<int> indexes;
+  routePointGrid.query(QRect(xs - maxDistance, ys - maxDistance, maxDistance * 2, maxDistance * 2), indexes);
+
+  for(int index : indexes)
   {
+    const std::pair<int, QPoint>& rsp = routePoints.at(index);
     const QPoint& point = rsp.second;
     int dist = atools::geo::manhattanDistance(point.x(), point.y(), xs, ys);
     if(dist < minDist && dist < maxDistance)
@@ -302,9 +488,12 @@ void MapScreenIndex::getNearestAirways(int xs, int ys, int maxDistance, maptypes
      !paintLayer->getShownMapObjects().testFlag(maptypes::AIRWAYV))
     return;
 
-  for(int i = 0; i < airwayLines.size(); i++)
+  QVector<int> indexes;
+  airwayLineGrid.query(QRect(xs - maxDistance, ys - maxDistance, maxDistance * 2, maxDistance * 2), indexes);
+
+  for(int index : indexes)
   {
-    const std::pair<int, QLine>& line = airwayLines.at(i);
+    const std::pair<int, QLine>& line = airwayLines.at(index);
 
     QLine l = line.second;
 
@@ -326,9 +515,12 @@ int MapScreenIndex::getNearestRouteLegIndex(int xs, int ys, int maxDistance)
   int minIndex = -1;
   float minDist = std::numeric_limits<float>::max();
 
-  for(int i = 0; i < routeLines.size(); i++)
+  QVector<int> indexes;
+  routeLineGrid.query(QRect(xs - maxDistance, ys - maxDistance, maxDistance * 2, maxDistance * 2), indexes);
+
+  for(int index : indexes)
   {
-    const std::pair<int, QLine>& line = routeLines.at(i);
+    const std::pair<int, QLine>& line = routeLines.at(index);
 
     QLine l = line.second;
 
@@ -21,22 +21,23 @@
 #include "fs/sc/simconnectdata.h"
 
 #include "route/routemapobjectlist.h"
+#include "mapgui/mapscreengrid.h"
+
+#include <marble/GeoDataLatLonAltBox.h>
+#include <marble/MarbleGlobal.h>
 
 namespace maptypes {
 struct MapSearchResult;
 
 }
 
-namespace Marble {
-class GeoDataLatLonAltBox;
-}
-
 class MapWidget;
 class MapPaintLayer;
 
 /*
  * Keeps an indes of certain map objects like flight plan lines, airway lines in screen coordinates
- * to allow mouse over reaction.
+ * to allow mouse over reaction. Lines and points are additionally kept in screen grids so that
+ * mouse over checks only have to look at objects in the cells near the cursor.
  * Also maintains distance measurement lines and range rings.
  * All get nearest methods return objects sorted by distance
  */
@@ -73,6 +74,11 @@ public:
   void updateRouteScreenGeometry();
   void updateAirwayScreenGeometry(const Marble::GeoDataLatLonAltBox& curBox);
 
+  /* Update all geometry after a scroll or zoom. If the map was only moved in a flat projection
+   * the existing geometry is shifted and only objects entering the view are calculated.
+   * Otherwise falls back to a full update. */
+  void updateScreenGeometry(const Marble::GeoDataLatLonAltBox& curBox);
+
   /* Save and restore distance markers and range rings */
   void saveState();
   void restoreState();
@@ -147,6 +153,31 @@ public:
   }
 
 private:
+  /* Map view at the time of the last screen geometry update */
+  struct ScreenGeometryState
+  {
+    bool valid = false;
+    Marble::Projection projection = Marble::VerticalPerspective; // VerticalPerspective is never used
+    int radius = 0;
+    QRect mapGeo;
+    /* Screen center and its position at the last full update. Offsets are measured from here
+     * to avoid accumulating rounding errors over many pan updates. */
+    atools::geo::Pos center;
+    QPoint centerScreen;
+    /* Sum of all offsets applied to the geometry since the last full update */
+    QPoint panOffset;
+    Marble::GeoDataLatLonAltBox box;
+  };
+
+  void updateRouteScreenGeometryInternal(const Marble::GeoDataLatLonAltBox& curBox, bool pan, const QPoint& offset);
+  void updateAirwayScreenGeometryInternal(const Marble::GeoDataLatLonAltBox& curBox, bool pan, const QPoint& offset);
+
+  /* Get screen offset if the map was only moved since the last update. Returns false if a full update is needed. */
+  bool calculatePanOffset(const ScreenGeometryState& state, const Marble::GeoDataLatLonAltBox& curBox,
+                          QPoint& offset) const;
+  void saveGeometryState(ScreenGeometryState& state, const Marble::GeoDataLatLonAltBox& curBox, bool pan,
+                         const QPoint& offset) const;
+
   void getNearestAirways(int xs, int ys, int maxDistance, maptypes::MapSearchResult& result);
   void getNearestHighlights(int xs, int ys, int maxDistance, maptypes::MapSearchResult& result);
 
@@ -163,6 +194,13 @@ private:
   QList<std::pair<int, QLine> > airwayLines;
   QList<std::pair<int, QPoint> > routePoints;
 
+  /* Indexes into the lists above */
+  MapScreenGrid routeLineGrid, airwayLineGrid, routePointGrid;
+
+  /* Bounding rectangle of the interpolated points for each leg ending at the route index */
+  QVector<atools::geo::Rect> routeLegBounding;
+  ScreenGeometryState routeGeometryState, airwayGeometryState;
+
 };
 
 #endif // LITTLENAVMAP_MAPSCREENINDEX_H
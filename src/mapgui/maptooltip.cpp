@@ -20,6 +20,7 @@
 #include "common/maptypes.h"
 #include "util/htmlbuilder.h"
 #include "common/htmlinfobuilder.h"
+#include "common/htmlinfoloader.h"
 
 #include <QPalette>
 #include <QToolTip>
@@ -29,9 +30,14 @@ using atools::util::HtmlBuilder;
 using atools::fs::sc::SimConnectAircraft;
 using atools::fs::sc::SimConnectUserAircraft;
 
-MapTooltip::MapTooltip(QObject *parent, MapQuery *mapQuery, WeatherReporter *weatherReporter)
+MapTooltip::MapTooltip(QObject *parent, atools::sql::SqlDatabase *sqlDb, MapQuery *mapQuery,
+                       WeatherReporter *weatherReporter)
   : QObject(parent), query(mapQuery), weather(weatherReporter)
 {
+  // Tooltips need only MapQuery records
+  loader = new HtmlInfoLoader(this, sqlDb, query, nullptr);
+  connect(loader, &HtmlInfoLoader::recordsLoaded, this, &MapTooltip::tooltipDataLoaded);
+
 #if defined(Q_OS_WIN32)
   iconBackColor = QColor(Qt::transparent);
 #else
@@ -44,12 +50,26 @@ MapTooltip::~MapTooltip()
 {
 }
 
+void MapTooltip::cancel()
+{
+  loader->cancel();
+}
+
+void MapTooltip::preDatabaseLoad()
+{
+  loader->preDatabaseLoad();
+}
+
 QString MapTooltip::buildTooltip(const maptypes::MapSearchResult& mapSearchResult,
                                  const RouteMapObjectList& routeMapObjects,
                                  bool airportDiagram)
 {
+  // Build a preliminary tooltip without database access if records are missing in the cache.
+  // It is built again from the cache when the loader has the records.
+  bool complete = loader->load(HtmlInfoLoader::objectRefs(mapSearchResult));
+
   HtmlBuilder html(false);
-  HtmlInfoBuilder info(query, nullptr, false);
+  HtmlInfoBuilder info(complete ? query : nullptr, nullptr, false);
   int numEntries = 0;
 
   // Append HTML text for all objects found in order of importance (airports first, etc.)
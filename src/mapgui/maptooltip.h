@@ -29,15 +29,22 @@ struct MapSearchResult;
 class MapQuery;
 class WeatherReporter;
 class RouteMapObjectList;
+class HtmlInfoLoader;
 
 namespace atools {
 namespace util {
 class HtmlBuilder;
 }
+namespace sql {
+class SqlDatabase;
+}
 }
 
 /*
  * Builds a HTML tooltip for map display with a maximum length of 20 lines.
+ *
+ * Database records for airports and waypoints are loaded in a background thread. The tooltip is built
+ * from the available data first and tooltipDataLoaded is emitted when it can be built completely.
  */
 class MapTooltip :
   public QObject
@@ -45,7 +52,8 @@ class MapTooltip :
   Q_OBJECT
 
 public:
-  MapTooltip(QObject *parent, MapQuery *mapQuery, WeatherReporter *weatherReporter);
+  MapTooltip(QObject *parent, atools::sql::SqlDatabase *sqlDb, MapQuery *mapQuery,
+             WeatherReporter *weatherReporter);
   virtual ~MapTooltip();
 
   /*
@@ -55,12 +63,23 @@ public:
    * @param routeMapObjects Needed to access route objects
    * @param airportDiagram set to true if the tooltip should also cover objects that are
    * displayed in airport diagrams.
-   * @return HTML code of the tooltip
+   * @return HTML code of the tooltip. Misses all information that needs database queries if the records
+   * are not cached yet.
    */
   QString buildTooltip(const maptypes::MapSearchResult& mapSearchResult,
                        const RouteMapObjectList& routeMapObjects,
                        bool airportDiagram);
 
+  /* Drop loading of records for the last tooltip */
+  void cancel();
+
+  /* Disconnect background loading from the database */
+  void preDatabaseLoad();
+
+signals:
+  /* All records for the last tooltip are loaded and buildTooltip can be called again */
+  void tooltipDataLoaded();
+
 private:
   bool checkText(atools::util::HtmlBuilder& html, int numEntries);
 
@@ -69,6 +88,7 @@ private:
 
   MapQuery *query;
   WeatherReporter *weather;
+  HtmlInfoLoader *loader;
   QColor iconBackColor;
 };
 
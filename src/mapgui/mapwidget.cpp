@@ -49,6 +49,8 @@
 #include <marble/MarbleWidgetInputHandler.h>
 #include <marble/MarbleModel.h>
 #include <marble/AbstractFloatItem.h>
+#include <marble/GeoDataLineString.h>
+#include <marble/GeoPainter.h>
 
 // Default zoom distance if start position was not set (usually first start after installation */
 const int DEFAULT_MAP_DISTANCE = 7000;
@@ -92,7 +94,8 @@ MapWidget::MapWidget(MainWindow *parent, MapQuery *query)
   // Avoid stuttering movements
   inputHandler()->setInertialEarthRotationEnabled(false);
 
-  mapTooltip = new MapTooltip(this, mapQuery, mainWindow->getWeatherReporter());
+  mapTooltip = new MapTooltip(this, mainWindow->getDatabase(), mapQuery, mainWindow->getWeatherReporter());
+  connect(mapTooltip, &MapTooltip::tooltipDataLoaded, this, &MapWidget::tooltipDataLoaded);
 
   paintLayer = new MapPaintLayer(this, mapQuery);
   addLayer(paintLayer);
@@ -298,6 +301,7 @@ void MapWidget::preDatabaseLoad()
 {
   cancelDragAll();
   databaseLoadStatus = true;
+  mapTooltip->preDatabaseLoad();
   paintLayer->preDatabaseLoad();
 }
 
@@ -602,11 +606,8 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
   QPointF diff = curPos - conv.wToS(lastUserAircraft.getPosition());
 
   bool wasEmpty = aircraftTrack.isEmpty();
-  bool trackPruned = aircraftTrack.appendTrackPos(simulatorData.getUserAircraft().getPosition(),
-                                                  simulatorData.getUserAircraft().isOnGround());
-
-  if(trackPruned)
-    emit aircraftTrackPruned();
+  aircraftTrack.appendTrackPos(simulatorData.getUserAircraft().getPosition(),
+                               simulatorData.getUserAircraft().isOnGround());
 
   if(wasEmpty != aircraftTrack.isEmpty())
     // We have a track - update toolbar and menu
@@ -1500,6 +1501,82 @@ void MapWidget::cancelDragRoute()
     routeDragTo = atools::geo::EMPTY_POS;
     routeDragPoint = -1;
     routeDragLeg = -1;
+    routeDragPixmap = QPixmap();
+    routeDragSnapPoints.clear();
+  }
+}
+
+void MapWidget::startRouteDragPreview()
+{
+  // Render the map once without drag lines
+  QPoint cur = routeDragCur;
+  routeDragCur = QPoint();
+  routeDragPixmap = grab();
+  routeDragCur = cur;
+
+  // Remember view to detect zoom, scroll, resize or projection changes while dragging
+  routeDragZoom = zoom();
+  routeDragViewBox = viewport()->viewLatLonAltBox();
+  routeDragProjection = projection();
+  routeDragSize = size();
+
+  // Collect snap points from the already loaded objects
+  routeDragSnapPoints.clear();
+  CoordinateConverter conv(viewport());
+  mapQuery->getObjectScreenPoints(conv, paintLayer->getMapLayer(),
+                                  paintLayer->getShownMapObjects() &
+                                  (maptypes::AIRPORT_ALL | maptypes::VOR | maptypes::NDB | maptypes::WAYPOINT),
+                                  routeDragSnapPoints);
+}
+
+bool MapWidget::isRouteDragPreviewValid() const
+{
+  return !routeDragPixmap.isNull() && zoom() == routeDragZoom &&
+         viewport()->viewLatLonAltBox() == routeDragViewBox &&
+         projection() == routeDragProjection && size() == routeDragSize;
+}
+
+QPoint MapWidget::snapRouteDragPoint(const QPoint& point) const
+{
+  QPoint nearest = point;
+  int minDistance = screenSearchDistance;
+  for(const QPoint& snap : routeDragSnapPoints)
+  {
+    int distance = (snap - point).manhattanLength();
+    if(distance < minDistance)
+    {
+      minDistance = distance;
+      nearest = snap;
+    }
+  }
+  return nearest;
+}
+
+void MapWidget::paintRouteDragPreview()
+{
+  GeoPainter painter(this, viewport(), Marble::LowQuality);
+  painter.drawPixmap(0, 0, routeDragPixmap);
+
+  qreal lon, lat;
+  if(!routeDragCur.isNull() &&
+     geoCoordinates(routeDragCur.x(), routeDragCur.y(), lon, lat, GeoDataCoordinates::Degree))
+  {
+    GeoDataLineString linestring;
+    linestring.setTessellate(true);
+
+    if(routeDragFrom.isValid())
+      linestring.append(GeoDataCoordinates(routeDragFrom.getLonX(), routeDragFrom.getLatY(), 0,
+                                           GeoDataCoordinates::Degree));
+    linestring.append(GeoDataCoordinates(lon, lat, 0, GeoDataCoordinates::Degree));
+    if(routeDragTo.isValid())
+      linestring.append(GeoDataCoordinates(routeDragTo.getLonX(), routeDragTo.getLatY(), 0,
+                                           GeoDataCoordinates::Degree));
+
+    if(linestring.size() > 1)
+    {
+      painter.setPen(QPen(mapcolors::routeDragColor, 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+      painter.drawPolyline(linestring);
+    }
   }
 }
 
@@ -1551,10 +1628,13 @@ void MapWidget::mouseMoveEvent(QMouseEvent *event)
     qreal lon, lat;
     bool visible = geoCoordinates(event->pos().x(), event->pos().y(), lon, lat);
     if(visible)
-      // Update current point
-      routeDragCur = QPoint(event->pos().x(), event->pos().y());
+      // Update current point and snap to nearby airports or navaids
+      routeDragCur = snapRouteDragPoint(QPoint(event->pos().x(), event->pos().y()));
 
-    setViewContext(Marble::Animation);
+    if(routeDragPixmap.isNull())
+      setViewContext(Marble::Animation);
+
+    // Repaint only drag lines if preview image is available
     update();
   }
   else if(mouseState == mw::NONE)
@@ -1715,6 +1795,7 @@ void MapWidget::mouseReleaseEvent(QMouseEvent *event)
             else
               routeDragTo = atools::geo::EMPTY_POS;
             setContextMenuPolicy(Qt::PreventContextMenu);
+            startRouteDragPreview();
           }
           else
           {
@@ -1732,6 +1813,7 @@ void MapWidget::mouseReleaseEvent(QMouseEvent *event)
               routeDragFrom = rmos.at(routeLeg).getPosition();
               routeDragTo = rmos.at(routeLeg + 1).getPosition();
               setContextMenuPolicy(Qt::PreventContextMenu);
+              startRouteDragPreview();
             }
           }
         }
@@ -1843,6 +1925,9 @@ void MapWidget::hideTooltip()
 {
   QToolTip::hideText();
   tooltipPos = QPoint();
+
+  // Drop loading of records for a tooltip that will not be shown anymore
+  mapTooltip->cancel();
 }
 
 void MapWidget::updateTooltip()
@@ -1861,6 +1946,14 @@ void MapWidget::updateTooltip()
     hideTooltip();
 }
 
+/* Records for the tooltip were loaded in background - replace the preliminary tooltip */
+void MapWidget::tooltipDataLoaded()
+{
+  // Ignore if Qt has hidden the tooltip because the mouse moved on
+  if(QToolTip::isVisible())
+    updateTooltip();
+}
+
 const atools::fs::sc::SimConnectUserAircraft& MapWidget::getUserAircraft() const
 {
   return screenIndex->getUserAircraft();
@@ -2085,6 +2178,21 @@ void MapWidget::updateVisibleObjectsStatusBar()
 
 void MapWidget::paintEvent(QPaintEvent *paintEvent)
 {
+  if((mouseState & mw::DRAG_ROUTE_LEG || mouseState & mw::DRAG_ROUTE_POINT) && !routeDragPixmap.isNull())
+  {
+    if(isRouteDragPreviewValid())
+    {
+      // Map did not move since dragging started - avoid rendering it again
+      paintRouteDragPreview();
+      return;
+    }
+
+    // View was zoomed, moved or resized - image and snap points are stale. Render the map normally.
+    routeDragPixmap = QPixmap();
+    routeDragSnapPoints.clear();
+    setViewContext(Marble::Animation);
+  }
+
   bool changed = false;
   const GeoDataLatLonAltBox visibleLatLonAltBox = viewport()->viewLatLonAltBox();
 
@@ -2112,8 +2220,7 @@ void MapWidget::paintEvent(QPaintEvent *paintEvent)
   {
     // Major change - update index and visible objects
     updateVisibleObjectsStatusBar();
-    screenIndex->updateRouteScreenGeometry();
-    screenIndex->updateAirwayScreenGeometry(currentViewBoundingBox);
+    screenIndex->updateScreenGeometry(currentViewBoundingBox);
   }
 }
 
@@ -23,6 +23,7 @@
 #include "fs/sc/simconnectdata.h"
 #include "common/aircrafttrack.h"
 
+#include <QPixmap>
 #include <QWidget>
 
 #include <marble/GeoDataLatLonAltBox.h>
@@ -291,9 +292,6 @@ signals:
   /* Show information about objects from single click or context menu */
   void showInformation(maptypes::MapSearchResult result);
 
-  /* Aircraft track was pruned and needs to be updated */
-  void aircraftTrackPruned();
-
 private:
   bool eventFilter(QObject *obj, QEvent *e) override;
   void setDetailLevel(int factor);
@@ -301,6 +299,9 @@ private:
   /* Hide and prevent re-show */
   void hideTooltip();
 
+  /* Replace a preliminary tooltip once all database records are loaded */
+  void tooltipDataLoaded();
+
   /* Overloaded methods */
   virtual void mousePressEvent(QMouseEvent *event) override;
   virtual void mouseReleaseEvent(QMouseEvent *event) override;
@@ -323,6 +324,18 @@ private:
   void cancelDragDistance();
   void cancelDragRoute();
 
+  /* Save map image and snap points for route dragging */
+  void startRouteDragPreview();
+
+  /* Draw route drag lines over the saved map image */
+  void paintRouteDragPreview();
+
+  /* true if the saved map image still matches the current view */
+  bool isRouteDragPreviewValid() const;
+
+  /* Get the nearest snap point or the given point if none is near */
+  QPoint snapRouteDragPoint(const QPoint& point) const;
+
   /* Defines amount of objects and other attributes on the map. min 5, max 15, default 10. */
   int mapDetailLevel;
 
@@ -345,6 +358,18 @@ private:
   int routeDragPoint = -1 /* Index of changed point */,
       routeDragLeg = -1 /* index of changed leg */;
 
+  /* Map image saved at start of route dragging. Only the drag lines are painted on top while dragging. */
+  QPixmap routeDragPixmap;
+
+  /* View state at the time the map image was saved */
+  int routeDragZoom = 0;
+  Marble::GeoDataLatLonAltBox routeDragViewBox;
+  Marble::Projection routeDragProjection = Marble::Spherical;
+  QSize routeDragSize;
+
+  /* Screen positions of visible airports and navaids where the drag point snaps to */
+  QVector<QPoint> routeDragSnapPoints;
+
   /* Save last tooltip position. If invalid/null no tooltip will be shown */
   QPoint tooltipPos;
   maptypes::MapSearchResult mapSearchResultTooltip;
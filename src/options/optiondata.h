@@ -257,6 +257,12 @@ public:
     return simUpdateBox;
   }
 
+  /* Directory containing SRTM HGT files. Marble elevation model is used if empty. */
+  const QString& getProfileElevationDirectory() const
+  {
+    return profileElevationDirectory;
+  }
+
 private:
   friend class OptionsDialog;
 
@@ -349,6 +355,9 @@ private:
   // ui->spinBoxOptionsRouteGroundBuffer
   int routeGroundBuffer = 1000;
 
+  // ui->lineEditOptionsRouteElevationDirectory
+  QString profileElevationDirectory;
+
   // Used in the singelton to check if data was already loaded
   bool valid = false;
 };
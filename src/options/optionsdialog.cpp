@@ -151,6 +151,7 @@ OptionsDialog::OptionsDialog(MainWindow *parentWindow)
   widgets.append(ui->spinBoxOptionsMapTooltipRect);
   widgets.append(ui->doubleSpinBoxOptionsMapZoomShowMap);
   widgets.append(ui->spinBoxOptionsRouteGroundBuffer);
+  widgets.append(ui->lineEditOptionsRouteElevationDirectory);
 
   ui->lineEditOptionsMapRangeRings->setValidator(rangeRingValidator);
 
@@ -170,6 +171,10 @@ OptionsDialog::OptionsDialog(MainWindow *parentWindow)
   connect(ui->lineEditOptionsWeatherVatsimUrl, &QLineEdit::textEdited,
           this, &OptionsDialog::updateWeatherButtonState);
 
+  // Elevation tile directory
+  connect(ui->pushButtonOptionsRouteElevationDirectorySelect, &QPushButton::clicked,
+          this, &OptionsDialog::selectElevationDirectoryClicked);
+
   // Database exclude path
   connect(ui->pushButtonOptionsDatabaseAddExclude, &QPushButton::clicked,
           this, &OptionsDialog::addDatabaseExcludePathClicked);
@@ -460,6 +465,8 @@ void OptionsDialog::widgetsToOptionData()
   data.mapTextSize = ui->spinBoxOptionsMapTextSize->value();
   data.mapZoomShow = static_cast<float>(ui->doubleSpinBoxOptionsMapZoomShowMap->value());
   data.routeGroundBuffer = ui->spinBoxOptionsRouteGroundBuffer->value();
+  data.profileElevationDirectory =
+    QDir::toNativeSeparators(ui->lineEditOptionsRouteElevationDirectory->text().trimmed());
   data.valid = true;
 }
 
@@ -549,6 +556,7 @@ void OptionsDialog::optionDataToWidgets()
   ui->spinBoxOptionsMapTextSize->setValue(data.mapTextSize);
   ui->doubleSpinBoxOptionsMapZoomShowMap->setValue(data.mapZoomShow);
   ui->spinBoxOptionsRouteGroundBuffer->setValue(data.routeGroundBuffer);
+  ui->lineEditOptionsRouteElevationDirectory->setText(QDir::toNativeSeparators(data.profileElevationDirectory));
 }
 
 /* Add flag from checkbox to OptionData flags */
@@ -658,6 +666,19 @@ void OptionsDialog::selectActiveSkyPathClicked()
   updateWeatherButtonState();
 }
 
+/* Show directory dialog to select the SRTM elevation tiles */
+void OptionsDialog::selectElevationDirectoryClicked()
+{
+  qDebug() << "OptionsDialog::selectElevationDirectoryClicked";
+
+  QString path = atools::gui::Dialog(this).openDirectoryDialog(
+    tr("Open Directory with SRTM Elevation Tiles"),
+    lnm::OPTIONS_DIALOG_ELEVATION_DIR_DLG, ui->lineEditOptionsRouteElevationDirectory->text());
+
+  if(!path.isEmpty())
+    ui->lineEditOptionsRouteElevationDirectory->setText(QDir::toNativeSeparators(path));
+}
+
 void OptionsDialog::clearMemCachedClicked()
 {
   qDebug() << "OptionsDialog::clearMemCachedClicked";
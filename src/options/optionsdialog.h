@@ -70,6 +70,7 @@ private:
   void fromFlags(QRadioButton *radioButton, opts::Flags flag);
 
   void selectActiveSkyPathClicked();
+  void selectElevationDirectoryClicked();
   void clearMemCachedClicked();
   void clearDiskCachedClicked();
   void updateWeatherButtonState();
@@ -0,0 +1,256 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "profile/elevationtilestore.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <cmath>
+
+using atools::geo::Pos;
+
+ElevationTileStore::ElevationTileStore()
+{
+
+}
+
+ElevationTileStore::~ElevationTileStore()
+{
+  clear();
+}
+
+void ElevationTileStore::setDirectory(const QString& path)
+{
+  clear();
+
+  QFileInfo fi(path);
+  if(!path.isEmpty() && fi.exists() && fi.isDir())
+  {
+    directory = fi.absoluteFilePath();
+    qInfo() << "Using elevation tiles from" << directory;
+  }
+  else
+  {
+    if(!path.isEmpty())
+      qWarning() << "Elevation tile directory" << path << "not found";
+    directory.clear();
+  }
+}
+
+void ElevationTileStore::clear()
+{
+  QMutexLocker locker(&mutex);
+
+  for(Tile *tile : tiles)
+  {
+    if(tile != nullptr)
+    {
+      tile->file->close();
+      delete tile->file;
+      delete tile;
+    }
+  }
+  tiles.clear();
+}
+
+bool ElevationTileStore::getElevationMeter(const Pos& pos, float& elevationMeter) const
+{
+  return getElevationMeter(tileForPos(pos), pos, elevationMeter);
+}
+
+bool ElevationTileStore::getElevations(const Pos& from, const Pos& to, float spacingMeter,
+                                       QVector<Pos>& elevations) const
+{
+  float distanceMeter = from.distanceMeterTo(to);
+  int numSamples = std::max(static_cast<int>(std::ceil(distanceMeter / spacingMeter)), 1);
+
+  const Tile *tile = nullptr;
+  int lastLonX = 1000, lastLatY = 1000;
+
+  elevations.reserve(elevations.size() + numSamples + 1);
+  for(int i = 0; i <= numSamples; i++)
+  {
+    Pos pos = i == 0 ? from :
+              (i == numSamples ? to :
+               from.interpolate(to, distanceMeter, static_cast<float>(i) / static_cast<float>(numSamples)));
+
+    // Avoid hash lookup and locking for consecutive positions on the same tile
+    int lonX = static_cast<int>(std::floor(pos.getLonX())), latY = static_cast<int>(std::floor(pos.getLatY()));
+    if(lonX != lastLonX || latY != lastLatY)
+    {
+      tile = tileForPos(pos);
+      lastLonX = lonX;
+      lastLatY = latY;
+    }
+
+    float elevationMeter;
+    if(!getElevationMeter(tile, pos, elevationMeter))
+      // Missing tile or large void
+      return false;
+
+    elevations.append(Pos(pos.getLonX(), pos.getLatY(), elevationMeter));
+  }
+  return true;
+}
+
+const ElevationTileStore::Tile *ElevationTileStore::tileForPos(const Pos& pos) const
+{
+  if(directory.isEmpty())
+    return nullptr;
+
+  int lonX = static_cast<int>(std::floor(pos.getLonX()));
+  int latY = static_cast<int>(std::floor(pos.getLatY()));
+
+  // Keep the anti meridian and poles inside the tile grid
+  if(lonX >= 180)
+    lonX -= 360;
+  if(lonX < -180)
+    lonX += 360;
+  latY = std::max(std::min(latY, 89), -90);
+
+  int index = (latY + 90) * 360 + (lonX + 180);
+
+  QMutexLocker locker(&mutex);
+  QHash<int, Tile *>::const_iterator it = tiles.constFind(index);
+  if(it != tiles.constEnd())
+    return it.value();
+
+  // Tile not loaded yet - try to open and map file
+  QString name = QString("%1%2%3%4.hgt").
+                 arg(latY >= 0 ? "N" : "S").arg(std::abs(latY), 2, 10, QChar('0')).
+                 arg(lonX >= 0 ? "E" : "W").arg(std::abs(lonX), 3, 10, QChar('0'));
+
+  Tile *tile = nullptr;
+  QFile *file = new QFile(QDir(directory).filePath(name));
+  if(!file->exists())
+    // Try lowercase file name too
+    file->setFileName(QDir(directory).filePath(name.toLower()));
+
+  if(file->open(QIODevice::ReadOnly))
+  {
+    int size = static_cast<int>(std::sqrt(file->size() / 2));
+    const uchar *data = size > 1 && static_cast<qint64>(size) * size * 2 == file->size() ?
+                        file->map(0, file->size()) : nullptr;
+
+    if(data != nullptr)
+    {
+      tile = new Tile;
+      tile->file = file;
+      tile->data = data;
+      tile->size = size;
+    }
+    else
+      qWarning() << "Cannot map elevation tile" << file->fileName() << file->errorString();
+  }
+
+  if(tile == nullptr)
+    delete file;
+
+  // Remember missing files too to avoid checking them again
+  tiles.insert(index, tile);
+  return tile;
+}
+
+bool ElevationTileStore::getElevationMeter(const Tile *tile, const Pos& pos, float& elevationMeter) const
+{
+  if(tile == nullptr)
+    return false;
+
+  // Position within tile in rows and columns - first row is north
+  float lonX = pos.getLonX() - std::floor(pos.getLonX());
+  float latY = pos.getLatY() - std::floor(pos.getLatY());
+  float column = lonX * (tile->size - 1);
+  float row = (1.f - latY) * (tile->size - 1);
+
+  int column0 = std::min(static_cast<int>(column), tile->size - 2);
+  int row0 = std::min(static_cast<int>(row), tile->size - 2);
+  float fracColumn = column - column0, fracRow = row - row0;
+
+  // Bilinear interpolation leaving out void corners
+  const float weights[4] =
+  {
+    (1.f - fracColumn) * (1.f - fracRow), fracColumn * (1.f - fracRow),
+    (1.f - fracColumn) * fracRow, fracColumn * fracRow
+  };
+  float sum = 0.f, weightSum = 0.f;
+  for(int i = 0; i < 4; i++)
+  {
+    float value;
+    if(sample(tile, row0 + i / 2, column0 + i % 2, value))
+    {
+      sum += value * weights[i];
+      weightSum += weights[i];
+    }
+  }
+
+  if(weightSum > 0.f)
+  {
+    elevationMeter = sum / weightSum;
+    return true;
+  }
+
+  // All corners with a weight are void - use the nearest valid samples
+  return getNearestValidSample(tile, row0, column0, elevationMeter);
+}
+
+bool ElevationTileStore::getNearestValidSample(const Tile *tile, int row, int column, float& value) const
+{
+  // Search in growing squares around the sample and average all valid values of the first square having any
+  for(int radius = 1; radius <= VOID_SEARCH_RADIUS; radius++)
+  {
+    float sum = 0.f;
+    int num = 0;
+    for(int r = std::max(row - radius, 0); r <= std::min(row + radius, tile->size - 1); r++)
+    {
+      for(int c = std::max(column - radius, 0); c <= std::min(column + radius, tile->size - 1); c++)
+      {
+        // Check only the border of the square
+        if(std::abs(r - row) != radius && std::abs(c - column) != radius)
+          continue;
+
+        float sampleValue;
+        if(sample(tile, r, c, sampleValue))
+        {
+          sum += sampleValue;
+          num++;
+        }
+      }
+    }
+
+    if(num > 0)
+    {
+      value = sum / num;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ElevationTileStore::sample(const Tile *tile, int row, int column, float& value) const
+{
+  qint16 raw = qFromBigEndian<qint16>(tile->data + (static_cast<qint64>(row) * tile->size + column) * 2);
+  if(raw == VOID_VALUE)
+    return false;
+
+  value = static_cast<float>(raw);
+  return true;
+}
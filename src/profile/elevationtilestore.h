@@ -0,0 +1,102 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_ELEVATIONTILESTORE_H
+#define LITTLENAVMAP_ELEVATIONTILESTORE_H
+
+#include "geo/pos.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+class QFile;
+
+/*
+ * Reads elevation data from pre-downloaded SRTM tiles in HGT format. This allows to get a complete
+ * elevation profile without network access and without waiting for the Marble elevation model.
+ *
+ * Tiles cover one degree and are named after their south west corner like "N47E008.hgt".
+ * SRTM1 (3601 x 3601) and SRTM3 (1201 x 1201) files are supported. Files are memory mapped on first
+ * access and kept open. Void samples are interpolated from valid neighbours. Missing tiles or large voids
+ * are reported to the caller which can use another elevation source.
+ *
+ * Reading is thread safe.
+ */
+class ElevationTileStore
+{
+public:
+  ElevationTileStore();
+  ~ElevationTileStore();
+
+  /* Set the tile directory and close all open tiles. Store is disabled if path is empty or not a directory.
+   * Must not be called while other threads are reading. */
+  void setDirectory(const QString& path);
+
+  /* true if a valid directory is set */
+  bool isValid() const
+  {
+    return !directory.isEmpty();
+  }
+
+  /* Get ground elevation in meter using bilinear interpolation.
+   * Returns false if the tile is missing or elevation is unknown. */
+  bool getElevationMeter(const atools::geo::Pos& pos, float& elevationMeter) const;
+
+  /* Get positions along the great circle line from and to with an altitude of ground elevation in meter.
+   * Contains the end points and samples with a distance of about spacingMeter.
+   * Returns false if a tile is missing or elevation is unknown for any position. elevations is incomplete then. */
+  bool getElevations(const atools::geo::Pos& from, const atools::geo::Pos& to, float spacingMeter,
+                     QVector<atools::geo::Pos>& elevations) const;
+
+private:
+  /* Memory mapped HGT file */
+  struct Tile
+  {
+    QFile *file = nullptr;
+    const uchar *data = nullptr; /* Big endian signed 16 bit values. First row is north. */
+    int size = 0; /* Number of rows and columns */
+  };
+
+  /* Get tile containing the position or null if there is no file */
+  const Tile *tileForPos(const atools::geo::Pos& pos) const;
+  bool getElevationMeter(const Tile *tile, const atools::geo::Pos& pos, float& elevationMeter) const;
+
+  /* Average of the nearest valid samples around a void area */
+  bool getNearestValidSample(const Tile *tile, int row, int column, float& value) const;
+
+  /* Get sample value. Returns false if the sample is void. */
+  bool sample(const Tile *tile, int row, int column, float& value) const;
+  void clear();
+
+  /* SRTM void value */
+  static Q_DECL_CONSTEXPR qint16 VOID_VALUE = -32768;
+
+  /* Maximum distance in samples to look for valid values around a void area */
+  static Q_DECL_CONSTEXPR int VOID_SEARCH_RADIUS = 10;
+
+  QString directory;
+
+  /* Opened tiles by tile index. Tiles that have no file are stored as null. */
+  mutable QHash<int, Tile *> tiles;
+  mutable QMutex mutex;
+
+  Q_DISABLE_COPY(ElevationTileStore)
+};
+
+#endif // LITTLENAVMAP_ELEVATIONTILESTORE_H
@@ -27,12 +27,14 @@
 #include "common/aircrafttrack.h"
 #include "mapgui/mapwidget.h"
 #include "options/optiondata.h"
+#include "profile/elevationtilestore.h"
 
 #include <QPainter>
 #include <QTimer>
 #include <QRubberBand>
 #include <QMouseEvent>
 #include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <marble/ElevationModel.h>
 #include <marble/GeoDataCoordinates.h>
@@ -63,6 +65,11 @@ ProfileWidget::ProfileWidget(MainWindow *parent)
   elevationModel = mainWindow->getElevationModel();
   routeController = mainWindow->getRouteController();
 
+  // Use local elevation tiles if configured
+  tileStore = new ElevationTileStore();
+  elevationDirectory = OptionData::instance().getProfileElevationDirectory();
+  tileStore->setDirectory(elevationDirectory);
+
   // Create single shot timer that will restart the thread after a delay
   updateTimer = new QTimer(this);
   updateTimer->setSingleShot(true);
@@ -83,15 +90,7 @@ ProfileWidget::~ProfileWidget()
 {
   updateTimer->stop();
   terminateThread();
-}
-
-void ProfileWidget::aircraftTrackPruned()
-{
-  if(!widgetVisible)
-    return;
-
-  updateScreenCoords();
-  update();
+  delete tileStore;
 }
 
 void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
@@ -210,20 +209,7 @@ void ProfileWidget::updateScreenCoords()
   for(const ElevationLeg& leg : legList.elevationLegs)
   {
     waypointX.append(X0 + static_cast<int>(leg.distances.first() * horizontalScale));
-
-    QPoint lastPt;
-    for(int i = 0; i < leg.elevation.size(); i++)
-    {
-      float alt = leg.elevation.at(i).getAltitude();
-      QPoint pt(X0 + static_cast<int>(leg.distances.at(i) * horizontalScale),
-                Y0 + static_cast<int>(h - alt * verticalScale));
-
-      if(lastPt.isNull() || i == leg.elevation.size() - 1 || (lastPt - pt).manhattanLength() > 2)
-      {
-        landPolygon.append(pt);
-        lastPt = pt;
-      }
-    }
+    appendLegEnvelope(leg, h, landPolygon);
   }
   // Destination point
   waypointX.append(X0 + w);
@@ -237,19 +223,67 @@ void ProfileWidget::updateScreenCoords()
     const RouteMapObjectList& rmoList = legList.routeMapObjects;
     const AircraftTrack& aircraftTrack = mapWidget->getAircraftTrack();
 
-    for(int i = 0; i < aircraftTrack.size(); i++)
+    // Use the simplified track that fits the horizontal resolution of the profile
+    // Completed chunks are simplified and the last one is limited by the chunk size
+    int level = horizontalScale > 0.f ?
+                AircraftTrack::levelForResolution(atools::geo::nmToMeter(1.f) / horizontalScale) : 0;
+
+    for(const at::AircraftTrackChunk& chunk : aircraftTrack.getChunks())
     {
-      const Pos& p = aircraftTrack.at(i).pos;
-      float distFromStart = 0.f;
-      if(rmoList.getRouteDistances(p, &distFromStart, nullptr))
+      for(int i = 0; i < chunk.size(level); i++)
       {
-        QPoint pt(X0 + static_cast<int>(distFromStart * horizontalScale),
-                  Y0 + static_cast<int>(rect().height() - Y0 - p.getAltitude() * verticalScale));
+        const Pos& p = chunk.at(level, i).pos;
+        float distFromStart = 0.f;
+        if(rmoList.getRouteDistances(p, &distFromStart, nullptr))
+        {
+          QPoint pt(X0 + static_cast<int>(distFromStart * horizontalScale),
+                    Y0 + static_cast<int>(rect().height() - Y0 - p.getAltitude() * verticalScale));
+
+          if(aircraftTrackPoints.isEmpty() || (aircraftTrackPoints.last() - pt).manhattanLength() > 3)
+            aircraftTrackPoints.append(pt);
+        }
+      }
+    }
+  }
+}
+
+/* Adds the elevation points of a leg to the polygon. Only the lowest and highest point of each pixel column
+ * are kept in order of appearance. This keeps all peaks while limiting the polygon size to the widget width.
+ * First and last point of the leg are always added. */
+void ProfileWidget::appendLegEnvelope(const ElevationLeg& leg, int h, QPolygon& polygon) const
+{
+  int numPoints = leg.elevation.size();
+  int i = 0;
+  while(i < numPoints)
+  {
+    int x = X0 + static_cast<int>(leg.distances.at(i) * horizontalScale);
+
+    // Find lowest and highest point in this column
+    int minIndex = i, maxIndex = i, j = i + 1;
+    while(j < numPoints && X0 + static_cast<int>(leg.distances.at(j) * horizontalScale) == x)
+    {
+      float alt = leg.elevation.at(j).getAltitude();
+      if(alt < leg.elevation.at(minIndex).getAltitude())
+        minIndex = j;
+      if(alt > leg.elevation.at(maxIndex).getAltitude())
+        maxIndex = j;
+      j++;
+    }
 
-        if(aircraftTrackPoints.isEmpty() || (aircraftTrackPoints.last() - pt).manhattanLength() > 3)
-          aircraftTrackPoints.append(pt);
+    int indexes[4] = {i == 0 ? i : -1, minIndex, maxIndex, j == numPoints ? j - 1 : -1};
+    std::sort(indexes, indexes + 4);
+
+    int lastIndex = -1;
+    for(int index : indexes)
+    {
+      if(index != -1 && index != lastIndex)
+      {
+        float alt = leg.elevation.at(index).getAltitude();
+        polygon.append(QPoint(x, Y0 + static_cast<int>(h - alt * verticalScale)));
+        lastIndex = index;
       }
     }
+    i = j;
   }
 }
 
@@ -460,6 +494,13 @@ void ProfileWidget::paintEvent(QPaintEvent *)
       texts.append(QLocale().toString(aircraftDistanceFromStart, 'f', 0) + tr(" nm ► ") +
                    QLocale().toString(aircraftDistanceToDest, 'f', 0) + tr(" nm"));
 
+      // Highest ground along the flight plan ahead of the aircraft
+      float terrainAheadFt = maxElevationFt(aircraftDistanceFromStart,
+                                            aircraftDistanceFromStart + TERRAIN_AHEAD_NM);
+      texts.append(tr("Terrain %1 nm ahead: %2 ft").
+                   arg(QLocale().toString(TERRAIN_AHEAD_NM, 'f', 0)).
+                   arg(QLocale().toString(terrainAheadFt, 'f', 0)));
+
       textatt::TextAttributes att = textatt::BOLD;
       int textx = acx, texty = acy + 20;
 
@@ -483,6 +524,21 @@ void ProfileWidget::elevationUpdateAvailable()
   if(!widgetVisible || databaseLoadStatus)
     return;
 
+  if(tileStore->isValid())
+  {
+    // Local tiles are complete on first calculation - update only if legs were read from the elevation model
+    bool elevationModelUsed = false;
+    for(const ElevationLeg& leg : legList.elevationLegs)
+      elevationModelUsed |= leg.elevationModel;
+
+    if(!elevationModelUsed)
+      return;
+  }
+
+  // New tiles are available - cached legs might be incomplete
+  legCache.clear();
+  elevationGeneration++;
+
   // Do not terminate thread here since this can lead to starving updates
 
   // Start thread after long delay to calculate new data
@@ -527,6 +583,8 @@ void ProfileWidget::updateTimeout()
   // Start the computation in background
   ElevationLegList legs;
   legs.routeMapObjects = routeController->getRouteMapObjects();
+  legs.legCache = legCache;
+  legs.elevationGeneration = elevationGeneration;
 
   // Start thread
   future = QtConcurrent::run(this, &ProfileWidget::fetchRouteElevationsThread, legs);
@@ -547,6 +605,7 @@ void ProfileWidget::updateThreadFinished()
   {
     // Was not terminated in the middle of calculations - get result from the future
     legList = future.result();
+    updateLegCache();
     updateScreenCoords();
     update();
     // mainWindow->statusMessage(tr("Elevation data updated."));
@@ -618,85 +677,227 @@ bool ProfileWidget::fetchRouteElevations(Marble::GeoDataLineString& elevations,
   return true;
 }
 
-/* Background thread. Fetches elevation points from Marble elevation model and updates totals. */
+ProfileWidget::ElevationLeg ProfileWidget::ElevationLegJob::operator()(int routeIndex) const
+{
+  ElevationLegCache::const_iterator it = legCache->constFind(legKey(*routeMapObjects, routeIndex));
+  if(it != legCache->constEnd())
+    // Leg end points did not change - no need to fetch again
+    return it.value();
+  else
+    return widget->fetchLegElevations(*routeMapObjects, routeIndex, widget->tileStore->isValid());
+}
+
+ProfileWidget::ElevationLegKey ProfileWidget::legKey(const RouteMapObjectList& routeMapObjects, int routeIndex)
+{
+  const Pos& from = routeMapObjects.at(routeIndex - 1).getPosition();
+  const Pos& to = routeMapObjects.at(routeIndex).getPosition();
+
+  ElevationLegKey key;
+  key.fromLonX = from.getLonX();
+  key.fromLatY = from.getLatY();
+  key.toLonX = to.getLonX();
+  key.toLatY = to.getLatY();
+  key.dropPoints = routeIndex - 1 > 2;
+  return key;
+}
+
+/* Replace cache with the legs of the current result. Called in the main thread. */
+void ProfileWidget::updateLegCache()
+{
+  legCache.clear();
+
+  if(legList.elevationGeneration != elevationGeneration)
+    // Elevation model was updated while calculating - do not keep the old data
+    return;
+
+  for(int i = 0; i < legList.elevationLegs.size(); i++)
+  {
+    ElevationLeg leg = legList.elevationLegs.at(i);
+    if(leg.distances.isEmpty())
+      continue;
+
+    // Store distances relative to the start of the leg
+    float startDistance = leg.distances.first();
+    for(float& dist : leg.distances)
+      dist -= startDistance;
+
+    legCache.insert(legKey(legList.routeMapObjects, i + 1), leg);
+  }
+
+  // Copy is not needed anymore
+  legList.legCache.clear();
+}
+
+/* Background thread. Fetches elevation points for all legs and updates totals. */
 ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(ElevationLegList legs) const
 {
   QThread::currentThread()->setPriority(QThread::LowestPriority);
   // qDebug() << "priority" << QThread::currentThread()->priority();
 
-  using atools::geo::meterToNm;
-  using atools::geo::meterToFeet;
-
   legs.totalNumPoints = 0;
   legs.totalDistance = 0.f;
   legs.maxElevationFt = 0.f;
   legs.elevationLegs.clear();
 
-  // Loop over all route legs
+  // Each job calculates the leg ending at the route index
+  QList<int> routeIndexes;
   for(int i = 1; i < legs.routeMapObjects.size(); i++)
-  {
-    if(terminateThreadSignal)
-      // Return empty result
-      return ElevationLegList();
+    routeIndexes.append(i);
 
-    const RouteMapObject& lastRmo = legs.routeMapObjects.at(i - 1);
-    const RouteMapObject& rmo = legs.routeMapObjects.at(i);
+  ElevationLegJob job;
+  job.widget = this;
+  job.routeMapObjects = &legs.routeMapObjects;
+  job.legCache = &legs.legCache;
 
-    GeoDataLineString elevations;
-    elevations.setTessellate(true);
-    if(!fetchRouteElevations(elevations, lastRmo.getPosition(), rmo.getPosition()))
-      return ElevationLegList();
+  QList<ElevationLeg> elevationLegs;
+  if(tileStore->isValid())
+  {
+    // Tile store is thread safe - calculate legs in the thread pool. Results are in the order of the route.
+    elevationLegs = QtConcurrent::blockingMapped<QList<ElevationLeg> >(routeIndexes, job);
 
-    // Loop over all elevation points for the current leg
-    ElevationLeg leg;
-    Pos lastPos;
-    for(int j = 0; j < elevations.size(); j++)
+    // Fetch legs crossing missing tiles or voids from the elevation model one by one in this thread
+    for(int i = 0; i < elevationLegs.size(); i++)
     {
       if(terminateThreadSignal)
-        return ElevationLegList();
-
-      const GeoDataCoordinates& coord = elevations.at(j);
-      double altFeet = meterToFeet(coord.altitude());
-
-      // Limit ground altitude to 30000 feet
-      altFeet = std::min(altFeet, 30000.);
+        break;
 
-      Pos pos(coord.longitude(GeoDataCoordinates::Degree), coord.latitude(GeoDataCoordinates::Degree),
-              altFeet);
+      if(elevationLegs.at(i).elevation.isEmpty())
+        elevationLegs[i] = fetchLegElevations(legs.routeMapObjects, routeIndexes.at(i), false);
+    }
+  }
+  else
+  {
+    // Marble elevation model is not thread safe - calculate legs one by one in this thread
+    for(int routeIndex : routeIndexes)
+    {
+      if(terminateThreadSignal)
+        break;
+      elevationLegs.append(job(routeIndex));
+    }
+  }
 
-      // Drop points with similar altitude except the first and last one on a segment
-      if(lastPos.isValid() && j != 0 && j != elevations.size() - 1 &&
-         legs.elevationLegs.size() > 2 &&
-         atools::almostEqual(pos.getAltitude(), lastPos.getAltitude(), 10.f))
-        continue;
+  if(terminateThreadSignal)
+    // Return empty result
+    return ElevationLegList();
 
-      float alt = pos.getAltitude();
+  // Leg distances are relative to the start of the leg - add distance from departure
+  QVector<float> elevations;
+  legs.distances.clear();
+  for(ElevationLeg& leg : elevationLegs)
+  {
+    for(float& dist : leg.distances)
+      dist += legs.totalDistance;
 
-      // Adjust maximum
-      if(alt > leg.maxElevation)
-        leg.maxElevation = alt;
-      if(alt > legs.maxElevationFt)
-        legs.maxElevationFt = alt;
+    if(!leg.distances.isEmpty())
+      legs.totalDistance = leg.distances.last();
 
-      leg.elevation.append(pos);
-      if(j > 0)
-      {
-        // Update total distance
-        float dist = meterToNm(lastPos.distanceMeterTo(pos));
-        legs.totalDistance += dist;
-      }
-      // Distance to elevation point from departure
-      leg.distances.append(legs.totalDistance);
+    legs.distances.append(leg.distances);
+    for(const Pos& pos : leg.elevation)
+      elevations.append(pos.getAltitude());
 
-      legs.totalNumPoints++;
-      lastPos = pos;
-    }
+    legs.totalNumPoints += leg.elevation.size();
     legs.elevationLegs.append(leg);
   }
 
+  // Build index for range maximum queries
+  legs.elevationIndex.build(elevations);
+  if(!legs.elevationIndex.isEmpty())
+    legs.maxElevationFt = std::max(legs.elevationIndex.maximum(0, legs.elevationIndex.size() - 1), 0.f);
+
   return legs;
 }
 
+float ProfileWidget::maxElevationFt(float fromDistance, float toDistance) const
+{
+  const QVector<float>& distances = legList.distances;
+  if(legList.elevationIndex.isEmpty() || distances.size() != legList.elevationIndex.size())
+    return 0.f;
+
+  // Include the points just outside of the range since ground is interpolated between them
+  int first = static_cast<int>(std::upper_bound(distances.begin(), distances.end(), fromDistance) -
+                               distances.begin()) - 1;
+  int last = static_cast<int>(std::lower_bound(distances.begin(), distances.end(), toDistance) -
+                              distances.begin());
+
+  first = std::max(std::min(first, distances.size() - 1), 0);
+  last = std::max(std::min(last, distances.size() - 1), 0);
+
+  return legList.elevationIndex.maximum(first, last);
+}
+
+/* Fetches elevation points from the tile store or the Marble elevation model for one leg.
+ * Called in the thread pool if the tile store is used. Distances are measured from the start of the leg.
+ * Returns an empty leg if tiles are missing or elevation is unknown in the tile store. */
+ProfileWidget::ElevationLeg ProfileWidget::fetchLegElevations(const RouteMapObjectList& routeMapObjects,
+                                                              int routeIndex, bool useTileStore) const
+{
+  using atools::geo::meterToNm;
+  using atools::geo::meterToFeet;
+
+  ElevationLeg leg;
+  if(terminateThreadSignal)
+    return leg;
+
+  const RouteMapObject& lastRmo = routeMapObjects.at(routeIndex - 1);
+  const RouteMapObject& rmo = routeMapObjects.at(routeIndex);
+
+  GeoDataLineString elevations;
+  elevations.setTessellate(true);
+  if(useTileStore)
+  {
+    // Read from local tiles along the great circle line
+    QVector<Pos> positions;
+    if(!tileStore->getElevations(lastRmo.getPosition(), rmo.getPosition(), ELEVATION_SAMPLE_SPACING_METER,
+                                 positions))
+      return leg;
+
+    for(const Pos& pos : positions)
+      elevations.append(GeoDataCoordinates(pos.getLonX(), pos.getLatY(), pos.getAltitude(),
+                                           GeoDataCoordinates::Degree));
+  }
+  else
+  {
+    if(!fetchRouteElevations(elevations, lastRmo.getPosition(), rmo.getPosition()))
+      return leg;
+    leg.elevationModel = true;
+  }
+
+  // Loop over all elevation points for the current leg
+  float distance = 0.f;
+  Pos lastPos;
+  for(int j = 0; j < elevations.size(); j++)
+  {
+    if(terminateThreadSignal)
+      return ElevationLeg();
+
+    const GeoDataCoordinates& coord = elevations.at(j);
+    double altFeet = meterToFeet(coord.altitude());
+
+    // Limit ground altitude to 30000 feet
+    altFeet = std::min(altFeet, 30000.);
+
+    Pos pos(coord.longitude(GeoDataCoordinates::Degree), coord.latitude(GeoDataCoordinates::Degree),
+            altFeet);
+
+    // Drop points with similar altitude except the first and last one on a segment
+    // Only done after the first three legs
+    if(lastPos.isValid() && j != 0 && j != elevations.size() - 1 &&
+       routeIndex - 1 > 2 &&
+       atools::almostEqual(pos.getAltitude(), lastPos.getAltitude(), 10.f))
+      continue;
+
+    leg.elevation.append(pos);
+    if(j > 0)
+      // Update leg distance
+      distance += meterToNm(lastPos.distanceMeterTo(pos));
+
+    // Distance to elevation point from start of leg
+    leg.distances.append(distance);
+    lastPos = pos;
+  }
+  return leg;
+}
+
 void ProfileWidget::showEvent(QShowEvent *)
 {
   widgetVisible = true;
@@ -783,7 +984,8 @@ void ProfileWidget::mouseMoveEvent(QMouseEvent *mouseEvent)
 
   // Calculate min altitude for this leg
   float maxElev =
-    std::ceil((leg.maxElevation + OptionData::instance().getRouteGroundBuffer()) / 500.f) * 500.f;
+    std::ceil((maxElevationFt(leg.distances.first(), leg.distances.last()) +
+               OptionData::instance().getRouteGroundBuffer()) / 500.f) * 500.f;
 
   // Get from/to text
   QString from = legList.routeMapObjects.at(index).getIdent();
@@ -851,6 +1053,19 @@ void ProfileWidget::postDatabaseLoad()
 
 void ProfileWidget::optionsChanged()
 {
+  const QString& dir = OptionData::instance().getProfileElevationDirectory();
+  if(dir != elevationDirectory)
+  {
+    // Tile store must not be changed while the thread is reading - calculate all legs again
+    updateTimer->stop();
+    terminateThread();
+    elevationDirectory = dir;
+    tileStore->setDirectory(elevationDirectory);
+    legCache.clear();
+    elevationGeneration++;
+    routeChanged(true);
+  }
+
   updateScreenCoords();
   update();
 }
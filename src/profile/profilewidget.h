@@ -19,10 +19,12 @@
 #define LITTLENAVMAP_PROFILEWIDGET_H
 
 #include "route/routemapobjectlist.h"
+#include "profile/rangemaxindex.h"
 #include "fs/sc/simconnectdata.h"
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QWidget>
 
 namespace Marble {
@@ -32,6 +34,7 @@ class GeoDataLineString;
 
 class MainWindow;
 class RouteController;
+class ElevationTileStore;
 class QTimer;
 class QRubberBand;
 
@@ -39,6 +42,7 @@ class QRubberBand;
  * Loads and displays the flight plan elevation profile. The elevation data is
  * calculated in a background thread that is triggered when new elevation data
  * arrives from the Marble widget.
+ * If a directory with SRTM tiles is configured these are used instead of the Marble elevation model.
  */
 class ProfileWidget :
   public QWidget
@@ -55,9 +59,6 @@ public:
   /* Update user aircraft on profile display */
   void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
 
-  /* Track was shortened and needs a full update */
-  void aircraftTrackPruned();
-
   /* Stops showing the user aircraft */
   void disconnectedFromSimulator();
 
@@ -100,17 +101,58 @@ private:
     QVector<atools::geo::Pos> elevation; /* Ground elevation (Pos.altitude) and position */
     QVector<float> distances; /* Distances along the route for each elevation point.
                                *  Measured from departure point. Nautical miles. */
-    float maxElevation = 0.f; /* Max ground altitude for this leg */
+    bool elevationModel = false; /* Read from the Marble elevation model which might still be incomplete */
   };
 
+  /* Identifies a leg by its end points in the elevation cache */
+  struct ElevationLegKey
+  {
+    float fromLonX, fromLatY, toLonX, toLatY;
+    bool dropPoints; /* Points with similar altitude were removed */
+
+    bool operator==(const ElevationLegKey& other) const
+    {
+      return fromLonX == other.fromLonX && fromLatY == other.fromLatY &&
+             toLonX == other.toLonX && toLatY == other.toLatY && dropPoints == other.dropPoints;
+    }
+
+    friend uint qHash(const ElevationLegKey& key)
+    {
+      return qHash(key.fromLonX) ^ (qHash(key.fromLatY) << 1) ^ (qHash(key.toLonX) << 2) ^
+             (qHash(key.toLatY) << 3) ^ static_cast<uint>(key.dropPoints);
+    }
+
+  };
+
+  /* Cached legs with distances measured from the start of each leg */
+  typedef QHash<ElevationLegKey, ElevationLeg> ElevationLegCache;
+
   struct ElevationLegList
   {
     RouteMapObjectList routeMapObjects; /* Copy from route controller.
                                          * Need a copy to avoid thread synchronization problems. */
+    ElevationLegCache legCache; /* Copy of the cache. Legs found here are not fetched again. */
+    int elevationGeneration = 0; /* Elevation model state at start of calculation */
     QList<ElevationLeg> elevationLegs; /* Elevation data for each route leg */
     float maxElevationFt = 0.f /* Maximum ground elevation for the route */,
           totalDistance = 0.f /* Total route distance in nautical miles */;
     int totalNumPoints = 0; /* Number of elevation points in whole flight plan */
+
+    QVector<float> distances; /* Distances of all elevation points of all legs */
+    RangeMaxIndex elevationIndex; /* Ground elevation in feet for each entry in distances */
+  };
+
+  /* Functor for QtConcurrent::blockingMapped or a plain loop. Calculates the elevation points for the leg
+   * ending at the given route index. */
+  struct ElevationLegJob
+  {
+    typedef ElevationLeg result_type;
+
+    ElevationLeg operator()(int routeIndex) const;
+
+    const ProfileWidget *widget;
+    const RouteMapObjectList *routeMapObjects;
+    const ElevationLegCache *legCache;
   };
 
   virtual void paintEvent(QPaintEvent *) override;
@@ -123,10 +165,18 @@ private:
   bool fetchRouteElevations(Marble::GeoDataLineString& elevations, const atools::geo::Pos& lastPos,
                             const atools::geo::Pos& curPos) const;
   ElevationLegList fetchRouteElevationsThread(ElevationLegList legs) const;
+  ElevationLeg fetchLegElevations(const RouteMapObjectList& routeMapObjects, int routeIndex,
+                                  bool useTileStore) const;
+  static ElevationLegKey legKey(const RouteMapObjectList& routeMapObjects, int routeIndex);
+
+  /* Get highest ground elevation in feet between the two distances from departure in nautical miles */
+  float maxElevationFt(float fromDistance, float toDistance) const;
+  void updateLegCache();
   void elevationUpdateAvailable();
   void updateTimeout();
   void updateThreadFinished();
   void updateScreenCoords();
+  void appendLegEnvelope(const ElevationLeg& leg, int h, QPolygon& polygon) const;
   void terminateThread();
 
   /* Scale levels to test for display */
@@ -142,6 +192,12 @@ private:
   /* Thread will start after this delay if an elevation update arrives */
   static Q_DECL_CONSTEXPR int ELEVATION_CHANGE_UPDATE_TIMEOUT_MS = 5000;
 
+  /* Highest ground elevation is shown for this distance ahead of the user aircraft */
+  static Q_DECL_CONSTEXPR float TERRAIN_AHEAD_NM = 20.f;
+
+  /* Distance between elevation points when reading from local tiles */
+  static Q_DECL_CONSTEXPR float ELEVATION_SAMPLE_SPACING_METER = 250.f;
+
   /* User aircraft data */
   atools::fs::sc::SimConnectData simData, lastSimData;
   QPolygon aircraftTrackPoints;
@@ -149,7 +205,15 @@ private:
   float aircraftDistanceFromStart, aircraftDistanceToDest;
   ElevationLegList legList;
 
+  /* Legs of the last calculation. Only changed legs are fetched again when the route is edited. */
+  ElevationLegCache legCache;
+  /* Incremented when the elevation model has new data which invalidates the cache */
+  int elevationGeneration = 0;
+
   const Marble::ElevationModel *elevationModel = nullptr;
+  ElevationTileStore *tileStore = nullptr;
+  /* Tile directory from options that was used for tileStore */
+  QString elevationDirectory;
   RouteController *routeController = nullptr;
   MainWindow *mainWindow;
 
@@ -0,0 +1,70 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "profile/rangemaxindex.h"
+
+#include <algorithm>
+
+RangeMaxIndex::RangeMaxIndex()
+{
+
+}
+
+RangeMaxIndex::~RangeMaxIndex()
+{
+
+}
+
+void RangeMaxIndex::build(const QVector<float>& values)
+{
+  levels.clear();
+  if(values.isEmpty())
+    return;
+
+  levels.append(values);
+
+  for(int span = 1; span * 2 <= values.size(); span *= 2)
+  {
+    // Each entry combines two entries of the level below
+    const QVector<float>& lower = levels.last();
+    QVector<float> level(lower.size() - span);
+    for(int i = 0; i < level.size(); i++)
+      level[i] = std::max(lower.at(i), lower.at(i + span));
+    levels.append(level);
+  }
+}
+
+void RangeMaxIndex::clear()
+{
+  levels.clear();
+}
+
+float RangeMaxIndex::maximum(int first, int last) const
+{
+  if(first > last)
+    std::swap(first, last);
+
+  // Find largest level with a span that fits into the range
+  int length = last - first + 1, level = 0;
+  while((2 << level) <= length)
+    level++;
+
+  // Two overlapping spans cover the whole range
+  const QVector<float>& values = levels.at(level);
+  return std::max(values.at(first), values.at(last - (1 << level) + 1));
+}
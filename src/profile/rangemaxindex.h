@@ -0,0 +1,58 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_RANGEMAXINDEX_H
+#define LITTLENAVMAP_RANGEMAXINDEX_H
+
+#include <QVector>
+
+/*
+ * Sparse table that answers "maximum value between two indexes" in constant time.
+ * Building needs O(n log n) time and memory. Values cannot be changed after building.
+ */
+class RangeMaxIndex
+{
+public:
+  RangeMaxIndex();
+  ~RangeMaxIndex();
+
+  /* Build the table for all values */
+  void build(const QVector<float>& values);
+
+  void clear();
+
+  /* Get maximum of all values from first to last inclusive. Indexes must be valid. */
+  float maximum(int first, int last) const;
+
+  bool isEmpty() const
+  {
+    return levels.isEmpty();
+  }
+
+  /* Number of values */
+  int size() const
+  {
+    return levels.isEmpty() ? 0 : levels.first().size();
+  }
+
+private:
+  /* levels[k][i] is the maximum of the values i to i + 2^k - 1. Level 0 contains the values. */
+  QVector<QVector<float> > levels;
+};
+
+#endif // LITTLENAVMAP_RANGEMAXINDEX_H
@@ -18,6 +18,28 @@
 #include "route/routecommand.h"
 #include "route/routecontroller.h"
 
+using atools::fs::pln::Flightplan;
+using atools::fs::pln::FlightplanEntry;
+
+/* Compare all fields of an entry that are relevant for route map objects */
+static bool entriesEqual(const FlightplanEntry& entry1, const FlightplanEntry& entry2)
+{
+  return entry1.getWaypointType() == entry2.getWaypointType() &&
+         entry1.getIcaoIdent() == entry2.getIcaoIdent() &&
+         entry1.getIcaoRegion() == entry2.getIcaoRegion() &&
+         entry1.getWaypointId() == entry2.getWaypointId() &&
+         entry1.getAirway() == entry2.getAirway() &&
+         entry1.getPosition() == entry2.getPosition();
+}
+
+/* Copy of the flight plan without entries */
+static Flightplan flightplanHeader(const Flightplan& flightplan)
+{
+  Flightplan header(flightplan);
+  header.getEntries().clear();
+  return header;
+}
+
 RouteCommand::RouteCommand(RouteController *routeController,
                            const atools::fs::pln::Flightplan& flightplanBefore, const QString& text,
                            rctype::RouteCmdType rcType)
@@ -33,12 +55,43 @@ RouteCommand::~RouteCommand()
 
 void RouteCommand::setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter)
 {
-  planAfterChange = flightplanAfter;
+  const QList<FlightplanEntry>& before = planBeforeChange.getEntries();
+  const QList<FlightplanEntry>& after = flightplanAfter.getEntries();
+  int minSize = std::min(before.size(), after.size());
+
+  // Find equal entries at the start and the end of both lists
+  int prefix = 0;
+  while(prefix < minSize && entriesEqual(before.at(prefix), after.at(prefix)))
+    prefix++;
+
+  int suffix = 0;
+  while(suffix < minSize - prefix &&
+        entriesEqual(before.at(before.size() - 1 - suffix), after.at(after.size() - 1 - suffix)))
+    suffix++;
+
+  // Departure parking and start position are resolved for the first entry only - recreate it if changed
+  if(planBeforeChange.getDepartureParkingName() != flightplanAfter.getDepartureParkingName() ||
+     !(planBeforeChange.getDeparturePosition() == flightplanAfter.getDeparturePosition()))
+    prefix = 0;
+
+  // Always replace the first entry if the start of the list changes so it gets departure information
+  if(prefix == 0 && suffix > 0 && (before.size() - suffix == 0 || after.size() - suffix == 0))
+    suffix--;
+
+  rctype::RouteDelta delta;
+  delta.firstIndex = prefix;
+  delta.entriesBefore = before.mid(prefix, before.size() - prefix - suffix);
+  delta.entriesAfter = after.mid(prefix, after.size() - prefix - suffix);
+  delta.headerBefore = flightplanHeader(planBeforeChange);
+  delta.headerAfter = flightplanHeader(flightplanAfter);
+  deltas.append(delta);
+
+  planBeforeChange = Flightplan();
 }
 
 void RouteCommand::undo()
 {
-  controller->changeRouteUndo(planBeforeChange);
+  controller->changeRouteUndo(deltas);
 }
 
 void RouteCommand::redo()
@@ -47,7 +100,7 @@ void RouteCommand::redo()
     // Skip first redo - I need to do the initial changes myself
     firstRedoExecuted = true;
   else
-    controller->changeRouteRedo(planAfterChange);
+    controller->changeRouteRedo(deltas);
 }
 
 int RouteCommand::id() const
@@ -73,8 +126,17 @@ bool RouteCommand::mergeWith(const QUndoCommand *other)
     case rctype::DELETE:
     case rctype::MOVE:
     case rctype::ALTITUDE:
-      // Merge - overwrite the flight plan after the change
-      planAfterChange = newCmd->planAfterChange;
+      // Merge - append the changes of the new command
+      for(const rctype::RouteDelta& delta : newCmd->deltas)
+      {
+        if(!deltas.isEmpty() && deltas.last().entriesBefore.isEmpty() && deltas.last().entriesAfter.isEmpty() &&
+           delta.entriesBefore.isEmpty() && delta.entriesAfter.isEmpty())
+          // Both change only the header - combine them
+          deltas.last().headerAfter = delta.headerAfter;
+        else
+          deltas.append(delta);
+      }
+
       // Let controller know about the merge so the undo index can be adapted
       controller->undoMerge();
       return true;
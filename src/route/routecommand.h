@@ -35,11 +35,23 @@ enum RouteCmdType
   REVERSE = 3 /* Route reverse action */
 };
 
+/*
+ * Changed part of a flight plan. All entries before firstIndex and after the changed range are equal
+ * in both versions. Headers are flight plan copies without entries.
+ */
+struct RouteDelta
+{
+  int firstIndex = 0;
+  QList<atools::fs::pln::FlightplanEntry> entriesBefore, entriesAfter;
+  atools::fs::pln::Flightplan headerBefore, headerAfter;
+};
+
 }
 
 /*
  * Flight plan undo command including a few workaround for QUndoCommand inflexibilities.
- * Keeps a copy of the flight plan before and after the change.
+ * Keeps only the changed entries and the flight plan header before and after the change.
+ * Merged commands keep a list of changes.
  */
 class RouteCommand :
   public QUndoCommand
@@ -52,7 +64,8 @@ public:
   virtual void undo() override;
   virtual void redo() override;
 
-  /* Need to keep both versions in a redundant way since linking between commands is not reliable */
+  /* Calculates the change between the flight plan given in the constructor and this one.
+   * Drops the copy of the flight plan before the change. */
   void setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter);
 
 private:
@@ -63,7 +76,12 @@ private:
   bool firstRedoExecuted = false;
   RouteController *controller;
   rctype::RouteCmdType type;
-  atools::fs::pln::Flightplan planBeforeChange, planAfterChange;
+
+  /* Only valid until setFlightplanAfter is called */
+  atools::fs::pln::Flightplan planBeforeChange;
+
+  /* Changes in order of execution */
+  QList<rctype::RouteDelta> deltas;
 };
 
 #endif // LITTLENAVMAP_ROUTECOMMAND_H
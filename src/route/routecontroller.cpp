@@ -34,6 +34,7 @@
 #include "parkingdialog.h"
 #include "route/routefinder.h"
 #include "route/routeicondelegate.h"
+#include "route/routetablemodel.h"
 #include "route/routenetworkairway.h"
 #include "route/routenetworkradio.h"
 #include "settings/settings.h"
@@ -48,48 +49,9 @@
 
 #include <QClipboard>
 #include <QFile>
-#include <QStandardItemModel>
 
 #include <marble/GeoDataLineString.h>
 
-// Route table colum headings
-const QList<QString> ROUTE_COLUMNS({QObject::tr("Ident"),
-                                    QObject::tr("Region"),
-                                    QObject::tr("Name"),
-                                    QObject::tr("Airway"),
-                                    QObject::tr("Type"),
-                                    QObject::tr("Freq.\nMHz/kHz"),
-                                    QObject::tr("Range\nnm"),
-                                    QObject::tr("Course\n°M"),
-                                    QObject::tr("Direct\n°M"),
-                                    QObject::tr("Distance\nnm"),
-                                    QObject::tr("Remaining\nnm"),
-                                    QObject::tr("Leg Time\nhh:mm"),
-                                    QObject::tr("ETA\nhh:mm UTC")});
-
-namespace rc {
-// Route table column indexes
-enum RouteColumns
-{
-  FIRST_COLUMN,
-  IDENT = FIRST_COLUMN,
-  REGION,
-  NAME,
-  AIRWAY,
-  TYPE,
-  FREQ,
-  RANGE,
-  COURSE,
-  DIRECT,
-  DIST,
-  REMAINING_DISTANCE,
-  LEG_TIME,
-  ETA,
-  LAST_COLUMN = ETA
-};
-
-}
-
 using namespace atools::fs::pln;
 using namespace atools::geo;
 using Marble::GeoDataLatLonBox;
@@ -149,7 +111,7 @@ RouteController::RouteController(MainWindow *parentWindow, MapQuery *mapQuery, Q
   view->verticalHeader()->setSectionsMovable(false);
   view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
-  model = new QStandardItemModel();
+  model = new RouteTableModel(route);
   QItemSelectionModel *m = view->selectionModel();
   view->setModel(model);
   delete m;
@@ -273,14 +235,7 @@ QString RouteController::tableAsHtml(int iconSizePixel) const
 
     // Rest of columns
     for(int col = 0; col < model->columnCount(); col++)
-    {
-      QStandardItem *item = model->item(row, header->logicalIndex(col));
-
-      if(item != nullptr)
-        html.td(item->text().toHtmlEscaped());
-      else
-        html.td(QString());
-    }
+      html.td(model->getText(row, header->logicalIndex(col)).toHtmlEscaped());
     html.trEnd();
   }
   html.tableEnd();
@@ -384,7 +339,6 @@ void RouteController::saveState()
 void RouteController::restoreState()
 {
   Ui::MainWindow *ui = mainWindow->getUi();
-  model->setHorizontalHeaderLabels(ROUTE_COLUMNS);
   atools::gui::WidgetState(lnm::ROUTE_VIEW).restore({view, ui->spinBoxRouteSpeed,
                                                      ui->comboBoxRouteType,
                                                      ui->spinBoxRouteAlt});
@@ -1077,22 +1031,22 @@ void RouteController::tableSelectionChanged(const QItemSelection& selected, cons
 }
 
 /* Called by undo command */
-void RouteController::changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteUndo(const QList<rctype::RouteDelta>& deltas)
 {
   // Keep our own index as a workaround
   undoIndex--;
 
   qDebug() << "changeRouteUndo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(deltas, true);
 }
 
 /* Called by undo command */
-void RouteController::changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteRedo(const QList<rctype::RouteDelta>& deltas)
 {
   // Keep our own index as a workaround
   undoIndex++;
   qDebug() << "changeRouteRedo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(deltas, false);
 }
 
 /* Called by undo command when commands are merged */
@@ -1102,12 +1056,26 @@ void RouteController::undoMerge()
   qDebug() << "undoMerge undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
 }
 
-/* Update window after undo or redo action */
-void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan)
+/* Apply changes and update window after undo or redo action */
+void RouteController::changeRouteUndoRedo(const QList<rctype::RouteDelta>& deltas, bool undo)
 {
-  route.setFlightplan(newFlightplan);
+  if(undo)
+  {
+    for(int i = deltas.size() - 1; i >= 0; i--)
+    {
+      const rctype::RouteDelta& delta = deltas.at(i);
+      replaceRouteMapObjects(delta.firstIndex, delta.entriesAfter.size(), delta.entriesBefore,
+                             delta.headerBefore);
+    }
+  }
+  else
+  {
+    for(const rctype::RouteDelta& delta : deltas)
+      replaceRouteMapObjects(delta.firstIndex, delta.entriesBefore.size(), delta.entriesAfter,
+                             delta.headerAfter);
+  }
 
-  createRouteMapObjects();
+  updateRouteMapObjects();
   updateTableModel();
   mainWindow->updateWindowTitle();
   updateWindowLabel();
@@ -1159,9 +1127,6 @@ void RouteController::moveSelectedLegsInternal(MoveDirection direction)
       // Change flight plan
       route.getFlightplan().getEntries().move(row, row + direction);
       route.move(row, row + direction);
-
-      // Move row
-      model->insertRow(row + direction, model->takeRow(row));
     }
 
     int firstRow = rows.first();
@@ -1247,7 +1212,6 @@ void RouteController::deleteSelectedLegs()
       eraseAirway(row);
 
       route.removeAt(row);
-      model->removeRow(row);
     }
     updateRouteMapObjects();
 
@@ -1710,6 +1674,7 @@ void RouteController::updateRouteMapObjects()
     last = &mapobj;
   }
   route.setTotalDistance(totalDistance);
+  route.updateGeometryIndex();
 
   // Next number for user point name
   curUserpointNumber++;
@@ -1730,11 +1695,14 @@ void RouteController::createRouteMapObjects()
   // Used to number user waypoints
   curUserpointNumber = 0;
 
+  maptypes::MapIdentSearchResult prefetched;
+  prefetchRouteMapObjects(flightplan.getEntries(), prefetched);
+
   // Create map objects first and calculate total distance
   for(int i = 0; i < flightplan.getEntries().size(); i++)
   {
     RouteMapObject mapobj(&flightplan);
-    mapobj.createFromDatabaseByEntry(i, query, last);
+    mapobj.createFromDatabaseByEntry(i, query, last, &prefetched);
     curUserpointNumber = std::max(curUserpointNumber, mapobj.getUserpointNumber());
 
     if(mapobj.getMapObjectType() == maptypes::INVALID)
@@ -1749,6 +1717,7 @@ void RouteController::createRouteMapObjects()
   }
 
   route.setTotalDistance(totalDistance);
+  route.updateGeometryIndex();
 
   // Next number for user point name
   curUserpointNumber++;
@@ -1756,6 +1725,78 @@ void RouteController::createRouteMapObjects()
   updateBoundingRect();
 }
 
+void RouteController::replaceRouteMapObjects(int firstIndex, int numRemove,
+                                             const QList<FlightplanEntry>& entries, const Flightplan& header)
+{
+  Flightplan& flightplan = route.getFlightplan();
+
+  // Set header and keep the entries
+  QList<FlightplanEntry> planEntries = flightplan.getEntries();
+  flightplan = header;
+  flightplan.getEntries() = planEntries;
+  planEntries.clear();
+
+  for(int i = 0; i < numRemove; i++)
+  {
+    flightplan.getEntries().removeAt(firstIndex);
+    route.removeAt(firstIndex);
+  }
+
+  for(int i = 0; i < entries.size(); i++)
+    flightplan.getEntries().insert(firstIndex + i, entries.at(i));
+
+  // Load only the new entries from the database
+  maptypes::MapIdentSearchResult prefetched;
+  prefetchRouteMapObjects(entries, prefetched);
+
+  for(int i = 0; i < entries.size(); i++)
+  {
+    int index = firstIndex + i;
+    RouteMapObject mapobj(&flightplan);
+    mapobj.createFromDatabaseByEntry(index, query, index > 0 ? &route.at(index - 1) : nullptr,
+                                     &prefetched);
+
+    if(mapobj.getMapObjectType() == maptypes::INVALID)
+      qWarning() << "Entry for ident" << flightplan.at(index).getIcaoIdent()
+                 << "region" << flightplan.at(index).getIcaoRegion() << "is not valid";
+
+    route.insert(index, mapobj);
+  }
+}
+
+void RouteController::prefetchRouteMapObjects(const QList<FlightplanEntry>& entries,
+                                              maptypes::MapIdentSearchResult& prefetched)
+{
+  // Collect idents for all entries and resolve them with a few batch queries
+  QSet<QString> airportIdents, vorIdents, ndbIdents, waypointIdents;
+  for(const FlightplanEntry& entry : entries)
+  {
+    switch(entry.getWaypointType())
+    {
+      case atools::fs::pln::entry::AIRPORT:
+        airportIdents.insert(entry.getIcaoIdent());
+        break;
+      case atools::fs::pln::entry::VOR:
+        vorIdents.insert(entry.getIcaoIdent());
+        break;
+      case atools::fs::pln::entry::NDB:
+        ndbIdents.insert(entry.getIcaoIdent());
+        break;
+      case atools::fs::pln::entry::INTERSECTION:
+        waypointIdents.insert(entry.getIcaoIdent());
+        break;
+      case atools::fs::pln::entry::UNKNOWN:
+      case atools::fs::pln::entry::USER:
+        break;
+    }
+  }
+
+  query->getMapObjectsByIdents(prefetched, maptypes::AIRPORT, airportIdents);
+  query->getMapObjectsByIdents(prefetched, maptypes::VOR, vorIdents);
+  query->getMapObjectsByIdents(prefetched, maptypes::NDB, ndbIdents);
+  query->getMapObjectsByIdents(prefetched, maptypes::WAYPOINT, waypointIdents);
+}
+
 /* Update the bounding rect using marble functions to catch anti meridian overlap */
 void RouteController::updateBoundingRect()
 {
@@ -1773,134 +1814,15 @@ void RouteController::updateBoundingRect()
 /* Update travel times in table view model after speed change */
 void RouteController::updateModelRouteTime()
 {
-  Ui::MainWindow *ui = mainWindow->getUi();
-  int row = 0;
-  float cumulatedDistance = 0.f;
-  for(const RouteMapObject& mapobj : route)
-  {
-    cumulatedDistance += mapobj.getDistanceTo();
-    if(row == 0)
-      model->setItem(row, rc::LEG_TIME, nullptr);
-    else
-    {
-      float travelTime = mapobj.getDistanceTo() / static_cast<float>(ui->spinBoxRouteSpeed->value());
-      model->setItem(row, rc::LEG_TIME, new QStandardItem(formatter::formatMinutesHours(travelTime)));
-    }
-
-    float eta = cumulatedDistance / static_cast<float>(ui->spinBoxRouteSpeed->value());
-    model->setItem(row, rc::ETA, new QStandardItem(formatter::formatMinutesHours(eta)));
-    row++;
-  }
+  model->setSpeed(mainWindow->getUi()->spinBoxRouteSpeed->value());
 }
 
-/* Update table view model completely */
+/* Synchronize table view model with the route. Emits signals only for changed rows. */
 void RouteController::updateTableModel()
 {
   Ui::MainWindow *ui = mainWindow->getUi();
 
-  model->removeRows(0, model->rowCount());
-  float totalDistance = route.getTotalDistance();
-
-  int row = 0;
-  float cumulatedDistance = 0.f;
-
-  QList<QStandardItem *> itemRow;
-  for(const RouteMapObject& mapobj : route)
-  {
-    itemRow.clear();
-    itemRow.append(new QStandardItem(mapobj.getIdent()));
-    itemRow.append(new QStandardItem(mapobj.getRegion()));
-    itemRow.append(new QStandardItem(mapobj.getName()));
-    itemRow.append(new QStandardItem(mapobj.getAirway()));
-
-    // VOR/NDB type
-    if(mapobj.getMapObjectType() == maptypes::VOR)
-    {
-      QString type = mapobj.getVor().type.at(0);
-
-      if(mapobj.getVor().dmeOnly)
-        itemRow.append(new QStandardItem(tr("DME (%1)").arg(type)));
-      else if(mapobj.getVor().hasDme)
-        itemRow.append(new QStandardItem(tr("VORDME (%1)").arg(type)));
-      else
-        itemRow.append(new QStandardItem(tr("VOR (%1)").arg(type)));
-    }
-    else if(mapobj.getMapObjectType() == maptypes::NDB)
-    {
-      QString type = mapobj.getNdb().type == "COMPASS_POINT" ? tr("CP") : mapobj.getNdb().type;
-      itemRow.append(new QStandardItem(tr("NDB (%1)").arg(type)));
-    }
-    else
-      itemRow.append(nullptr);
-
-    // VOR/NDB frequency
-    QStandardItem *item;
-    if(mapobj.getFrequency() > 0)
-    {
-      if(mapobj.getMapObjectType() == maptypes::VOR)
-        item = new QStandardItem(QLocale().toString(mapobj.getFrequency() / 1000.f, 'f', 2));
-      else if(mapobj.getMapObjectType() == maptypes::NDB)
-        item = new QStandardItem(QLocale().toString(mapobj.getFrequency() / 100.f, 'f', 1));
-      else
-        item = new QStandardItem();
-      item->setTextAlignment(Qt::AlignRight);
-      itemRow.append(item);
-    }
-    else
-      itemRow.append(nullptr);
-
-    if(mapobj.getRange() > 0)
-    {
-      if(mapobj.getMapObjectType() == maptypes::VOR || mapobj.getMapObjectType() == maptypes::NDB)
-        item = new QStandardItem(QLocale().toString(mapobj.getRange()));
-      else
-        item = new QStandardItem();
-      item->setTextAlignment(Qt::AlignRight);
-      itemRow.append(item);
-    }
-    else
-      itemRow.append(nullptr);
-
-    if(row == 0)
-    {
-      // No course and distance for departure airport
-      itemRow.append(nullptr);
-      itemRow.append(nullptr);
-      itemRow.append(nullptr);
-    }
-    else
-    {
-      item = new QStandardItem(QLocale().toString(mapobj.getCourseTo(), 'f', 0));
-      item->setTextAlignment(Qt::AlignRight);
-      itemRow.append(item);
-
-      item = new QStandardItem(QLocale().toString(mapobj.getCourseToRhumb(), 'f', 0));
-      item->setTextAlignment(Qt::AlignRight);
-      itemRow.append(item);
-
-      item = new QStandardItem(QLocale().toString(mapobj.getDistanceTo(), 'f', 1));
-      item->setTextAlignment(Qt::AlignRight);
-      itemRow.append(item);
-    }
-
-    cumulatedDistance += mapobj.getDistanceTo();
-
-    float remaining = totalDistance - cumulatedDistance;
-    if(remaining < 0.f)
-      remaining = 0.f;  // Catch the -0 case due to rounding errors
-    item = new QStandardItem(QLocale().toString(remaining, 'f', 1));
-    item->setTextAlignment(Qt::AlignRight);
-    itemRow.append(item);
-
-    // Travel time and ETA are updated in updateModelRouteTime
-    itemRow.append(nullptr);
-    itemRow.append(nullptr);
-
-    model->appendRow(itemRow);
-    row++;
-  }
-
-  updateModelRouteTime();
+  model->updateModel(ui->spinBoxRouteSpeed->value());
 
   Flightplan& flightplan = route.getFlightplan();
 
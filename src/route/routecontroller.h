@@ -39,7 +39,7 @@ class FlightplanEntry;
 
 class MainWindow;
 class QTableView;
-class QStandardItemModel;
+class RouteTableModel;
 class QItemSelection;
 class RouteIconDelegate;
 class RouteNetwork;
@@ -224,11 +224,11 @@ private:
     MOVE_UP = -1
   };
 
-  /* Called by route command */
-  void changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan);
+  /* Called by route command. Reverts all changes in reverse order. */
+  void changeRouteUndo(const QList<rctype::RouteDelta>& deltas);
 
-  /* Called by route command */
-  void changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  /* Called by route command. Applies all changes in order. */
+  void changeRouteRedo(const QList<rctype::RouteDelta>& deltas);
 
   /* Called by route command */
   void undoMerge();
@@ -263,6 +263,16 @@ private:
 
   void createRouteMapObjects();
   void updateRouteMapObjects();
+
+  /* Fetch airports and navaids for all entries with a few queries */
+  void prefetchRouteMapObjects(const QList<atools::fs::pln::FlightplanEntry>& entries,
+                               maptypes::MapIdentSearchResult& prefetched);
+
+  /* Replace numRemove entries and route map objects at firstIndex with the given entries and
+   * set the flight plan header. Only the new entries are loaded from the database. */
+  void replaceRouteMapObjects(int firstIndex, int numRemove,
+                              const QList<atools::fs::pln::FlightplanEntry>& entries,
+                              const atools::fs::pln::Flightplan& header);
   void updateBoundingRect();
 
   void routeAltChanged();
@@ -281,7 +291,7 @@ private:
   void updateFlightplanFromWidgets();
 
   /* Used by undo/redo */
-  void changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  void changeRouteUndoRedo(const QList<rctype::RouteDelta>& deltas, bool undo);
 
   void tableCopyClipboard();
 
@@ -321,7 +331,7 @@ private:
   MainWindow *mainWindow;
   QTableView *view;
   MapQuery *query;
-  QStandardItemModel *model;
+  RouteTableModel *model;
   RouteIconDelegate *iconDelegate = nullptr;
   QUndoStack *undoStack = nullptr;
   FlightplanEntryBuilder *entryBuilder = nullptr;
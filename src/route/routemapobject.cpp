@@ -72,6 +72,38 @@ TYPE findMapObject(const QList<TYPE>& waypoints, const atools::geo::Pos& pos, bo
   return TYPE();
 }
 
+/* Get all objects for ident matching the region or all regions if region is empty */
+template<typename TYPE>
+void filterByRegion(const QHash<QString, QList<TYPE> >& objects, const QString& ident, const QString& region,
+                    QList<TYPE>& result)
+{
+  for(const TYPE& obj : objects.value(ident))
+  {
+    if(region.isEmpty() || obj.region.compare(region, Qt::CaseInsensitive) == 0)
+      result.append(obj);
+  }
+}
+
+/* Get objects by ident and region from the prefetched objects or the database */
+static void getMapObjectByIdent(MapQuery *query, const maptypes::MapIdentSearchResult *prefetched,
+                                maptypes::MapSearchResult& result, maptypes::MapObjectTypes type,
+                                const QString& ident, const QString& region)
+{
+  if(prefetched != nullptr)
+  {
+    if(type & maptypes::AIRPORT)
+      result.airports.append(prefetched->airports.value(ident));
+    if(type & maptypes::VOR)
+      filterByRegion(prefetched->vors, ident, region, result.vors);
+    if(type & maptypes::NDB)
+      filterByRegion(prefetched->ndbs, ident, region, result.ndbs);
+    if(type & maptypes::WAYPOINT)
+      filterByRegion(prefetched->waypoints, ident, region, result.waypoints);
+  }
+  else
+    query->getMapObjectByIdent(result, type, ident, region);
+}
+
 void RouteMapObject::createFromAirport(int entryIndex,
                                        const maptypes::MapAirport& newAirport,
                                        const RouteMapObject *predRouteMapObj)
@@ -86,7 +118,8 @@ void RouteMapObject::createFromAirport(int entryIndex,
 }
 
 void RouteMapObject::createFromDatabaseByEntry(int entryIndex, MapQuery *query,
-                                               const RouteMapObject *predRouteMapObj)
+                                               const RouteMapObject *predRouteMapObj,
+                                               const maptypes::MapIdentSearchResult *prefetched)
 {
   flightplanEntryIndex = entryIndex;
 
@@ -106,7 +139,8 @@ void RouteMapObject::createFromDatabaseByEntry(int entryIndex, MapQuery *query,
     case atools::fs::pln::entry::UNKNOWN:
       break;
     case atools::fs::pln::entry::AIRPORT:
-      query->getMapObjectByIdent(mapobjectResult, maptypes::AIRPORT, flightplanEntry->getIcaoIdent());
+      getMapObjectByIdent(query, prefetched, mapobjectResult, maptypes::AIRPORT,
+                          flightplanEntry->getIcaoIdent());
       if(!mapobjectResult.airports.isEmpty())
       {
         type = maptypes::AIRPORT;
@@ -180,8 +214,8 @@ void RouteMapObject::createFromDatabaseByEntry(int entryIndex, MapQuery *query,
     case atools::fs::pln::entry::INTERSECTION:
       {
         // Navaid waypoint
-        query->getMapObjectByIdent(mapobjectResult, maptypes::WAYPOINT,
-                                   flightplanEntry->getIcaoIdent(), region);
+        getMapObjectByIdent(query, prefetched, mapobjectResult, maptypes::WAYPOINT,
+                            flightplanEntry->getIcaoIdent(), region);
         const maptypes::MapWaypoint& obj = findMapObject(mapobjectResult.waypoints,
                                                          flightplanEntry->getPosition(), found);
         if(found)
@@ -202,7 +236,8 @@ void RouteMapObject::createFromDatabaseByEntry(int entryIndex, MapQuery *query,
       }
     case atools::fs::pln::entry::VOR:
       {
-        query->getMapObjectByIdent(mapobjectResult, maptypes::VOR, flightplanEntry->getIcaoIdent(), region);
+        getMapObjectByIdent(query, prefetched, mapobjectResult, maptypes::VOR,
+                            flightplanEntry->getIcaoIdent(), region);
         const maptypes::MapVor& obj = findMapObject(mapobjectResult.vors,
                                                     flightplanEntry->getPosition(), found);
         if(found)
@@ -222,7 +257,8 @@ void RouteMapObject::createFromDatabaseByEntry(int entryIndex, MapQuery *query,
       }
     case atools::fs::pln::entry::NDB:
       {
-        query->getMapObjectByIdent(mapobjectResult, maptypes::NDB, flightplanEntry->getIcaoIdent(), region);
+        getMapObjectByIdent(query, prefetched, mapobjectResult, maptypes::NDB,
+                            flightplanEntry->getIcaoIdent(), region);
         const maptypes::MapNdb& obj = findMapObject(mapobjectResult.ndbs,
                                                     flightplanEntry->getPosition(), found);
         if(found)
@@ -271,6 +307,7 @@ void RouteMapObject::setDepartureStart(const maptypes::MapStart& departureStart)
 void RouteMapObject::updateDistanceAndCourse(int entryIndex, const RouteMapObject *predRouteMapObj)
 {
   flightplanEntryIndex = entryIndex;
+  predecessor = predRouteMapObj != nullptr;
   if(predRouteMapObj != nullptr)
   {
     const Pos& prevPos = predRouteMapObj->getPosition();
@@ -288,7 +325,6 @@ void RouteMapObject::updateDistanceAndCourse(int entryIndex, const RouteMapObjec
   else
   {
     // No predecessor - this one is the first in the list
-    predecessor = false;
     distanceTo = 0.f;
     distanceToRhumb = 0.f;
     courseTo = 0.f;
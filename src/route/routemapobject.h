@@ -53,9 +53,12 @@ public:
    * @param planEntry Flight plan entry used to query database objects. Valid data is written back to the entry.
    * @param query Database query object
    * @param predRouteMapObj Predecessor of this entry or null if this is the first waypoint in the list
+   * @param prefetched Objects fetched by MapQuery::getMapObjectsByIdents for the whole flight plan.
+   * Used instead of single queries if not null.
    */
   void createFromDatabaseByEntry(int entryIndex, MapQuery *query,
-                                 const RouteMapObject *predRouteMapObj);
+                                 const RouteMapObject *predRouteMapObj,
+                                 const maptypes::MapIdentSearchResult *prefetched = nullptr);
 
   /*
    * Creates a route map object from an airport database object.
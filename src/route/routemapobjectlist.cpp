@@ -20,8 +20,23 @@
 #include "geo/calculations.h"
 #include "common/maptools.h"
 
+#include <cmath>
+
 const float RouteMapObjectList::INVALID_DISTANCE_VALUE = std::numeric_limits<float>::max();
 
+/* Mean earth radius used to convert angular distances on the unit sphere */
+static const double SPHERE_RADIUS_METER = 6371. * 1000.;
+
+static inline double clampUnit(double value)
+{
+  return std::max(-1., std::min(1., value));
+}
+
+static inline double radToNm(double rad)
+{
+  return atools::geo::meterToNm(static_cast<float>(rad * SPHERE_RADIUS_METER));
+}
+
 RouteMapObjectList::RouteMapObjectList()
 {
 
@@ -51,6 +66,8 @@ void RouteMapObjectList::copy(const RouteMapObjectList& other)
 {
   totalDistance = other.totalDistance;
   flightplan = other.flightplan;
+  geometry = other.geometry;
+  legIndexHint = other.legIndexHint;
 
   // Update flightplan pointers to this instance
   for(RouteMapObject& rmo : *this)
@@ -125,11 +142,22 @@ bool RouteMapObjectList::getRouteDistances(const atools::geo::Pos& pos,
                                            float *nextLegDistance, float *crossTrackDistance,
                                            int *nextLegIndex) const
 {
-  float crossDist;
-  int legIndex = getNearestLegIndex(pos, crossDist);
+  bool indexed = hasGeometryIndex();
+
+  float crossDist, pointDistance;
+  int legIndex, pointIndex;
+  if(indexed)
+  {
+    getNearestIndexed(pos, legIndex, crossDist, pointIndex, pointDistance);
+    if(legIndex != -1)
+      legIndexHint = legIndex;
+  }
+  else
+  {
+    legIndex = getNearestLegIndex(pos, crossDist);
+    pointIndex = getNearestPointIndex(pos, pointDistance);
+  }
 
-  float pointDistance;
-  int pointIndex = getNearestPointIndex(pos, pointDistance);
   if(pointDistance < std::abs(crossDist))
   {
     legIndex = pointIndex;
@@ -155,18 +183,28 @@ bool RouteMapObjectList::getRouteDistances(const atools::geo::Pos& pos,
 
     if(distFromStart != nullptr)
     {
-      *distFromStart = 0.f;
-      for(int i = 0; i <= legIndex; i++)
-        *distFromStart += at(i).getDistanceTo();
+      if(indexed)
+        *distFromStart = geometry.at(legIndex).distanceFromStart;
+      else
+      {
+        *distFromStart = 0.f;
+        for(int i = 0; i <= legIndex; i++)
+          *distFromStart += at(i).getDistanceTo();
+      }
       *distFromStart -= distToCur;
       *distFromStart = std::abs(*distFromStart);
     }
 
     if(distToDest != nullptr)
     {
-      *distToDest = 0.f;
-      for(int i = legIndex + 1; i < size(); i++)
-        *distToDest += at(i).getDistanceTo();
+      if(indexed)
+        *distToDest = geometry.last().distanceFromStart - geometry.at(legIndex).distanceFromStart;
+      else
+      {
+        *distToDest = 0.f;
+        for(int i = legIndex + 1; i < size(); i++)
+          *distToDest += at(i).getDistanceTo();
+      }
       *distToDest += distToCur;
       *distToDest = std::abs(*distToDest);
     }
@@ -176,6 +214,184 @@ bool RouteMapObjectList::getRouteDistances(const atools::geo::Pos& pos,
   return false;
 }
 
+void RouteMapObjectList::updateGeometryIndex()
+{
+  geometry.clear();
+  geometry.reserve(size());
+  legIndexHint = -1;
+
+  float distance = 0.f;
+  for(int i = 0; i < size(); i++)
+  {
+    LegGeometry geo;
+    geo.point = toVector(at(i).getPosition());
+
+    distance += at(i).getDistanceTo();
+    geo.distanceFromStart = distance;
+
+    if(i > 0)
+    {
+      const Vector3& from = geometry.at(i - 1).point;
+      Vector3 sum;
+      sum.x = from.x + geo.point.x;
+      sum.y = from.y + geo.point.y;
+      sum.z = from.z + geo.point.z;
+
+      geo.normal = normalized(cross(from, geo.point));
+      geo.center = normalized(sum);
+      geo.radius = std::acos(clampUnit(dot(from, geo.point))) / 2.;
+    }
+    else
+      geo.center = geo.point;
+
+    geometry.append(geo);
+  }
+
+  // Find the minimum distance between the cap of each leg and the caps of all non adjacent legs
+  for(int i = 1; i < geometry.size(); i++)
+    geometry[i].clearance = M_PI;
+
+  for(int i = 1; i < geometry.size(); i++)
+  {
+    LegGeometry& geo = geometry[i];
+    for(int j = i + 2; j < geometry.size(); j++)
+    {
+      LegGeometry& other = geometry[j];
+      double separation = std::acos(clampUnit(dot(geo.center, other.center))) - geo.radius - other.radius;
+
+      // Half of the separation since the position can be off the leg by the same amount
+      double clearance = std::max(0., separation / 2.);
+      geo.clearance = std::min(geo.clearance, clearance);
+      other.clearance = std::min(other.clearance, clearance);
+    }
+  }
+}
+
+void RouteMapObjectList::getNearestIndexed(const atools::geo::Pos& pos, int& legIndex,
+                                           float& crossTrackDistanceNm, int& pointIndex,
+                                           float& pointDistanceNm) const
+{
+  Vector3 vec = toVector(pos);
+
+  int nearestLeg = -1, nearestPoint = -1;
+  double crossTrack = 0., maxDot = -2.;
+  bool found = false;
+
+  if(legIndexHint > 0 && legIndexHint < size())
+  {
+    // Check legs around the last found leg first
+    int first = std::max(1, legIndexHint - 2), last = std::min(size() - 1, legIndexHint + 2);
+    for(int leg = first; leg <= last; leg++)
+      checkLeg(vec, leg, nearestLeg, crossTrack);
+
+    // Other legs cannot be nearer if both adjacent legs were checked and the position is within the clearance
+    if(nearestLeg != -1 &&
+       (nearestLeg > first || first == 1) && (nearestLeg < last || last == size() - 1) &&
+       std::abs(crossTrack) <= geometry.at(nearestLeg).clearance)
+    {
+      // Points of all other legs are also outside of the clearance
+      int lastPoint = std::min(size() - 1, nearestLeg + 1);
+      for(int i = std::max(0, nearestLeg - 2); i <= lastPoint; i++)
+        checkPoint(vec, i, nearestPoint, maxDot);
+      found = true;
+    }
+  }
+
+  if(!found)
+  {
+    nearestLeg = -1;
+    for(int leg = 1; leg < size(); leg++)
+    {
+      const LegGeometry& geo = geometry.at(leg);
+
+      // Skip legs where the enclosing cap is farther away than the nearest leg
+      if(nearestLeg != -1 &&
+         std::acos(clampUnit(dot(geo.center, vec))) - geo.radius > std::abs(crossTrack))
+        continue;
+
+      checkLeg(vec, leg, nearestLeg, crossTrack);
+    }
+
+    nearestPoint = -1;
+    maxDot = -2.;
+    for(int i = 0; i < size(); i++)
+      checkPoint(vec, i, nearestPoint, maxDot);
+  }
+
+  legIndex = nearestLeg;
+  crossTrackDistanceNm = nearestLeg != -1 ? static_cast<float>(radToNm(crossTrack)) : INVALID_DISTANCE_VALUE;
+
+  // Same point index as getNearestPointIndex
+  pointIndex = nearestPoint != -1 ? nearestPoint + 1 : -1;
+  pointDistanceNm = nearestPoint != -1 ?
+                    static_cast<float>(radToNm(std::acos(clampUnit(maxDot)))) : INVALID_DISTANCE_VALUE;
+}
+
+void RouteMapObjectList::checkLeg(const Vector3& vec, int leg, int& nearestLeg, double& crossTrack) const
+{
+  const LegGeometry& geo = geometry.at(leg);
+  if(geo.normal.x == 0. && geo.normal.y == 0. && geo.normal.z == 0.)
+    // Zero length leg
+    return;
+
+  // Position has to be between the two great circles perpendicular to the leg through the points
+  const Vector3& from = geometry.at(leg - 1).point;
+  if(dot(cross(from, vec), geo.normal) < 0. || dot(cross(vec, geo.point), geo.normal) < 0.)
+    return;
+
+  // Positive values are right of the leg
+  double distance = -std::asin(clampUnit(dot(geo.normal, vec)));
+  if(nearestLeg == -1 || std::abs(distance) < std::abs(crossTrack))
+  {
+    nearestLeg = leg;
+    crossTrack = distance;
+  }
+}
+
+void RouteMapObjectList::checkPoint(const Vector3& vec, int index, int& nearestPoint, double& maxDot) const
+{
+  double value = dot(geometry.at(index).point, vec);
+  if(value > maxDot)
+  {
+    maxDot = value;
+    nearestPoint = index;
+  }
+}
+
+RouteMapObjectList::Vector3 RouteMapObjectList::toVector(const atools::geo::Pos& pos)
+{
+  double lonX = atools::geo::toRadians(static_cast<double>(pos.getLonX()));
+  double latY = atools::geo::toRadians(static_cast<double>(pos.getLatY()));
+
+  Vector3 vec;
+  vec.x = std::cos(latY) * std::cos(lonX);
+  vec.y = std::cos(latY) * std::sin(lonX);
+  vec.z = std::sin(latY);
+  return vec;
+}
+
+RouteMapObjectList::Vector3 RouteMapObjectList::cross(const Vector3& a, const Vector3& b)
+{
+  Vector3 vec;
+  vec.x = a.y * b.z - a.z * b.y;
+  vec.y = a.z * b.x - a.x * b.z;
+  vec.z = a.x * b.y - a.y * b.x;
+  return vec;
+}
+
+RouteMapObjectList::Vector3 RouteMapObjectList::normalized(const Vector3& vec)
+{
+  double length = std::sqrt(dot(vec, vec));
+  if(length < 1.e-12)
+    return Vector3();
+
+  Vector3 norm;
+  norm.x = vec.x / length;
+  norm.y = vec.y / length;
+  norm.z = vec.z / length;
+  return norm;
+}
+
 void RouteMapObjectList::getNearest(const CoordinateConverter& conv, int xs, int ys, int screenDistance,
                                     maptypes::MapSearchResult& mapobjects) const
 {
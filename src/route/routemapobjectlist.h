@@ -58,11 +58,18 @@ public:
    * negative values indicate left or right of track.
    * @param nextLegIndex Index of next leg
    * @return false if no current/next leg was found
+   *
+   * Uses the geometry index if it is up to date. The search starts at the leg found by the last call
+   * which makes consecutive calls for a moving aircraft cheap.
    */
   bool getRouteDistances(const atools::geo::Pos& pos, float *distFromStart, float *distToDest,
                          float *nextLegDistance = nullptr, float *crossTrackDistance = nullptr,
                          int *nextLegIndex = nullptr) const;
 
+  /* Rebuild the distance prefix sums and leg geometry used by getRouteDistances.
+   * Has to be called after route map objects were added, removed or changed. */
+  void updateGeometryIndex();
+
   /* Total route distance in nautical miles */
   float getTotalDistance() const
   {
@@ -123,9 +130,65 @@ public:
   void copy(const RouteMapObjectList& other);
 
 private:
+  /* Cartesian vector for positions on the unit sphere */
+  struct Vector3
+  {
+    double x = 0., y = 0., z = 0.;
+  };
+
+  /* Precalculated geometry for a route point and the leg ending at it */
+  struct LegGeometry
+  {
+    /* Unit vector of the route point */
+    Vector3 point;
+
+    /* Normal of the great circle from the previous point to this one. Null for first or zero length legs. */
+    Vector3 normal;
+
+    /* Center and angular radius in radians of the spherical cap enclosing the leg */
+    Vector3 center;
+    double radius = 0.;
+
+    /* Angular distance to the leg up to which no leg except the adjacent ones can be nearer */
+    double clearance = 0.;
+
+    /* Sum of all leg distances up to and including this point in nautical miles */
+    float distanceFromStart = 0.f;
+  };
+
+  /* Get nearest leg and waypoint using the geometry index. Same return values as getNearestLegIndex
+   * and getNearestPointIndex. */
+  void getNearestIndexed(const atools::geo::Pos& pos, int& legIndex, float& crossTrackDistanceNm,
+                         int& pointIndex, float& pointDistanceNm) const;
+
+  /* Check leg and update nearest leg if closer. Cross track distance is an angle in radians. */
+  void checkLeg(const Vector3& vec, int leg, int& nearestLeg, double& crossTrack) const;
+
+  /* Check point and update nearest point if closer. Uses dot product for comparison. */
+  void checkPoint(const Vector3& vec, int index, int& nearestPoint, double& maxDot) const;
+
+  static Vector3 toVector(const atools::geo::Pos& pos);
+  static Vector3 cross(const Vector3& a, const Vector3& b);
+  static Vector3 normalized(const Vector3& vec);
+
+  static double dot(const Vector3& a, const Vector3& b)
+  {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+  }
+
+  bool hasGeometryIndex() const
+  {
+    return !geometry.isEmpty() && geometry.size() == size();
+  }
+
   float totalDistance = 0.f;
   atools::fs::pln::Flightplan flightplan;
 
+  QVector<LegGeometry> geometry;
+
+  /* Leg found by the last call to getRouteDistances */
+  mutable int legIndexHint = -1;
+
 };
 
 #endif // LITTLENAVMAP_ROUTEMAPOBJECTLIST_H
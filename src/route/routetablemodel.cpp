@@ -0,0 +1,270 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routetablemodel.h"
+
+#include "route/routemapobjectlist.h"
+#include "common/formatter.h"
+
+// Route table colum headings
+const QList<QString> ROUTE_COLUMNS({QObject::tr("Ident"),
+                                    QObject::tr("Region"),
+                                    QObject::tr("Name"),
+                                    QObject::tr("Airway"),
+                                    QObject::tr("Type"),
+                                    QObject::tr("Freq.\nMHz/kHz"),
+                                    QObject::tr("Range\nnm"),
+                                    QObject::tr("Course\n°M"),
+                                    QObject::tr("Direct\n°M"),
+                                    QObject::tr("Distance\nnm"),
+                                    QObject::tr("Remaining\nnm"),
+                                    QObject::tr("Leg Time\nhh:mm"),
+                                    QObject::tr("ETA\nhh:mm UTC")});
+
+RouteTableModel::RouteTableModel(const RouteMapObjectList& routeMapObjects, QObject *parent)
+  : QAbstractTableModel(parent), route(routeMapObjects)
+{
+
+}
+
+RouteTableModel::~RouteTableModel()
+{
+
+}
+
+int RouteTableModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : rows.size();
+}
+
+int RouteTableModel::columnCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : ROUTE_COLUMNS.size();
+}
+
+QVariant RouteTableModel::data(const QModelIndex& index, int role) const
+{
+  if(!index.isValid() || index.row() >= rows.size())
+    return QVariant();
+
+  if(role == Qt::DisplayRole)
+  {
+    const QString& text = rows.at(index.row()).texts.at(index.column());
+    return text.isEmpty() ? QVariant() : text;
+  }
+  else if(role == Qt::TextAlignmentRole)
+  {
+    switch(index.column())
+    {
+      case rc::FREQ:
+      case rc::RANGE:
+      case rc::COURSE:
+      case rc::DIRECT:
+      case rc::DIST:
+      case rc::REMAINING_DISTANCE:
+        return Qt::AlignRight;
+    }
+  }
+  return QVariant();
+}
+
+QVariant RouteTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if(role == Qt::DisplayRole && orientation == Qt::Horizontal && section < ROUTE_COLUMNS.size())
+    return ROUTE_COLUMNS.at(section);
+
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void RouteTableModel::setSpeed(int speedKts)
+{
+  if(speed != speedKts)
+  {
+    speed = speedKts;
+    updateTexts();
+  }
+}
+
+void RouteTableModel::updateModel(int speedKts)
+{
+  speed = speedKts;
+
+  int oldSize = rows.size(), newSize = route.size();
+  int minSize = std::min(oldSize, newSize);
+
+  // Find rows that are unchanged at the start and at the end
+  int prefix = 0;
+  while(prefix < minSize && isSameObject(rows.at(prefix), route.at(prefix)))
+    prefix++;
+
+  int suffix = 0;
+  while(suffix < minSize - prefix &&
+        isSameObject(rows.at(oldSize - 1 - suffix), route.at(newSize - 1 - suffix)))
+    suffix++;
+
+  // Remove rows that were changed or deleted
+  int numRemove = oldSize - prefix - suffix;
+  if(numRemove > 0)
+  {
+    beginRemoveRows(QModelIndex(), prefix, prefix + numRemove - 1);
+    rows.remove(prefix, numRemove);
+    endRemoveRows();
+  }
+
+  // Insert new rows
+  int numInsert = newSize - prefix - suffix;
+  if(numInsert > 0)
+  {
+    beginInsertRows(QModelIndex(), prefix, prefix + numInsert - 1);
+    rows.insert(prefix, numInsert, Row());
+    for(int i = prefix; i < prefix + numInsert; i++)
+      rows[i] = createRow(route.at(i));
+    endInsertRows();
+  }
+
+  // Distances, courses and times can change for all rows
+  updateTexts();
+}
+
+void RouteTableModel::updateTexts()
+{
+  float cumulatedDistance = 0.f;
+  int firstChanged = -1;
+
+  for(int row = 0; row < rows.size(); row++)
+  {
+    cumulatedDistance += route.at(row).getDistanceTo();
+
+    QStringList texts = rowTexts(row, cumulatedDistance);
+    if(texts != rows.at(row).texts)
+    {
+      rows[row].texts = texts;
+      if(firstChanged == -1)
+        firstChanged = row;
+    }
+    else if(firstChanged != -1)
+    {
+      emit dataChanged(index(firstChanged, rc::FIRST_COLUMN), index(row - 1, rc::LAST_COLUMN));
+      firstChanged = -1;
+    }
+  }
+
+  if(firstChanged != -1)
+    emit dataChanged(index(firstChanged, rc::FIRST_COLUMN), index(rows.size() - 1, rc::LAST_COLUMN));
+}
+
+RouteTableModel::Row RouteTableModel::createRow(const RouteMapObject& mapobj) const
+{
+  Row row;
+  row.type = mapobj.getMapObjectType();
+  row.ident = mapobj.getIdent();
+  row.position = mapobj.getPosition();
+
+  // Texts are filled by updateTexts
+  for(int i = 0; i < ROUTE_COLUMNS.size(); i++)
+    row.texts.append(QString());
+  return row;
+}
+
+bool RouteTableModel::isSameObject(const Row& row, const RouteMapObject& mapobj) const
+{
+  return row.type == mapobj.getMapObjectType() && row.ident == mapobj.getIdent() &&
+         row.position == mapobj.getPosition();
+}
+
+QStringList RouteTableModel::rowTexts(int row, float cumulatedDistance) const
+{
+  const RouteMapObject& mapobj = route.at(row);
+  QLocale locale;
+
+  QStringList texts;
+  texts.append(mapobj.getIdent());
+  texts.append(mapobj.getRegion());
+  texts.append(mapobj.getName());
+  texts.append(mapobj.getAirway());
+
+  // VOR/NDB type
+  if(mapobj.getMapObjectType() == maptypes::VOR)
+  {
+    QString type = mapobj.getVor().type.at(0);
+
+    if(mapobj.getVor().dmeOnly)
+      texts.append(tr("DME (%1)").arg(type));
+    else if(mapobj.getVor().hasDme)
+      texts.append(tr("VORDME (%1)").arg(type));
+    else
+      texts.append(tr("VOR (%1)").arg(type));
+  }
+  else if(mapobj.getMapObjectType() == maptypes::NDB)
+  {
+    QString type = mapobj.getNdb().type == "COMPASS_POINT" ? tr("CP") : mapobj.getNdb().type;
+    texts.append(tr("NDB (%1)").arg(type));
+  }
+  else
+    texts.append(QString());
+
+  // VOR/NDB frequency
+  if(mapobj.getFrequency() > 0 && mapobj.getMapObjectType() == maptypes::VOR)
+    texts.append(locale.toString(mapobj.getFrequency() / 1000.f, 'f', 2));
+  else if(mapobj.getFrequency() > 0 && mapobj.getMapObjectType() == maptypes::NDB)
+    texts.append(locale.toString(mapobj.getFrequency() / 100.f, 'f', 1));
+  else
+    texts.append(QString());
+
+  if(mapobj.getRange() > 0 &&
+     (mapobj.getMapObjectType() == maptypes::VOR || mapobj.getMapObjectType() == maptypes::NDB))
+    texts.append(locale.toString(mapobj.getRange()));
+  else
+    texts.append(QString());
+
+  if(row == 0)
+  {
+    // No course and distance for departure airport
+    texts.append(QString());
+    texts.append(QString());
+    texts.append(QString());
+  }
+  else
+  {
+    texts.append(locale.toString(mapobj.getCourseTo(), 'f', 0));
+    texts.append(locale.toString(mapobj.getCourseToRhumb(), 'f', 0));
+    texts.append(locale.toString(mapobj.getDistanceTo(), 'f', 1));
+  }
+
+  float remaining = route.getTotalDistance() - cumulatedDistance;
+  if(remaining < 0.f)
+    remaining = 0.f;  // Catch the -0 case due to rounding errors
+  texts.append(locale.toString(remaining, 'f', 1));
+
+  if(speed > 0)
+  {
+    // Travel time and ETA
+    if(row == 0)
+      texts.append(QString());
+    else
+      texts.append(formatter::formatMinutesHours(mapobj.getDistanceTo() / static_cast<float>(speed)));
+
+    texts.append(formatter::formatMinutesHours(cumulatedDistance / static_cast<float>(speed)));
+  }
+  else
+  {
+    texts.append(QString());
+    texts.append(QString());
+  }
+
+  return texts;
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_ROUTETABLEMODEL_H
+#define LITTLENAVMAP_ROUTETABLEMODEL_H
+
+#include "common/maptypes.h"
+
+#include <QAbstractTableModel>
+
+class RouteMapObjectList;
+class RouteMapObject;
+
+namespace rc {
+// Route table column indexes
+enum RouteColumns
+{
+  FIRST_COLUMN,
+  IDENT = FIRST_COLUMN,
+  REGION,
+  NAME,
+  AIRWAY,
+  TYPE,
+  FREQ,
+  RANGE,
+  COURSE,
+  DIRECT,
+  DIST,
+  REMAINING_DISTANCE,
+  LEG_TIME,
+  ETA,
+  LAST_COLUMN = ETA
+};
+
+}
+
+/*
+ * Flight plan table model that reads directly from the route map object list.
+ * Formatted cell texts are cached. updateModel compares the route with the cached rows and emits
+ * row insert, remove and change signals only for the affected rows.
+ */
+class RouteTableModel :
+  public QAbstractTableModel
+{
+  Q_OBJECT
+
+public:
+  RouteTableModel(const RouteMapObjectList& routeMapObjects, QObject *parent = nullptr);
+  virtual ~RouteTableModel();
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  virtual QVariant headerData(int section, Qt::Orientation orientation,
+                              int role = Qt::DisplayRole) const override;
+
+  /* Synchronize rows with the route after any change to the route.
+   * Ground speed in knots is used for leg time and ETA. */
+  void updateModel(int speedKts);
+
+  /* Set ground speed and update the affected cells. Route must not have changed since the last update. */
+  void setSpeed(int speedKts);
+
+  /* Get cached text of a cell */
+  const QString& getText(int row, int column) const
+  {
+    return rows.at(row).texts.at(column);
+  }
+
+private:
+  /* Cached row. Object type, ident and position identify a route map object. */
+  struct Row
+  {
+    maptypes::MapObjectTypes type;
+    QString ident;
+    atools::geo::Pos position;
+    QStringList texts;
+  };
+
+  Row createRow(const RouteMapObject& mapobj) const;
+  bool isSameObject(const Row& row, const RouteMapObject& mapobj) const;
+
+  /* Format all cells of a row */
+  QStringList rowTexts(int row, float cumulatedDistance) const;
+
+  /* Update texts of all rows and emit dataChanged for each block of changed rows */
+  void updateTexts();
+
+  const RouteMapObjectList& route;
+  QVector<Row> rows;
+  int speed = 0;
+};
+
+#endif // LITTLENAVMAP_ROUTETABLEMODEL_H
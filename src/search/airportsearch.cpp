@@ -370,7 +370,7 @@ QVariant AirportSearch::modelDataHandler(int colIndex, int rowIndex, const Colum
   switch(role)
   {
     case Qt::DisplayRole:
-      return formatModelData(col, displayRoleValue);
+      return formatterForColumn(col)(displayRoleValue);
 
     case Qt::TextAlignmentRole:
       if(col->getColumnName() == "rating")
@@ -397,39 +397,49 @@ QVariant AirportSearch::modelDataHandler(int colIndex, int rowIndex, const Colum
   return QVariant();
 }
 
-/* Formats the QVariant to a QString depending on column name */
-QString AirportSearch::formatModelData(const Column *col, const QVariant& displayRoleValue) const
+/* Get a function that formats the QVariant to a QString depending on column name.
+ * Called once per column for exports. Returned functions are thread safe. */
+SqlModel::FormatFunctionType AirportSearch::formatterForColumn(const Column *col) const
 {
-  // Called directly by the model for export functions
-  if(col->getColumnName() == "tower_frequency" || col->getColumnName() == "atis_frequency" ||
-     col->getColumnName() == "awos_frequency" || col->getColumnName() == "asos_frequency" ||
-     col->getColumnName() == "unicom_frequency")
-  {
-    if(displayRoleValue.isNull())
-      return QString();
-    else
-      return QLocale().toString(displayRoleValue.toDouble() / 1000, 'f', 3);
-  }
-  else if(col->getColumnName() == "mag_var")
-    return maptypes::magvarText(displayRoleValue.toFloat());
-  else if(NUMBER_COLUMNS.contains(col->getColumnName()))
-    return displayRoleValue.toInt() > 0 ? displayRoleValue.toString() : QString();
-  else if(col->getColumnName() == "longest_runway_surface")
-    return maptypes::surfaceName(displayRoleValue.toString());
-  else if(col->getColumnName() == "largest_parking_ramp")
-    return maptypes::parkingRampName(displayRoleValue.toString());
-  else if(col->getColumnName() == "largest_parking_gate")
-    return maptypes::parkingGateName(displayRoleValue.toString());
-  else if(col->getColumnName() == "rating")
-    return atools::ratingString(displayRoleValue.toInt(), 5);
-  else if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
-    return QLocale().toString(displayRoleValue.toInt());
-  else if(displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() == QVariant::ULongLong)
-    return QLocale().toString(displayRoleValue.toLongLong());
-  else if(displayRoleValue.type() == QVariant::Double)
-    return QLocale().toString(displayRoleValue.toDouble());
-
-  return displayRoleValue.toString();
+  const QString& name = col->getColumnName();
+  if(name == "tower_frequency" || name == "atis_frequency" || name == "awos_frequency" ||
+     name == "asos_frequency" || name == "unicom_frequency")
+    return [](const QVariant& value) -> QString
+           {
+             return value.isNull() ? QString() : QLocale().toString(value.toDouble() / 1000, 'f', 3);
+           };
+  else if(name == "mag_var")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::magvarText(value.toFloat());
+           };
+  else if(NUMBER_COLUMNS.contains(name))
+    return [](const QVariant& value) -> QString
+           {
+             return value.toInt() > 0 ? value.toString() : QString();
+           };
+  else if(name == "longest_runway_surface")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::surfaceName(value.toString());
+           };
+  else if(name == "largest_parking_ramp")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::parkingRampName(value.toString());
+           };
+  else if(name == "largest_parking_gate")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::parkingGateName(value.toString());
+           };
+  else if(name == "rating")
+    return [](const QVariant& value) -> QString
+           {
+             return atools::ratingString(value.toInt(), 5);
+           };
+
+  return &SearchBase::formatDefault;
 }
 
 void AirportSearch::getSelectedMapObjects(maptypes::MapSearchResult& result) const
@@ -477,6 +487,7 @@ void AirportSearch::setCallbacks()
   using namespace std::placeholders;
   controller->setDataCallback(std::bind(&AirportSearch::modelDataHandler, this, _1, _2, _3, _4, _5, _6),
                               {Qt::DisplayRole, Qt::BackgroundRole, Qt::TextAlignmentRole});
+  controller->setColumnFormatCallback(std::bind(&AirportSearch::formatterForColumn, this, _1));
 }
 
 /* Update the button menu actions. Add * for changed search criteria and toggle show/hide all
@@ -19,6 +19,7 @@
 #define LITTLENAVMAP_AIRPORTSEARCH_H
 
 #include "search/searchbase.h"
+#include "search/sqlmodel.h"
 
 #include <QObject>
 
@@ -61,7 +62,7 @@ private:
   void setCallbacks();
   QVariant modelDataHandler(int colIndex, int rowIndex, const Column *col, const QVariant& roleValue,
                             const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
-  QString formatModelData(const Column *col, const QVariant& displayRoleValue) const;
+  SqlModel::FormatFunctionType formatterForColumn(const Column *col) const;
 
   static const QSet<QString> NUMBER_COLUMNS;
 
@@ -231,7 +231,7 @@ QVariant NavSearch::modelDataHandler(int colIndex, int rowIndex, const Column *c
   switch(role)
   {
     case Qt::DisplayRole:
-      return formatModelData(col, displayRoleValue);
+      return formatterForColumn(col)(displayRoleValue);
 
     case Qt::TextAlignmentRole:
       if(col->getColumnName() == "ident" || col->getColumnName() == "airport_ident" ||
@@ -255,38 +255,49 @@ QVariant NavSearch::modelDataHandler(int colIndex, int rowIndex, const Column *c
   return QVariant();
 }
 
-/* Formats the QVariant to a QString depending on column name */
-QString NavSearch::formatModelData(const Column *col, const QVariant& displayRoleValue) const
+/* Get a function that formats the QVariant to a QString depending on column name.
+ * Called once per column for exports. Returned functions are thread safe. */
+SqlModel::FormatFunctionType NavSearch::formatterForColumn(const Column *col) const
 {
-  // Called directly by the model for export functions
-  if(col->getColumnName() == "type")
-    return maptypes::navTypeName(displayRoleValue.toString());
-  else if(col->getColumnName() == "nav_type")
-    return maptypes::navName(displayRoleValue.toString());
-  else if(col->getColumnName() == "name")
-    return atools::capString(displayRoleValue.toString());
-  else if(col->getColumnName() == "frequency" && !displayRoleValue.isNull())
-  {
-    double freq = displayRoleValue.toDouble();
-
-    // VOR and DME are scaled up in nav_search to easily differentiate from NDB
-    if(freq >= 1000000 && freq <= 1200000)
-      return QLocale().toString(displayRoleValue.toDouble() / 10000., 'f', 2);
-    else if(freq >= 10000 && freq <= 120000)
-      return QLocale().toString(displayRoleValue.toDouble() / 100., 'f', 1);
-    else
-      return "Invalid";
-  }
-  else if(col->getColumnName() == "mag_var")
-    return maptypes::magvarText(displayRoleValue.toFloat());
-  else if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
-    return QLocale().toString(displayRoleValue.toInt());
-  else if(displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() == QVariant::ULongLong)
-    return QLocale().toString(displayRoleValue.toLongLong());
-  else if(displayRoleValue.type() == QVariant::Double)
-    return QLocale().toString(displayRoleValue.toDouble());
-
-  return displayRoleValue.toString();
+  const QString& name = col->getColumnName();
+  if(name == "type")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::navTypeName(value.toString());
+           };
+  else if(name == "nav_type")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::navName(value.toString());
+           };
+  else if(name == "name")
+    return [](const QVariant& value) -> QString
+           {
+             return atools::capString(value.toString());
+           };
+  else if(name == "frequency")
+    return [](const QVariant& value) -> QString
+           {
+             if(value.isNull())
+               return formatDefault(value);
+
+             double freq = value.toDouble();
+
+             // VOR and DME are scaled up in nav_search to easily differentiate from NDB
+             if(freq >= 1000000 && freq <= 1200000)
+               return QLocale().toString(freq / 10000., 'f', 2);
+             else if(freq >= 10000 && freq <= 120000)
+               return QLocale().toString(freq / 100., 'f', 1);
+             else
+               return "Invalid";
+           };
+  else if(name == "mag_var")
+    return [](const QVariant& value) -> QString
+           {
+             return maptypes::magvarText(value.toFloat());
+           };
+
+  return &SearchBase::formatDefault;
 }
 
 void NavSearch::getSelectedMapObjects(maptypes::MapSearchResult& result) const
@@ -346,6 +357,7 @@ void NavSearch::setCallbacks()
   using namespace std::placeholders;
   controller->setDataCallback(std::bind(&NavSearch::modelDataHandler, this, _1, _2, _3, _4, _5, _6),
                               {Qt::DisplayRole, Qt::BackgroundRole, Qt::TextAlignmentRole});
+  controller->setColumnFormatCallback(std::bind(&NavSearch::formatterForColumn, this, _1));
 }
 
 /* Update the button menu actions. Add * for changed search criteria and toggle show/hide all
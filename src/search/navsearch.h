@@ -19,6 +19,7 @@
 #define LITTLENAVMAP_NAVSEARCH_H
 
 #include "search/searchbase.h"
+#include "search/sqlmodel.h"
 
 #include <QObject>
 
@@ -65,7 +66,7 @@ private:
   void setCallbacks();
   QVariant modelDataHandler(int colIndex, int rowIndex, const Column *col, const QVariant& roleValue,
                             const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
-  QString formatModelData(const Column *col, const QVariant& displayRoleValue) const;
+  SqlModel::FormatFunctionType formatterForColumn(const Column *col) const;
 
   /* All layouts, lines and drop down menu items */
   QList<QObject *> navSearchWidgets;
@@ -26,15 +26,21 @@
 #include "atools.h"
 #include "gui/actiontextsaver.h"
 #include "export/csvexporter.h"
+#include "export/htmlexporter.h"
+#include "export/geoexporter.h"
 #include "mapgui/mapquery.h"
 #include "options/optiondata.h"
 
 #include <QTimer>
+#include <QLocale>
 #include <QClipboard>
 
 /* When using distance search delay the update the table after 500 milliseconds */
 const int DISTANCE_EDIT_UPDATE_TIMEOUT_MS = 500;
 
+/* Start a new HTML file after this number of rows */
+const int HTML_EXPORT_ROWS_PER_PAGE = 1000;
+
 SearchBase::SearchBase(MainWindow *parent, QTableView *tableView, ColumnList *columnList,
                        MapQuery *mapQuery, int tabWidgetIndex)
   : QObject(parent), columns(columnList), view(tableView), mainWindow(parent), query(mapQuery),
@@ -76,6 +82,8 @@ SearchBase::SearchBase(MainWindow *parent, QTableView *tableView, ColumnList *co
 SearchBase::~SearchBase()
 {
   delete csvExporter;
+  delete htmlExporter;
+  delete geoExporter;
   delete updateTimer;
   delete zoomHandler;
   delete columns;
@@ -96,6 +104,38 @@ void SearchBase::tableCopyClipboard()
   }
 }
 
+/* Export all rows of the current search result into a CSV file */
+void SearchBase::exportAllCsv()
+{
+  int exported = csvExporter->exportAll(false);
+  if(exported > 0)
+    mainWindow->setStatusMessage(QString(tr("Exported %1 entries to CSV.")).arg(exported));
+}
+
+/* Export all rows of the current search result into one or more HTML files */
+void SearchBase::exportAllHtml()
+{
+  int exported = htmlExporter->exportAll(true);
+  if(exported > 0)
+    mainWindow->setStatusMessage(QString(tr("Exported %1 entries to HTML.")).arg(exported));
+}
+
+/* Export all rows of the current search result into a GeoJSON file */
+void SearchBase::exportAllGeoJson()
+{
+  int exported = geoExporter->exportAllGeoJson();
+  if(exported > 0)
+    mainWindow->setStatusMessage(QString(tr("Exported %1 entries to GeoJSON.")).arg(exported));
+}
+
+/* Export all rows of the current search result into a binary file */
+void SearchBase::exportAllBinary()
+{
+  int exported = geoExporter->exportAllBinary();
+  if(exported > 0)
+    mainWindow->setStatusMessage(QString(tr("Exported %1 entries to binary file.")).arg(exported));
+}
+
 void SearchBase::initViewAndController()
 {
   view->horizontalHeader()->setSectionsMovable(true);
@@ -106,6 +146,8 @@ void SearchBase::initViewAndController()
   controller->prepareModel();
 
   csvExporter = new CsvExporter(mainWindow, controller);
+  htmlExporter = new HtmlExporter(mainWindow, controller, HTML_EXPORT_ROWS_PER_PAGE);
+  geoExporter = new GeoExporter(mainWindow, controller);
 }
 
 void SearchBase::filterByIdent(const QString& ident, const QString& region, const QString& airportIdent)
@@ -281,6 +323,18 @@ void SearchBase::distanceSearchChanged(bool checked, bool changeViewState)
   updateButtonMenu();
 }
 
+QString SearchBase::formatDefault(const QVariant& value)
+{
+  if(value.type() == QVariant::Int || value.type() == QVariant::UInt)
+    return QLocale().toString(value.toInt());
+  else if(value.type() == QVariant::LongLong || value.type() == QVariant::ULongLong)
+    return QLocale().toString(value.toLongLong());
+  else if(value.type() == QVariant::Double)
+    return QLocale().toString(value.toDouble());
+
+  return value.toString();
+}
+
 /* Search criteria editing has started. Start or restart the timer for a
  * delayed update if distance search is used */
 void SearchBase::editStartTimer()
@@ -314,6 +368,7 @@ void SearchBase::connectSearchSlots()
   connect(controller->getSqlModel(), &SqlModel::modelReset, this, &SearchBase::reconnectSelectionModel);
   void (SearchBase::*selChangedPtr)() = &SearchBase::tableSelectionChanged;
   connect(controller->getSqlModel(), &SqlModel::fetchedMore, this, selChangedPtr);
+  connect(controller->getSqlModel(), &SqlModel::allRowsFetched, this, &SearchBase::allRowsFetched);
 
   connect(ui->dockWidgetSearch, &QDockWidget::visibilityChanged, this, &SearchBase::dockVisibilityChanged);
 }
@@ -397,7 +452,17 @@ void SearchBase::loadAllRowsIntoView()
   Ui::MainWindow *ui = mainWindow->getUi();
   if(ui->tabWidgetSearch->currentIndex() == tabIndex)
   {
+    // Rows arrive in the background - message is shown by allRowsFetched
+    loadAllRowsRequested = true;
     controller->loadAllRows();
+  }
+}
+
+void SearchBase::allRowsFetched()
+{
+  if(loadAllRowsRequested)
+  {
+    loadAllRowsRequested = false;
     mainWindow->setStatusMessage(tr("All entries read."));
   }
 }
@@ -515,6 +580,10 @@ void SearchBase::contextMenu(const QPoint& pos)
 
   ui->actionSearchTableCopy->setEnabled(index.isValid());
   ui->actionSearchTableSelectAll->setEnabled(controller->getTotalRowCount() > 0);
+  ui->actionSearchExportCsv->setEnabled(controller->getTotalRowCount() > 0);
+  ui->actionSearchExportHtml->setEnabled(controller->getTotalRowCount() > 0);
+  ui->actionSearchExportGeoJson->setEnabled(controller->getTotalRowCount() > 0);
+  ui->actionSearchExportBinary->setEnabled(controller->getTotalRowCount() > 0);
 
   // Build the menu
   QMenu menu;
@@ -546,6 +615,12 @@ void SearchBase::contextMenu(const QPoint& pos)
   menu.addAction(ui->actionSearchTableSelectAll);
   menu.addSeparator();
 
+  menu.addAction(ui->actionSearchExportCsv);
+  menu.addAction(ui->actionSearchExportHtml);
+  menu.addAction(ui->actionSearchExportGeoJson);
+  menu.addAction(ui->actionSearchExportBinary);
+  menu.addSeparator();
+
   menu.addAction(ui->actionSearchResetView);
   menu.addSeparator();
 
@@ -560,6 +635,14 @@ void SearchBase::contextMenu(const QPoint& pos)
       resetView();
     else if(action == ui->actionSearchTableCopy)
       tableCopyClipboard();
+    else if(action == ui->actionSearchExportCsv)
+      exportAllCsv();
+    else if(action == ui->actionSearchExportHtml)
+      exportAllHtml();
+    else if(action == ui->actionSearchExportGeoJson)
+      exportAllGeoJson();
+    else if(action == ui->actionSearchExportBinary)
+      exportAllBinary();
     else if(action == ui->actionSearchFilterIncluding)
       controller->filterIncluding(index);
     else if(action == ui->actionSearchFilterExcluding)
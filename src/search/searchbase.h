@@ -36,6 +36,8 @@ class QItemSelection;
 class MapQuery;
 class QTimer;
 class CsvExporter;
+class HtmlExporter;
+class GeoExporter;
 
 /*
  * Base for all search classes which reside each in its own tab, contains a result table view and a list of
@@ -119,6 +121,9 @@ protected:
 
   void distanceSearchChanged(bool checked, bool changeViewState);
 
+  /* Format numbers using the locale and all other values as is */
+  static QString formatDefault(const QVariant& value);
+
   /* Table/view controller */
   SqlController *controller;
 
@@ -141,7 +146,12 @@ private:
   void editTimeout();
 
   void loadAllRowsIntoView();
+  void allRowsFetched();
   void tableCopyClipboard();
+  void exportAllCsv();
+  void exportAllHtml();
+  void exportAllGeoJson();
+  void exportAllBinary();
   void showInformationTriggered();
   void showOnMapTriggered();
   void contextMenu(const QPoint& pos);
@@ -151,8 +161,10 @@ private:
   /* Used to make the table rows smaller and also used to adjust font size */
   atools::gui::TableZoomHandler *zoomHandler = nullptr;
 
-  /* CSV export to clipboard */
+  /* CSV export to clipboard and to file */
   CsvExporter *csvExporter = nullptr;
+  HtmlExporter *htmlExporter = nullptr;
+  GeoExporter *geoExporter = nullptr;
   MapQuery *query;
 
   /* Used to delay search when using the time intensive distance search */
@@ -161,6 +173,9 @@ private:
   /* Tab index of this search tab on the search dock window */
   int tabIndex;
 
+  /* Show a message once all rows requested by the user are loaded */
+  bool loadAllRowsRequested = false;
+
 };
 
 #endif // LITTLENAVMAP_SEARCHBASE_H
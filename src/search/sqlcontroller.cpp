@@ -25,7 +25,6 @@
 #include <QTableView>
 #include <QHeaderView>
 #include <QSpinBox>
-#include <QApplication>
 
 using atools::sql::SqlQuery;
 using atools::sql::SqlDatabase;
@@ -65,6 +64,7 @@ void SqlController::postDatabaseLoad()
     viewSetModel(proxyModel);
   else
     viewSetModel(model);
+  model->updateTextIndex();
   model->resetSqlQuery();
   model->fillHeaderData();
 }
@@ -202,8 +202,8 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlproxymod
     // Update distances in proxy to get precise radius filtering (second filter stage)
     proxyModel->setDistanceFilter(center, dir, minDistance, maxDistance);
 
-    // Update rectangle filter in query model (first coarse filter stage)
-    model->filterByBoundingRect(rect);
+    // Update rectangle and radius filter in query model (first coarse filter stage)
+    model->filterByBoundingRect(rect, center, atools::geo::nmToMeter(maxDistance));
 
     if(proxyWasNull)
     {
@@ -248,7 +248,7 @@ void SqlController::filterByDistanceUpdate(sqlproxymodel::SearchDirection dir, i
     // Update proxy second stage filter
     proxyModel->setDistanceFilter(currentDistanceCenter, dir, minDistance, maxDistance);
     // Update SQL model coarse first stage filter
-    model->filterByBoundingRect(rect);
+    model->filterByBoundingRect(rect, currentDistanceCenter, atools::geo::nmToMeter(maxDistance));
     searchParamsChanged = true;
   }
 }
@@ -318,6 +318,11 @@ const Column *SqlController::getColumnDescriptor(int physicalIndex) const
   return model->getColumnModel(physicalIndex);
 }
 
+const Column *SqlController::getIdColumnDescriptor() const
+{
+  return columns->getIdColumn();
+}
+
 void SqlController::resetView()
 {
   // Reorder columns to match model order
@@ -355,6 +360,11 @@ QString SqlController::getCurrentSqlQuery() const
   return model->getCurrentSqlQuery();
 }
 
+QString SqlController::getCurrentCountQuery() const
+{
+  return model->getCurrentCountQuery();
+}
+
 QModelIndex SqlController::getModelIndexAt(const QPoint& pos) const
 {
   return view->indexAt(pos);
@@ -456,19 +466,14 @@ void SqlController::loadAllRowsForDistanceSearch()
 {
   if(searchParamsChanged && proxyModel != nullptr)
   {
-    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-
     // Run query again
     model->resetSqlQuery();
 
     // Let proxy know that filter parameters have changed
     proxyModel->invalidate();
 
-    while(model->canFetchMore())
-      // Fetch as long as we can
-      model->fetchMore(QModelIndex());
-
-    QGuiApplication::restoreOverrideCursor();
+    // Rows are added in the background and filtered by the proxy while they arrive
+    model->fetchAll();
     searchParamsChanged = false;
   }
 }
@@ -479,10 +484,13 @@ void SqlController::setDataCallback(const SqlModel::DataFunctionType& value,
   model->setDataCallback(value, roles);
 }
 
-void SqlController::loadAllRows()
+void SqlController::setColumnFormatCallback(const SqlModel::ColumnFormatFunctionType& value)
 {
-  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+  model->setColumnFormatCallback(value);
+}
 
+void SqlController::loadAllRows()
+{
   if(proxyModel != nullptr)
   {
     // Run query again
@@ -492,10 +500,8 @@ void SqlController::loadAllRows()
     proxyModel->invalidate();
   }
 
-  while(model->canFetchMore())
-    model->fetchMore(QModelIndex());
-
-  QGuiApplication::restoreOverrideCursor();
+  // Rows are added in the background
+  model->fetchAll();
 }
 
 QVector<const Column *> SqlController::getCurrentColumns() const
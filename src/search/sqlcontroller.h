@@ -88,6 +88,9 @@ public:
   /* Get descriptor for column at physical index */
   const Column *getColumnDescriptor(int physicalIndex) const;
 
+  /* Get descriptor for the primary key column */
+  const Column *getIdColumnDescriptor() const;
+
   /* Number of rows currently loaded into the table view */
   int getVisibleRowCount() const;
 
@@ -97,6 +100,9 @@ public:
   /* Get the SQL query that was used to populate the table */
   QString getCurrentSqlQuery() const;
 
+  /* Get the SQL query that returns the total number of rows */
+  QString getCurrentCountQuery() const;
+
   /* Get all descriptors for currently displayed columns */
   QVector<const Column *> getCurrentColumns() const;
 
@@ -148,10 +154,19 @@ public:
     return proxyModel != nullptr;
   }
 
+  /* Get the second stage filter of the distance search. Filter is invalid if distance search is not active. */
+  sqlproxymodel::DistanceFilter getDistanceFilter() const
+  {
+    return proxyModel != nullptr ? proxyModel->getDistanceFilter() : sqlproxymodel::DistanceFilter();
+  }
+
   /* Set the callback that will handle data rows and values, i.e. format values to strings.
    * Set the desired data roles that the callback should be called for */
   void setDataCallback(const SqlModel::DataFunctionType& value, const QSet<Qt::ItemDataRole>& roles);
 
+  /* Set the callback that returns a formatter for each column */
+  void setColumnFormatCallback(const SqlModel::ColumnFormatFunctionType& value);
+
   /* Get position for the row at the given index. The query needs to have a lonx and laty column */
   atools::geo::Pos getGeoPos(const QModelIndex& index);
 
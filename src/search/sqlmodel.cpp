@@ -21,31 +21,56 @@
 #include "gui/errorhandler.h"
 #include "search/columnlist.h"
 #include "sql/sqldatabase.h"
-#include "sql/sqlquery.h"
-#include "exception.h"
 #include "search/column.h"
 #include "sql/sqlrecord.h"
+#include "geo/calculations.h"
 
 #include <QLineEdit>
 #include <QCheckBox>
 #include <QSqlError>
+#include <QSqlField>
+
+#include <cmath>
 
-using atools::sql::SqlQuery;
 using atools::sql::SqlDatabase;
 using atools::gui::ErrorHandler;
 using atools::sql::SqlRecord;
 
 SqlModel::SqlModel(QWidget *parent, SqlDatabase *sqlDb, const ColumnList *columnList)
-  : QSqlQueryModel(parent), db(sqlDb), columns(columnList), parentWidget(parent)
+  : QAbstractTableModel(parent), db(sqlDb), columns(columnList), parentWidget(parent)
 {
+  qRegisterMetaType<SqlModelRows>("SqlModelRows");
+
+  // Worker lives in its own thread and is deleted when the thread stops
+  worker = new SqlModelWorker(&latestQueryId);
+  worker->moveToThread(&workerThread);
+  connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+
+  // Calls into the worker thread are queued
+  connect(this, &SqlModel::startQueryInWorker, worker, &SqlModelWorker::startQuery);
+  connect(this, &SqlModel::fetchRowsInWorker, worker, &SqlModelWorker::fetchRows);
+  connect(this, &SqlModel::closeDatabaseInWorker, worker, &SqlModelWorker::closeDatabase,
+          Qt::BlockingQueuedConnection);
+
+  connect(worker, &SqlModelWorker::rowsAvailable, this, &SqlModel::rowsAvailable);
+  connect(worker, &SqlModelWorker::totalRowCountAvailable, this, &SqlModel::totalRowCountAvailable);
+  connect(worker, &SqlModelWorker::queryFailed, this, &SqlModel::queryFailed);
+
+  workerThread.start();
+
   // Set default handler
   setDataCallback(nullptr, QSet<Qt::ItemDataRole>());
 
+  buildRecord();
+  textIndexTable = textindex::indexTableName(db, columns->getTablename());
   buildQuery();
 }
 
 SqlModel::~SqlModel()
 {
+  cancelQuery();
+  workerThread.quit();
+  workerThread.wait();
 }
 
 void SqlModel::filterIncluding(QModelIndex index)
@@ -60,9 +85,12 @@ void SqlModel::filterExcluding(QModelIndex index)
   buildQuery();
 }
 
-void SqlModel::filterByBoundingRect(const atools::geo::Rect& boundingRectangle)
+void SqlModel::filterByBoundingRect(const atools::geo::Rect& boundingRectangle,
+                                    const atools::geo::Pos& center, float maxDistanceMeter)
 {
   boundingRect = boundingRectangle;
+  distanceCenter = center;
+  distanceMaxMeter = maxDistanceMeter;
   buildQuery();
 }
 
@@ -85,7 +113,7 @@ void SqlModel::filterByIdent(const QString& ident, const QString& region, const
 void SqlModel::filterBy(QModelIndex index, bool exclude)
 {
   QString whereCol = getSqlRecord().fieldName(index.column());
-  filterBy(exclude, whereCol, QSqlQueryModel::data(index));
+  filterBy(exclude, whereCol, getRawData(index.row(), index.column()));
 }
 
 /* Simple include/exclude filter. Updates the attached search widgets */
@@ -268,6 +296,10 @@ void SqlModel::setDataCallback(const DataFunctionType& func, const QSet<Qt::Item
   handlerRoles = roles;
   dataFunction = func;
   }
+
+  // Formatted values might differ for the new callback
+  displayCache.clear();
+  displayCache.resize(rows.size());
 }
 
 void SqlModel::resetSort()
@@ -299,6 +331,8 @@ void SqlModel::clearWhereConditions()
 {
   whereConditionMap.clear();
   boundingRect = atools::geo::Rect();
+  distanceCenter = atools::geo::Pos();
+  distanceMaxMeter = 0.f;
 }
 
 /* Set header captions */
@@ -351,13 +385,28 @@ void SqlModel::sort(int column, Qt::SortOrder order)
   buildQuery();
 }
 
+/* Field names are known from the column list before the query runs */
+void SqlModel::buildRecord()
+{
+  queryRecord.clear();
+  for(const Column *col : columns->getColumns())
+    queryRecord.append(QSqlField(col->getColumnName()));
+
+  headers.fill(QVariant(), queryRecord.count());
+}
+
 /* Build full list of columns to query */
 QString SqlModel::buildColumnList()
 {
+  QString distanceExpr = buildDistanceExpression();
+
   QVector<QString> colNames;
   for(const Column *col : columns->getColumns())
   {
-    if(col->isDistance())
+    if(col->getColumnName() == "distance" && !distanceExpr.isEmpty())
+      // Approximate distance used for ordering - proxy calculates the precise value
+      colNames.append(distanceExpr + " as " + col->getColumnName());
+    else if(col->isDistance())
       // Add null for special distance columns
       colNames.append("null as " + col->getColumnName());
     else
@@ -380,6 +429,22 @@ QString SqlModel::buildColumnList()
 
 /* Create SQL query and set it into the model */
 void SqlModel::buildQuery()
+{
+  buildQueryStrings();
+
+  if(!boundingRect.isValid())
+    // Delay query for bounding rectangle query with proxy model
+    resetSqlQuery();
+}
+
+void SqlModel::updateTextIndex()
+{
+  textIndexTable = textindex::indexTableName(db, columns->getTablename());
+  buildQueryStrings();
+}
+
+/* Build the SQL query and the query for the total row count */
+void SqlModel::buildQueryStrings()
 {
   QString queryCols = buildColumnList();
 
@@ -405,34 +470,16 @@ void SqlModel::buildQuery()
     else
       queryOrder += "order by " + orderByCol + " " + orderByOrder;
   }
+  else if(!buildDistanceExpression().isEmpty() && (orderByCol.isEmpty() || orderByCol == "distance"))
+    // Distance search - let rows arrive sorted by distance
+    queryOrder += "order by distance " + (orderByOrder.isEmpty() ? QString("asc") : orderByOrder);
 
   currentSqlQuery = "select " + queryCols + " from " + columns->getTablename() +
                     " " + queryWhere + " " + queryOrder;
 
-  // Build a query to find the total row count of the result
+  // Build a query to find the total row count of the result - worker runs it after the first rows
   totalRowCount = 0;
-  QString queryCount = "select count(1) from " + columns->getTablename() + " " + queryWhere;
-
-  try
-  {
-    // Count total rows
-    SqlQuery countStmt(db);
-    countStmt.exec(queryCount);
-    if(countStmt.next())
-      totalRowCount = countStmt.value(0).toInt();
-
-    if(!boundingRect.isValid())
-      // Delay query for bounding rectangle query with proxy model
-      resetSqlQuery();
-  }
-  catch(atools::Exception& e)
-  {
-    ATOOLS_HANDLE_EXCEPTION(e);
-  }
-  catch(...)
-  {
-    ATOOLS_HANDLE_UNKNOWN_EXCEPTION;
-  }
+  currentCountQuery = "select count(1) from " + columns->getTablename() + " " + queryWhere;
 }
 
 /* Build where statement */
@@ -447,7 +494,11 @@ QString SqlModel::buildWhere()
     if(numCond++ > 0)
       queryWhere += " " + WHERE_OPERATOR + " ";
 
-    if(cond.col->isIncludesName())
+    QString textIndexCond = buildWhereTextIndex(cond);
+    if(!textIndexCond.isEmpty())
+      // Let the full text index find the rows
+      queryWhere += textIndexCond;
+    else if(cond.col->isIncludesName())
       // Condition includes column name
       queryWhere += " " + cond.oper + " ";
     else
@@ -480,6 +531,16 @@ QString SqlModel::buildWhere()
       queryWhere += " " + WHERE_OPERATOR + " ";
     queryWhere += rectCond;
     numCond++;
+
+    QString distanceExpr = buildDistanceExpression();
+    if(!distanceExpr.isEmpty())
+    {
+      // Remove the corners of the rectangle - add a small margin for rounding errors
+      float maxDistanceDeg = atools::geo::meterToNm(distanceMaxMeter) / 60.f * 1.01f;
+      queryWhere += " " + WHERE_OPERATOR + " " + distanceExpr +
+                    QString(" <= %1").arg(maxDistanceDeg * maxDistanceDeg, 0, 'g', 10);
+      numCond++;
+    }
   }
 
   if(numCond > 0)
@@ -491,6 +552,43 @@ QString SqlModel::buildWhere()
   return queryWhere;
 }
 
+/* Squared flat distance in degrees for the distance search or empty if not applicable.
+ * Uses the smallest longitude factor of the bounding rectangle. The great circle between the center and any
+ * point within the radius stays inside the rectangle, so the value is never larger than the squared great
+ * circle distance and can be used as a prefilter. */
+QString SqlModel::buildDistanceExpression() const
+{
+  if(!boundingRect.isValid() || !distanceCenter.isValid() || distanceMaxMeter <= 0.f ||
+     boundingRect.crossesAntiMeridian())
+    return QString();
+
+  float maxLatY = std::max(std::abs(boundingRect.getTopLeft().getLatY()),
+                           std::abs(boundingRect.getBottomRight().getLatY()));
+  double lonFactor = std::cos(atools::geo::toRadians(static_cast<double>(std::min(maxLatY, 90.f))));
+
+  return QString("((lonx - %1) * (lonx - %1) * %2 + (laty - %3) * (laty - %3))").
+         arg(distanceCenter.getLonX(), 0, 'g', 10).
+         arg(lonFactor * lonFactor, 0, 'g', 10).
+         arg(distanceCenter.getLatY(), 0, 'g', 10);
+}
+
+/* Build a condition that uses the full text index for "like" or return an empty string if not applicable.
+ * Only positive conditions are used since "not like" would also return rows having null values. */
+QString SqlModel::buildWhereTextIndex(const WhereCondition& cond)
+{
+  if(textIndexTable.isEmpty() || cond.oper.trimmed() != "like" || cond.value.type() != QVariant::String ||
+     cond.col->isIncludesName())
+    return QString();
+
+  if(!textindex::isIndexedColumn(columns->getTablename(), cond.col->getColumnName()) ||
+     !textindex::isIndexablePattern(cond.value.toString()))
+    return QString();
+
+  // Trigram tokenizer evaluates the same case insensitive like pattern using the index
+  return columns->getIdColumn()->getColumnName() + " in (select rowid from " + textIndexTable +
+         " where " + cond.col->getColumnName() + " like" + buildWhereValue(cond) + ")";
+}
+
 /* Convert a value to string for the where clause */
 QString SqlModel::buildWhereValue(const WhereCondition& cond)
 {
@@ -510,10 +608,127 @@ QString SqlModel::buildWhereValue(const WhereCondition& cond)
 
 void SqlModel::resetSqlQuery()
 {
-  QSqlQueryModel::setQuery(currentSqlQuery, db->getQSqlDatabase());
+  // Let the worker abandon any running query
+  cancelQuery();
+
+  beginResetModel();
+  rows.clear();
+  displayCache.clear();
+  totalRowCount = 0;
+  moreRowsAvailable = true;
+  fetching = true;
+  endResetModel();
+
+  // Worker opens its own connection to the same database and sends the first batch
+  QSqlDatabase sqlDb = db->getQSqlDatabase();
+  emit startQueryInWorker(currentQueryId, sqlDb.driverName(), sqlDb.databaseName(),
+                          currentCountQuery, currentSqlQuery);
+}
+
+void SqlModel::cancelQuery()
+{
+  currentQueryId++;
+  latestQueryId.storeRelease(currentQueryId);
+  moreRowsAvailable = false;
+  fetching = false;
+  fetchingAll = false;
+}
+
+void SqlModel::clear()
+{
+  cancelQuery();
+
+  beginResetModel();
+  rows.clear();
+  displayCache.clear();
+  totalRowCount = 0;
+  endResetModel();
+
+  // Wait until the worker has closed its connection since the database file might be replaced
+  emit closeDatabaseInWorker();
+}
+
+void SqlModel::rowsAvailable(int queryId, const SqlModelRows& newRows, bool more)
+{
+  if(queryId != currentQueryId)
+    // Left over from an old query
+    return;
+
+  if(!newRows.isEmpty())
+  {
+    beginInsertRows(QModelIndex(), rows.size(), rows.size() + newRows.size() - 1);
+    rows.append(newRows);
+    displayCache.resize(rows.size());
+    endInsertRows();
+  }
+
+  bool allFetched = fetchingAll && !more;
+
+  moreRowsAvailable = more;
+  if(!more)
+    fetchingAll = false;
+
+  // Worker keeps sending batches if all rows were requested
+  fetching = fetchingAll;
+  emit fetchedMore();
+
+  if(allFetched)
+    emit allRowsFetched();
+}
+
+void SqlModel::totalRowCountAvailable(int queryId, int count)
+{
+  if(queryId == currentQueryId)
+  {
+    totalRowCount = count;
+    emit fetchedMore();
+  }
+}
+
+void SqlModel::queryFailed(int queryId, const QString& driverText, const QString& databaseText)
+{
+  if(queryId == currentQueryId)
+  {
+    moreRowsAvailable = false;
+    fetching = false;
+    fetchingAll = false;
+    atools::gui::ErrorHandler(parentWidget).handleSqlError(
+      QSqlError(driverText, databaseText, QSqlError::StatementError));
+  }
+}
 
-  if(lastError().isValid())
-    atools::gui::ErrorHandler(parentWidget).handleSqlError(lastError());
+int SqlModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : rows.size();
+}
+
+int SqlModel::columnCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : queryRecord.count();
+}
+
+QVariant SqlModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if(orientation == Qt::Horizontal && section >= 0 && section < headers.size() &&
+     (role == Qt::DisplayRole || role == Qt::EditRole))
+  {
+    // Use field name if no caption was set
+    const QVariant& header = headers.at(section);
+    return header.isValid() ? header : QVariant(queryRecord.fieldName(section));
+  }
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool SqlModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant& value, int role)
+{
+  if(orientation == Qt::Horizontal && section >= 0 && section < headers.size() &&
+     (role == Qt::DisplayRole || role == Qt::EditRole))
+  {
+    headers[section] = value;
+    emit headerDataChanged(orientation, section, section);
+    return true;
+  }
+  return false;
 }
 
 Qt::SortOrder SqlModel::getSortOrder() const
@@ -542,17 +757,26 @@ QVariant SqlModel::data(const QModelIndex& index, int role) const
 
   Qt::ItemDataRole dataRole = static_cast<Qt::ItemDataRole>(role);
 
-  // Get the default value for this role. Can be a font, color, etc.
-  QVariant roleValue = QSqlQueryModel::data(index, role);
+  if(dataRole == Qt::DisplayRole)
+  {
+    // Formatting is done only once per cell - scrolling uses the cached values
+    const QVariant& cached = cachedDisplayValue(index.row(), index.column());
+    if(cached.isValid())
+      return cached;
+  }
+
+  // Get data to display
+  QVariant dataValue = getRawData(index.row(), index.column());
+
+  // Get the default value for this role. Only display and edit roles have a value.
+  QVariant roleValue;
+  if(dataRole == Qt::DisplayRole || dataRole == Qt::EditRole)
+    roleValue = dataValue;
 
   if(handlerRoles.contains(dataRole))
   {
     // Callback wants to be called for this role
-
-    // Get data to display
-    QVariant dataValue = QSqlQueryModel::data(index, Qt::DisplayRole);
-    QString col = getSqlRecord().fieldName(index.column());
-    const Column *column = columns->getColumn(col);
+    const Column *column = columns->getColumn(queryRecord.fieldName(index.column()));
 
     int row = -1;
     if(!boundingRect.isValid())
@@ -561,15 +785,66 @@ QVariant SqlModel::data(const QModelIndex& index, int role) const
 
     QVariant retval = dataFunction(index.column(), row, column, roleValue, dataValue, dataRole);
     if(retval.isValid())
-      return retval;
+      roleValue = retval;
   }
+
+  if(dataRole == Qt::DisplayRole)
+    cacheDisplayValue(index.row(), index.column(), roleValue);
+
   return roleValue;
 }
 
+const QVariant& SqlModel::cachedDisplayValue(int row, int col) const
+{
+  static const QVariant EMPTY;
+  if(row >= 0 && row < displayCache.size() && col >= 0 && col < displayCache.at(row).size())
+    return displayCache.at(row).at(col);
+  else
+    return EMPTY;
+}
+
+void SqlModel::cacheDisplayValue(int row, int col, const QVariant& value) const
+{
+  if(row < 0 || row >= displayCache.size() || col < 0 || col >= queryRecord.count())
+    return;
+
+  QVector<QVariant>& cacheRow = displayCache[row];
+  if(cacheRow.isEmpty())
+    cacheRow.resize(queryRecord.count());
+  cacheRow[col] = value;
+}
+
 void SqlModel::fetchMore(const QModelIndex& parent)
 {
-  QSqlQueryModel::fetchMore(parent);
-  emit fetchedMore();
+  if(parent.isValid() || !moreRowsAvailable || fetching)
+    // Nothing left or rows are already on the way
+    return;
+
+  fetching = true;
+  emit fetchRowsInWorker(currentQueryId, false);
+}
+
+bool SqlModel::canFetchMore(const QModelIndex& parent) const
+{
+  return !parent.isValid() && moreRowsAvailable;
+}
+
+void SqlModel::fetchAll()
+{
+  if(fetchingAll)
+    return;
+
+  if(!moreRowsAvailable)
+  {
+    // Everything is already loaded
+    emit allRowsFetched();
+    return;
+  }
+
+  // Queued behind any running fetch for this query
+  fetchingAll = true;
+  fetching = true;
+  emit fetchRowsInWorker(currentQueryId, true);
 }
 
 QVariant SqlModel::getRawData(int row, const QString& colname) const
@@ -579,7 +854,10 @@ QVariant SqlModel::getRawData(int row, const QString& colname) const
 
 QVariant SqlModel::getRawData(int row, int col) const
 {
-  return QSqlQueryModel::data(createIndex(row, col));
+  if(row >= 0 && row < rows.size() && col >= 0 && col < rows.at(row).size())
+    return rows.at(row).at(col);
+  else
+    return QVariant();
 }
 
 QString SqlModel::getColumnName(int col) const
@@ -594,10 +872,13 @@ QVariant SqlModel::getFormattedFieldData(const QModelIndex& index) const
 
 atools::sql::SqlRecord SqlModel::getSqlRecord() const
 {
-  return atools::sql::SqlRecord(record(), currentSqlQuery);
+  return atools::sql::SqlRecord(queryRecord, currentSqlQuery);
 }
 
 atools::sql::SqlRecord SqlModel::getSqlRecord(int row) const
 {
-  return atools::sql::SqlRecord(record(row), currentSqlQuery);
+  QSqlRecord rec(queryRecord);
+  for(int i = 0; i < rec.count(); i++)
+    rec.setValue(i, getRawData(row, i));
+  return atools::sql::SqlRecord(rec, currentSqlQuery);
 }
@@ -19,10 +19,14 @@
 #define LITTLENAVMAP_SQLMODEL_H
 
 #include "geo/rect.h"
+#include "search/sqlmodelworker.h"
 
 #include <functional>
 
-#include <QSqlQueryModel>
+#include <QAbstractTableModel>
+#include <QAtomicInt>
+#include <QSqlRecord>
+#include <QThread>
 
 namespace atools {
 namespace sql {
@@ -36,10 +40,14 @@ class Column;
 class ColumnList;
 
 /*
- * Extends the QSqlQueryModel and adds query building based on filters and ordering.
+ * Table model that adds query building based on filters and ordering.
+ *
+ * Queries are executed by a SqlModelWorker in a background thread with its own database connection.
+ * Rows arrive in batches and are appended to the model. A new query supersedes a running one
+ * which is then abandoned by the worker.
  */
 class SqlModel :
-  public QSqlQueryModel
+  public QAbstractTableModel
 {
   Q_OBJECT
 
@@ -104,18 +112,46 @@ public:
     return currentSqlQuery;
   }
 
-  /* Fetch more data and emit signal fetchedMore */
+  /* Query returning the total number of rows for the current query */
+  QString getCurrentCountQuery() const
+  {
+    return currentCountQuery;
+  }
+
+  /* Request the next batch of rows from the worker. Signal fetchedMore is emitted when the rows arrive. */
   virtual void fetchMore(const QModelIndex& parent) override;
+  virtual bool canFetchMore(const QModelIndex& parent) const override;
+
+  /* Request all remaining rows. Rows are added in batches in the background. */
+  void fetchAll();
+
+  /* Stop running query, remove all rows and close the worker database connection */
+  void clear();
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual QVariant headerData(int section, Qt::Orientation orientation,
+                              int role = Qt::DisplayRole) const override;
+  virtual bool setHeaderData(int section, Qt::Orientation orientation, const QVariant& value,
+                             int role = Qt::EditRole) override;
 
   /* Get unformatted data from the model */
   QVariant getRawData(int row, int col) const;
   QVariant getRawData(int row, const QString& colname) const;
 
-  /* Sets the SQL query into the model. This will start the query and fetch data from the database. */
+  /* Sets the SQL query into the model. This will start the query in the background and
+   * fetch the first rows from the database. */
   void resetSqlQuery();
 
-  /* Set a filter for objects within the given bounding rectangle */
-  void filterByBoundingRect(const atools::geo::Rect& boundingRectangle);
+  /* Check if the database has a text index for the table and rebuild the query strings.
+   * Call after a new database was loaded. Does not restart the query. */
+  void updateTextIndex();
+
+  /* Set a filter for objects within the given bounding rectangle. If center is valid the query also
+   * drops objects that are certainly farther away than maxDistanceMeter and returns the
+   * nearest objects first. */
+  void filterByBoundingRect(const atools::geo::Rect& boundingRectangle,
+                            const atools::geo::Pos& center = atools::geo::Pos(), float maxDistanceMeter = 0.f);
 
   QString getColumnName(int col) const;
 
@@ -154,14 +190,37 @@ public:
    */
   void setDataCallback(const DataFunctionType& func, const QSet<Qt::ItemDataRole>& roles);
 
+  /* Formats a raw column value for display */
+  typedef std::function<QString(const QVariant& value)> FormatFunctionType;
+
+  /* Returns the formatter for the given column or null if values are displayed as is */
+  typedef std::function<FormatFunctionType(const Column *col)> ColumnFormatFunctionType;
+
+  /* Sets a callback that resolves the display formatting once per column. Used for exports. */
+  void setColumnFormatCallback(const ColumnFormatFunctionType& func)
+  {
+    columnFormatFunction = func;
+  }
+
+  const ColumnFormatFunctionType& getColumnFormatCallback() const
+  {
+    return columnFormatFunction;
+  }
+
 signals:
-  /* Emitted when more data was fetched */
+  /* Emitted when more data was fetched or when the total row count is available */
   void fetchedMore();
 
-private:
-  // Hide the record method
-  using QSqlQueryModel::record;
+  /* Emitted after fetchAll() once the last row has arrived */
+  void allRowsFetched();
 
+  /* Queued calls into the worker thread */
+  void startQueryInWorker(int queryId, const QString& driverName, const QString& databaseName,
+                          const QString& countQuery, const QString& query);
+  void fetchRowsInWorker(int queryId, bool all);
+  void closeDatabaseInWorker();
+
+private:
   struct WhereCondition
   {
     QString oper; /* operator (like, not like) */
@@ -171,14 +230,32 @@ private:
 
   virtual void sort(int column, Qt::SortOrder order) override;
 
+  /* Results from worker */
+  void rowsAvailable(int queryId, const SqlModelRows& newRows, bool more);
+  void totalRowCountAvailable(int queryId, int count);
+  void queryFailed(int queryId, const QString& driverText, const QString& databaseText);
+
+  /* Stop worker from reading rows of the current query */
+  void cancelQuery();
+
+  /* Build field information for all columns of the query */
+  void buildRecord();
+
   void filterBy(bool exclude, QString whereCol, QVariant whereValue);
   QString buildColumnList();
   QString buildWhere();
   QString buildWhereValue(const WhereCondition& cond);
+  QString buildWhereTextIndex(const WhereCondition& cond);
+  QString buildDistanceExpression() const;
   void buildQuery();
+  void buildQueryStrings();
   void clearWhereConditions();
   void filterBy(QModelIndex index, bool exclude);
   QString  sortOrderToSql(Qt::SortOrder order);
+  /* Get the formatted display value or an invalid variant if not cached yet */
+  const QVariant& cachedDisplayValue(int row, int col) const;
+  void cacheDisplayValue(int row, int col, const QVariant& value) const;
+
   QVariant defaultDataHandler(int colIndex, int rowIndex, const Column *col, const QVariant& roleValue,
                               const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
 
@@ -188,21 +265,52 @@ private:
   QString orderByCol /* Order by column name */, orderByOrder /* "asc" or "desc" */;
   int orderByColIndex = 0;
 
-  QString currentSqlQuery;
+  QString currentSqlQuery, currentCountQuery;
+
+  /* Field names of the query columns */
+  QSqlRecord queryRecord;
+
+  /* Rows loaded from worker */
+  SqlModelRows rows;
+
+  /* Display role values as returned by the data callback. Same size as rows. A row is allocated and
+   * cells are filled on first access. Cleared with the rows or if the callback changes. */
+  mutable QVector<QVector<QVariant> > displayCache;
+
+  /* Header captions for columns */
+  QVector<QVariant> headers;
+
+  /* Id of the query currently shown in the model. Also read by worker. */
+  QAtomicInt latestQueryId;
+  int currentQueryId = 0;
+  bool moreRowsAvailable = false, fetching = false, fetchingAll = false;
+
+  QThread workerThread;
+  SqlModelWorker *worker = nullptr;
 
   /* Data callback */
   DataFunctionType dataFunction = nullptr;
   /* Roles for the data callback */
   QSet<Qt::ItemDataRole> handlerRoles;
 
+  /* Column formatter callback for exports */
+  ColumnFormatFunctionType columnFormatFunction = nullptr;
+
   /* A bounding rectangle query is used if this is valid */
   atools::geo::Rect boundingRect;
 
+  /* Center and radius for the distance query */
+  atools::geo::Pos distanceCenter;
+  float distanceMaxMeter = 0.f;
+
   /* Maps column name to where condition struct */
   QHash<QString, WhereCondition> whereConditionMap;
 
   atools::sql::SqlDatabase *db;
 
+  /* Name of the full text index table for the queried table or empty if not available */
+  QString textIndexTable;
+
   /* List of column descriptors */
   const ColumnList *columns;
 
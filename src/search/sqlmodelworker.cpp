@@ -0,0 +1,148 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "search/sqlmodelworker.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlRecord>
+
+SqlModelWorker::SqlModelWorker(const QAtomicInt *latestQueryIdParam)
+  : latestQueryId(latestQueryIdParam)
+{
+  connectionName = QString("SqlModelWorker-%1").arg(reinterpret_cast<quintptr>(this));
+}
+
+SqlModelWorker::~SqlModelWorker()
+{
+  closeDatabase();
+}
+
+void SqlModelWorker::closeDatabase()
+{
+  delete query;
+  query = nullptr;
+  currentQueryId = -1;
+
+  if(database.isValid())
+  {
+    database.close();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+  }
+}
+
+bool SqlModelWorker::isSuperseded(int queryId) const
+{
+  return queryId != latestQueryId->loadAcquire();
+}
+
+void SqlModelWorker::startQuery(int queryId, const QString& driverName, const QString& databaseName,
+                                const QString& countQuery, const QString& queryStr)
+{
+  if(isSuperseded(queryId))
+    return;
+
+  delete query;
+  query = nullptr;
+  currentQueryId = -1;
+
+  if(!database.isValid() || !database.isOpen() || database.databaseName() != databaseName)
+  {
+    closeDatabase();
+
+    // Connection has to be created in this thread
+    database = QSqlDatabase::addDatabase(driverName, connectionName);
+    database.setDatabaseName(databaseName);
+    database.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if(!database.open())
+    {
+      emit queryFailed(queryId, database.lastError().driverText(), database.lastError().databaseText());
+      closeDatabase();
+      return;
+    }
+  }
+
+  query = new QSqlQuery(database);
+  query->setForwardOnly(true);
+  if(!query->exec(queryStr))
+  {
+    emit queryFailed(queryId, query->lastError().driverText(), query->lastError().databaseText());
+    delete query;
+    query = nullptr;
+    return;
+  }
+  currentQueryId = queryId;
+
+  // Send the first rows before counting so the table fills quickly
+  fetchRows(queryId, false);
+
+  if(isSuperseded(queryId))
+    return;
+
+  QSqlQuery countStmt(database);
+  if(countStmt.exec(countQuery) && countStmt.next())
+    emit totalRowCountAvailable(queryId, countStmt.value(0).toInt());
+  else
+    emit queryFailed(queryId, countStmt.lastError().driverText(), countStmt.lastError().databaseText());
+}
+
+void SqlModelWorker::fetchRows(int queryId, bool all)
+{
+  if(query == nullptr || queryId != currentQueryId)
+    // No query or another query is running already
+    return;
+
+  int batchSize = all ? FETCH_ALL_BATCH_SIZE : FETCH_BATCH_SIZE;
+  bool more = true;
+  do
+  {
+    SqlModelRows rows;
+    if(!readRows(queryId, batchSize, rows))
+      // Stop reading - model is not interested anymore
+      return;
+
+    // A batch that is not full means the end of the result is reached
+    more = rows.size() == batchSize;
+    emit rowsAvailable(queryId, rows, more);
+  } while(all && more);
+
+  if(!more)
+  {
+    delete query;
+    query = nullptr;
+  }
+}
+
+bool SqlModelWorker::readRows(int queryId, int number, SqlModelRows& rows)
+{
+  rows.reserve(number);
+  while(rows.size() < number && query->next())
+  {
+    if(isSuperseded(queryId))
+      return false;
+
+    QSqlRecord rec = query->record();
+    QVariantList values;
+    values.reserve(rec.count());
+    for(int i = 0; i < rec.count(); i++)
+      values.append(rec.value(i));
+    rows.append(values);
+  }
+  return !isSuperseded(queryId);
+}
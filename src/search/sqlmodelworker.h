@@ -0,0 +1,91 @@
+/*****************************************************************************
+* Copyright 2015-2016 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_SQLMODELWORKER_H
+#define LITTLENAVMAP_SQLMODELWORKER_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVariantList>
+#include <QVector>
+
+/* Rows with values in the order of the query columns */
+typedef QVector<QVariantList> SqlModelRows;
+
+/*
+ * Runs the queries of the SqlModel in a background thread using its own database connection.
+ * All slots have to be called by queued connections. Rows are sent back in batches.
+ *
+ * Every query has an id. A query is abandoned as soon as the model starts a newer one which is
+ * detected by comparing the id with the shared latest query id.
+ */
+class SqlModelWorker :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /*
+   * @param latestQueryIdParam id of the latest query started by the model. Owned by the model.
+   */
+  SqlModelWorker(const QAtomicInt *latestQueryIdParam);
+  virtual ~SqlModelWorker();
+
+  /* Start the query and send the first batch of rows and the total row count afterwards.
+   * Opens the database if it is not open yet or if the database name has changed. */
+  void startQuery(int queryId, const QString& driverName, const QString& databaseName,
+                  const QString& countQuery, const QString& query);
+
+  /* Send the next batch of rows or all remaining rows in several batches */
+  void fetchRows(int queryId, bool all);
+
+  /* Close query and database connection. Needed before the database file is replaced. */
+  void closeDatabase();
+
+signals:
+  /* Sent for each batch. more is false if all rows were read. */
+  void rowsAvailable(int queryId, const SqlModelRows& rows, bool more);
+
+  /* Result of the count query */
+  void totalRowCountAvailable(int queryId, int totalRowCount);
+
+  /* Database could not be opened or query failed */
+  void queryFailed(int queryId, const QString& driverText, const QString& databaseText);
+
+private:
+  /* Read up to number rows. Returns false if query was superseded. */
+  bool readRows(int queryId, int number, SqlModelRows& rows);
+  bool isSuperseded(int queryId) const;
+
+  /* Rows for a normal fetch similar to QSqlQueryModel */
+  static Q_DECL_CONSTEXPR int FETCH_BATCH_SIZE = 256;
+
+  /* Rows per batch when reading all rows */
+  static Q_DECL_CONSTEXPR int FETCH_ALL_BATCH_SIZE = 2000;
+
+  const QAtomicInt *latestQueryId;
+
+  QString connectionName;
+  QSqlDatabase database;
+  QSqlQuery *query = nullptr;
+  int currentQueryId = -1;
+};
+
+#endif // LITTLENAVMAP_SQLMODELWORKER_H
@@ -20,13 +20,49 @@
 #include "geo/calculations.h"
 #include "search/sqlmodel.h"
 
-#include <QApplication>
-
 using namespace atools::geo;
 
+namespace sqlproxymodel {
+
+void DistanceFilter::calculate(const Pos& pos, float& distanceMeter, float& headingDeg) const
+{
+  distanceMeter = pos.distanceMeterTo(center);
+  headingDeg = normalizeCourse(center.angleDegTo(pos));
+}
+
+bool DistanceFilter::accepts(float distanceMeter, float headingDeg) const
+{
+  if(distanceMeter < minDistanceMeter || distanceMeter > maxDistanceMeter)
+    return false;
+
+  switch(direction)
+  {
+    case ALL:
+      // All directions
+      return true;
+
+    case NORTH:
+      return MIN_NORTH_DEG <= headingDeg || headingDeg <= MAX_NORTH_DEG;
+
+    case EAST:
+      return MIN_EAST_DEG <= headingDeg && headingDeg <= MAX_EAST_DEG;
+
+    case SOUTH:
+      return MIN_SOUTH_DEG <= headingDeg && headingDeg <= MAX_SOUTH_DEG;
+
+    case WEST:
+      return MIN_WEST_DEG <= headingDeg && headingDeg <= MAX_WEST_DEG;
+  }
+  return true;
+}
+
+}
+
 SqlProxyModel::SqlProxyModel(QObject *parent, SqlModel *sqlModel)
   : QSortFilterProxyModel(parent), sourceSqlModel(sqlModel)
 {
+  // Rows will be replaced - cache is invalid
+  connect(sourceSqlModel, &SqlModel::modelAboutToBeReset, this, &SqlProxyModel::clearCache);
 }
 
 SqlProxyModel::~SqlProxyModel()
@@ -37,62 +73,46 @@ SqlProxyModel::~SqlProxyModel()
 void SqlProxyModel::setDistanceFilter(const Pos& center, sqlproxymodel::SearchDirection dir,
                                       int minDistance, int maxDistance)
 {
-  minDistMeter = nmToMeter(minDistance);
-  maxDistMeter = nmToMeter(maxDistance);
-  centerPos = center;
-  direction = dir;
+  filter.minDistanceMeter = nmToMeter(minDistance);
+  filter.maxDistanceMeter = nmToMeter(maxDistance);
+
+  if(center != filter.center)
+    clearCache();
+  filter.center = center;
+  filter.direction = dir;
 }
 
 void SqlProxyModel::clearDistanceFilter()
 {
-  centerPos = Pos();
+  filter.center = Pos();
+  clearCache();
 }
 
-/* Does the filtering by minmum and maximum distance and direction */
-bool SqlProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+void SqlProxyModel::clearCache()
 {
-  Q_UNUSED(sourceParent);
+  cache.clear();
+}
 
-  Pos pos = buildPos(sourceRow);
-  float heading = normalizeCourse(centerPos.angleDegTo(pos));
+SqlProxyModel::DistanceHeading SqlProxyModel::distanceHeading(int sourceRow) const
+{
+  if(sourceRow >= cache.size())
+    cache.resize(std::max(sourceSqlModel->rowCount(), sourceRow + 1));
 
-  switch(direction)
+  DistanceHeading& value = cache[sourceRow];
+  if(value.distanceMeter < 0.f)
   {
-    case sqlproxymodel::ALL:
-      // All directions
-      return matchDistance(pos);
-
-    case sqlproxymodel::NORTH:
-      if(MIN_NORTH_DEG <= heading || heading <= MAX_NORTH_DEG)
-        return matchDistance(pos);
-      else
-        return false;
-
-    case sqlproxymodel::EAST:
-      if(MIN_EAST_DEG <= heading && heading <= MAX_EAST_DEG)
-        return matchDistance(pos);
-      else
-        return false;
-
-    case sqlproxymodel::SOUTH:
-      if(MIN_SOUTH_DEG <= heading && heading <= MAX_SOUTH_DEG)
-        return matchDistance(pos);
-      else
-        return false;
-
-    case sqlproxymodel::WEST:
-      if(MIN_WEST_DEG <= heading && heading <= MAX_WEST_DEG)
-        return matchDistance(pos);
-      else
-        return false;
+    filter.calculate(buildPos(sourceRow), value.distanceMeter, value.headingDeg);
   }
-  return true;
+  return value;
 }
 
-bool SqlProxyModel::matchDistance(const Pos& pos) const
+/* Does the filtering by minmum and maximum distance and direction */
+bool SqlProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
 {
-  float distMeter = pos.distanceMeterTo(centerPos);
-  return distMeter >= minDistMeter && distMeter <= maxDistMeter;
+  Q_UNUSED(sourceParent);
+
+  DistanceHeading dh = distanceHeading(sourceRow);
+  return filter.accepts(dh.distanceMeter, dh.headingDeg);
 }
 
 void SqlProxyModel::sort(int column, Qt::SortOrder order)
@@ -102,11 +122,8 @@ void SqlProxyModel::sort(int column, Qt::SortOrder order)
   // Update query in underlying SQL model
   sourceSqlModel->setSort(sourceSqlModel->getColumnName(column), order);
 
-  // Fetch all data and set wait cursor
-  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-  while(canFetchMore(QModelIndex()))
-    fetchMore(QModelIndex());
-  QGuiApplication::restoreOverrideCursor();
+  // Fetch all data in the background - proxy sorts rows while they arrive
+  sourceSqlModel->fetchAll();
 }
 
 QVariant SqlProxyModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -123,16 +140,12 @@ bool SqlProxyModel::lessThan(const QModelIndex& sourceLeft, const QModelIndex& s
   if(leftCol == "distance" && rightCol == "distance")
   {
     // Sort by distance
-    float distLeft = buildPos(sourceLeft.row()).distanceMeterTo(centerPos);
-    float distRight = buildPos(sourceRight.row()).distanceMeterTo(centerPos);
-    return distLeft < distRight;
+    return distanceHeading(sourceLeft.row()).distanceMeter < distanceHeading(sourceRight.row()).distanceMeter;
   }
   else if(leftCol == "heading" && rightCol == "heading")
   {
     // Sort by heading
-    float headingLeft = normalizeCourse(centerPos.angleDegTo(buildPos(sourceLeft.row())));
-    float headingRight = normalizeCourse(centerPos.angleDegTo(buildPos(sourceRight.row())));
-    return headingLeft < headingRight;
+    return distanceHeading(sourceLeft.row()).headingDeg < distanceHeading(sourceRight.row()).headingDeg;
   }
   else
     // Let the model do the sorting for other columns
@@ -146,7 +159,7 @@ QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
   {
     if(role == Qt::DisplayRole)
     {
-      float dist = meterToNm(buildPos(mapToSource(index).row()).distanceMeterTo(centerPos));
+      float dist = meterToNm(distanceHeading(mapToSource(index).row()).distanceMeter);
       return QLocale().toString(dist, 'f', 1);
     }
     else if(role == Qt::TextAlignmentRole)
@@ -156,7 +169,7 @@ QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
   {
     if(role == Qt::DisplayRole)
     {
-      float heading = normalizeCourse(centerPos.angleDegTo(buildPos(mapToSource(index).row())));
+      float heading = distanceHeading(mapToSource(index).row()).headingDeg;
       return QLocale().toString(heading, 'f', 0);
     }
     else if(role == Qt::TextAlignmentRole)
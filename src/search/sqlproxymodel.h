@@ -21,6 +21,7 @@
 #include "geo/pos.h"
 
 #include <QSortFilterProxyModel>
+#include <QVector>
 
 class SqlModel;
 
@@ -38,6 +39,35 @@ enum SearchDirection
   WEST = 4
 };
 
+/* Parameters of the second stage distance filter. Also used to filter exports of distance searches. */
+struct DistanceFilter
+{
+  atools::geo::Pos center; /* Filter is not active if invalid */
+  SearchDirection direction = ALL;
+  int minDistanceMeter = 0, maxDistanceMeter = 0;
+
+  bool isValid() const
+  {
+    return center.isValid();
+  }
+
+  /* Get distance in meter and heading in degree true from center to pos */
+  void calculate(const atools::geo::Pos& pos, float& distanceMeter, float& headingDeg) const;
+
+  /* true if distance and heading are within the filter ranges */
+  bool accepts(float distanceMeter, float headingDeg) const;
+
+private:
+  /* Direction filter ranges are decreased by this value on each side */
+  static float Q_DECL_CONSTEXPR DIR_RANGE_DEG = 22.5f;
+
+  /* Direction filter parameters */
+  static float Q_DECL_CONSTEXPR MIN_NORTH_DEG = 270.f + DIR_RANGE_DEG, MAX_NORTH_DEG = 90.f - DIR_RANGE_DEG;
+  static float Q_DECL_CONSTEXPR MIN_EAST_DEG = 0.f + DIR_RANGE_DEG, MAX_EAST_DEG = 180.f - DIR_RANGE_DEG;
+  static float Q_DECL_CONSTEXPR MIN_SOUTH_DEG = 90.f + DIR_RANGE_DEG, MAX_SOUTH_DEG = 270.f - DIR_RANGE_DEG;
+  static float Q_DECL_CONSTEXPR MIN_WEST_DEG = 180.f + DIR_RANGE_DEG, MAX_WEST_DEG = 360.f - DIR_RANGE_DEG;
+};
+
 }
 
 /*
@@ -46,6 +76,7 @@ enum SearchDirection
  * and direction.
  * Dynamic loading on demand (like the SQL model does) does not work with this model. Therefore all results
  * have to be fetched.
+ * Distance and heading to the center are calculated once per row and cached for filtering, sorting and display.
  */
 class SqlProxyModel :
   public QSortFilterProxyModel
@@ -69,6 +100,11 @@ public:
   /* Clear distance search and stop all filtering */
   void clearDistanceFilter();
 
+  const sqlproxymodel::DistanceFilter& getDistanceFilter() const
+  {
+    return filter;
+  }
+
   /* Sorts the model by column in the given order and fetches all data from the underlying model. */
   virtual void sort(int column, Qt::SortOrder order) override;
 
@@ -78,22 +114,24 @@ private:
   virtual bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
   virtual bool lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const override;
 
-  bool matchDistance(const atools::geo::Pos& pos) const;
+  /* Distance and heading from center for a source row */
+  struct DistanceHeading
+  {
+    float distanceMeter = -1.f; /* Not calculated yet if negative */
+    float headingDeg = 0.f;
+  };
+
   atools::geo::Pos buildPos(int row) const;
 
-  /* Direction filter ranges are decreased by this value on each side */
-  static float Q_DECL_CONSTEXPR DIR_RANGE_DEG = 22.5f;
-
-  /* Direction filter parameters */
-  static float Q_DECL_CONSTEXPR MIN_NORTH_DEG = 270.f + DIR_RANGE_DEG, MAX_NORTH_DEG = 90.f - DIR_RANGE_DEG;
-  static float Q_DECL_CONSTEXPR MIN_EAST_DEG = 0.f + DIR_RANGE_DEG, MAX_EAST_DEG = 180.f - DIR_RANGE_DEG;
-  static float Q_DECL_CONSTEXPR MIN_SOUTH_DEG = 90.f + DIR_RANGE_DEG, MAX_SOUTH_DEG = 270.f - DIR_RANGE_DEG;
-  static float Q_DECL_CONSTEXPR MIN_WEST_DEG = 180.f + DIR_RANGE_DEG, MAX_WEST_DEG = 360.f - DIR_RANGE_DEG;
+  /* Get cached values or calculate them. Returns a copy since the cache can grow with later calls. */
+  DistanceHeading distanceHeading(int sourceRow) const;
+  void clearCache();
 
   SqlModel *sourceSqlModel = nullptr;
-  atools::geo::Pos centerPos;
-  sqlproxymodel::SearchDirection direction;
-  int minDistMeter = 0, maxDistMeter = 0;
+  sqlproxymodel::DistanceFilter filter;
+
+  /* Indexed by source row. Source model only appends rows or is reset. */
+  mutable QVector<DistanceHeading> cache;
 
 };
 